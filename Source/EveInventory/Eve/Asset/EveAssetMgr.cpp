@@ -0,0 +1,258 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#include "EveAssetMgr.h"
+
+#include "AssetRegistry/AssetData.h"
+#include "Blueprint/UserWidget.h"
+#include "EveInventory/EveInventory.h"
+#include "EveInventory/Eve/Data/EveItemDefinition.h"
+
+/**
+ * @brief 初始资产扫描完成后建立物品定义索引
+ */
+void UEveAssetMgr::PostInitialAssetScan()
+{
+	Super::PostInitialAssetScan();
+
+	TIDToItemDefinition.Reset();
+
+	TArray<FAssetData> AssetDataList;
+	GetPrimaryAssetDataList(UEveItemDefinition::ItemDefinitionType, AssetDataList);
+	for (const FAssetData& AssetData : AssetDataList)
+	{
+		int32 TID = -1;
+		if (!AssetData.GetTagValue(GET_MEMBER_NAME_CHECKED(UEveItemDefinition, TID), TID) || TID < 0)
+		{
+			UE_LOG(LogEveInventory, Warning, TEXT("Item definition %s has no TID"), *AssetData.AssetName.ToString());
+			continue;
+		}
+
+		TIDToItemDefinition.Add(TID, GetPrimaryAssetIdForData(AssetData));
+	}
+
+	UE_LOG(LogEveInventory, Log, TEXT("Indexed %d item definition(s)"), TIDToItemDefinition.Num());
+}
+
+FPrimaryAssetId UEveAssetMgr::FindItemDefinitionId(const int32 TID) const
+{
+	const FPrimaryAssetId* AssetId = TIDToItemDefinition.Find(TID);
+	return AssetId ? *AssetId : FPrimaryAssetId();
+}
+
+UEveItemDefinition* UEveAssetMgr::GetItemDefinition(const int32 TID) const
+{
+	const FPrimaryAssetId AssetId = FindItemDefinitionId(TID);
+	return AssetId.IsValid() ? GetPrimaryAssetObject<UEveItemDefinition>(AssetId) : nullptr;
+}
+
+/**
+ * @brief 异步加载一组物品定义及其指定资源包
+ * 
+ * `ChangeBundleStateForPrimaryAssets` 只作用于已加载的主资产，因此未加载的物品定义
+ * 需要先 `LoadPrimaryAssets`；两部分都完成后回调一次，并记录本次加载的耗时。
+ */
+void UEveAssetMgr::LoadItemBundles(const TArray<int32>& TIDs, const FName Bundle, FStreamableDelegate OnLoaded)
+{
+	TArray<FPrimaryAssetId> AssetIds;
+	GetItemDefinitionIds(TIDs, AssetIds);
+	if (AssetIds.Num() == 0)
+	{
+		OnLoaded.ExecuteIfBound();
+		return;
+	}
+
+	// 已有加载句柄（已加载或正在加载）的物品定义只添加资源包，
+	// 保留其他已加载的资源包（例如打开背包时不卸载场景中掉落物的模型）
+	TArray<FPrimaryAssetId> NewIds;
+	TArray<FPrimaryAssetId> ManagedIds;
+	for (const FPrimaryAssetId& AssetId : AssetIds)
+	{
+		(GetPrimaryAssetHandle(AssetId).IsValid() ? ManagedIds : NewIds).Add(AssetId);
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 AssetNum = AssetIds.Num();
+	const TSharedRef<int32> PendingNum = MakeShared<int32>((NewIds.Num() > 0) + (ManagedIds.Num() > 0));
+	auto MakePartDelegate = [OnLoaded, Bundle, AssetNum, StartTime, PendingNum]()
+	{
+		const TSharedRef<bool> bCompleted = MakeShared<bool>(false);
+		return FStreamableDelegate::CreateLambda([OnLoaded, Bundle, AssetNum, StartTime, PendingNum, bCompleted]()
+		{
+			// 资源已全部加载时引擎也可能调用回调，保证每部分只计一次
+			if (*bCompleted) return;
+			*bCompleted = true;
+			if (--(*PendingNum) > 0) return;
+
+			UE_LOG(LogEveInventory, Log, TEXT("Loaded %s bundle for %d item(s) in %.2f ms"),
+				*Bundle.ToString(), AssetNum, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+			OnLoaded.ExecuteIfBound();
+		});
+	};
+
+	auto Request = [](const TSharedPtr<FStreamableHandle>& Handle, const FStreamableDelegate& OnPartLoaded)
+	{
+		// 没有需要加载的资源，或请求时已完成
+		if (!Handle.IsValid() || Handle->HasLoadCompleted())
+		{
+			OnPartLoaded.ExecuteIfBound();
+		}
+	};
+
+	if (NewIds.Num() > 0)
+	{
+		const FStreamableDelegate OnPartLoaded = MakePartDelegate();
+		Request(LoadPrimaryAssets(NewIds, { Bundle }, OnPartLoaded), OnPartLoaded);
+	}
+	if (ManagedIds.Num() > 0)
+	{
+		const FStreamableDelegate OnPartLoaded = MakePartDelegate();
+		Request(ChangeBundleStateForPrimaryAssets(ManagedIds, { Bundle }, {}, false, OnPartLoaded), OnPartLoaded);
+	}
+}
+
+void UEveAssetMgr::ReleaseItemBundles(const TArray<int32>& TIDs, const FName Bundle)
+{
+	TArray<FPrimaryAssetId> AssetIds;
+	GetItemDefinitionIds(TIDs, AssetIds);
+
+	// 只处理有加载句柄的物品定义
+	AssetIds.RemoveAll([this](const FPrimaryAssetId& AssetId) { return !GetPrimaryAssetHandle(AssetId).IsValid(); });
+	if (AssetIds.Num() == 0) return;
+
+	ChangeBundleStateForPrimaryAssets(AssetIds, {}, { Bundle });
+}
+
+/**
+ * @brief 输出物品资源的驻留内存
+ * 
+ * 资源大小取 `GetResourceSizeBytes(EstimatedTotal)`，同一资源只计一次。
+ */
+void UEveAssetMgr::ReportItemAssetMemory(FOutputDevice& Ar, const TArray<FSoftObjectPath>& ExtraPaths, const bool bLoadAll)
+{
+	// 收集物品定义中的资源路径；对照时同步加载尚未加载的物品定义
+	int32 LoadedDefinitionNum = 0;
+	auto CollectPaths = [this, &ExtraPaths, &LoadedDefinitionNum](const bool bLoadDefinitions)
+	{
+		TArray<FSoftObjectPath> Paths(ExtraPaths);
+		LoadedDefinitionNum = 0;
+		for (const TPair<int32, FPrimaryAssetId>& Pair : TIDToItemDefinition)
+		{
+			const UEveItemDefinition* ItemDefinition = GetPrimaryAssetObject<UEveItemDefinition>(Pair.Value);
+			if (ItemDefinition)
+			{
+				LoadedDefinitionNum++;
+			}
+			else if (bLoadDefinitions)
+			{
+				ItemDefinition = Cast<UEveItemDefinition>(GetPrimaryAssetPath(Pair.Value).TryLoad());
+			}
+			if (!ItemDefinition) continue;
+
+			Paths.Add(ItemDefinition->Icon.ToSoftObjectPath());
+			Paths.Add(ItemDefinition->WorldMesh.ToSoftObjectPath());
+			Paths.Add(ItemDefinition->WorldFX.ToSoftObjectPath());
+		}
+		return Paths;
+	};
+
+	auto Measure = [](const TArray<FSoftObjectPath>& AssetPaths, const bool bLoad, int32& OutNum) -> SIZE_T
+	{
+		TSet<const UObject*> Counted;
+		SIZE_T Size = 0;
+		for (const FSoftObjectPath& Path : AssetPaths)
+		{
+			if (Path.IsNull()) continue;
+
+			const UObject* Asset = bLoad ? Path.TryLoad() : Path.ResolveObject();
+			bool bAlreadyCounted = false;
+			if (!Asset) continue;
+			Counted.Add(Asset, &bAlreadyCounted);
+			if (bAlreadyCounted) continue;
+
+			Size += const_cast<UObject*>(Asset)->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+		}
+		OutNum = Counted.Num();
+		return Size;
+	};
+
+	int32 ResidentNum = 0;
+	const SIZE_T ResidentSize = Measure(CollectPaths(false), false, ResidentNum);
+	Ar.Logf(TEXT("Item definitions: %d indexed, %d loaded"), TIDToItemDefinition.Num(), LoadedDefinitionNum);
+	Ar.Logf(TEXT("Item assets resident: %d, %.1f KB"), ResidentNum, ResidentSize / 1024.0);
+
+	if (!bLoadAll) return;
+
+	// 对照：整表加载时所有图标与场景资源都随数据表常驻
+	const double StartTime = FPlatformTime::Seconds();
+	int32 AllNum = 0;
+	const SIZE_T AllSize = Measure(CollectPaths(true), true, AllNum);
+	Ar.Logf(TEXT("Item assets all loaded: %d, %.1f KB, synchronous load took %.2f ms"),
+		AllNum, AllSize / 1024.0, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	Ar.Logf(TEXT("Saved by bundles: %.1f KB (%.1f%%)"),
+		(static_cast<double>(AllSize) - ResidentSize) / 1024.0, AllSize > 0 ? 100.0 * (1.0 - static_cast<double>(ResidentSize) / AllSize) : 0.0);
+}
+
+/**
+ * @brief 异步加载背包界面的控件类
+ * 
+ * 完成时记录本次加载的耗时，便于与首次打开背包时同步加载对比。
+ */
+TSharedPtr<FStreamableHandle> UEveAssetMgr::LoadWidgetClassesAsync(FStreamableDelegate OnLoaded)
+{
+	TArray<FSoftObjectPath> ClassPaths;
+	for (const TSoftClassPtr<UUserWidget>* SoftClass : { &SoftInventoryClass, &SoftItemClass })
+	{
+		if (!SoftClass->IsNull() && !SoftClass->Get())
+		{
+			ClassPaths.Add(SoftClass->ToSoftObjectPath());
+		}
+	}
+	if (ClassPaths.Num() == 0)
+	{
+		OnLoaded.ExecuteIfBound();
+		return nullptr;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 ClassNum = ClassPaths.Num();
+	const TSharedRef<bool> bCompleted = MakeShared<bool>(false);
+	FStreamableDelegate OnClassesLoaded = FStreamableDelegate::CreateLambda([OnLoaded, ClassNum, StartTime, bCompleted]()
+	{
+		// 与 `LoadItemBundles` 相同，保证只回调一次
+		if (*bCompleted) return;
+		*bCompleted = true;
+
+		UE_LOG(LogEveInventory, Log, TEXT("Loaded %d widget class(es) in %.2f ms"),
+			ClassNum, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+		OnLoaded.ExecuteIfBound();
+	});
+
+	TSharedPtr<FStreamableHandle> Handle = GetStreamableManager().RequestAsyncLoad(ClassPaths, OnClassesLoaded);
+	if (!Handle.IsValid())
+	{
+		OnClassesLoaded.ExecuteIfBound();
+	}
+	return Handle;
+}
+
+TSubclassOf<UUserWidget> UEveAssetMgr::GetInventoryWidgetClass() const
+{
+	return SoftInventoryClass.IsNull() ? InventoryClass : TSubclassOf<UUserWidget>(SoftInventoryClass.LoadSynchronous());
+}
+
+TSubclassOf<UUserWidget> UEveAssetMgr::GetItemWidgetClass() const
+{
+	return SoftItemClass.IsNull() ? ItemClass : TSubclassOf<UUserWidget>(SoftItemClass.LoadSynchronous());
+}
+
+void UEveAssetMgr::GetItemDefinitionIds(const TArray<int32>& TIDs, TArray<FPrimaryAssetId>& OutAssetIds) const
+{
+	OutAssetIds.Reserve(OutAssetIds.Num() + TIDs.Num());
+	for (const int32 TID : TIDs)
+	{
+		if (const FPrimaryAssetId* AssetId = TIDToItemDefinition.Find(TID))
+		{
+			OutAssetIds.AddUnique(*AssetId);
+		}
+	}
+}
@@ -5,8 +5,13 @@
 #include "CoreMinimal.h"
 #include "Engine/AssetManager.h"
 #include "Engine/DataTable.h"
+#include "Engine/StreamableManager.h"
 #include "EveAssetMgr.generated.h"
 
+class UEveItemDefinition;
+class UStaticMesh;
+class UStringTable;
+
 /**
  * @brief 资产管理器类，负责游戏中的资产加载与管理。
  * 继承自 UAssetManager，用于集中管理资源，例如数据表、UI 组件等。
@@ -57,6 +62,96 @@ public:
 		return Asset;
 	}
 
+public:
+	/** 物品定义的 UI 资源包（图标） */
+	static inline const FName UIBundle = FName(TEXT("UI"));
+
+	/** 物品定义的场景资源包（掉落模型、特效） */
+	static inline const FName WorldBundle = FName(TEXT("World"));
+
+	/**
+	 * @brief 初始资产扫描完成后，按资产注册表中的 `TID` 建立物品定义索引
+	 * 
+	 * 只读取注册表标签，不加载任何物品定义资产。
+	 */
+	virtual void PostInitialAssetScan() override;
+
+	/**
+	 * @brief 查找 TID 对应的物品定义
+	 * 
+	 * @param TID 物品唯一 ID
+	 * @return 物品定义的主资产 ID，不存在时返回无效 ID
+	 */
+	FPrimaryAssetId FindItemDefinitionId(int32 TID) const;
+
+	/**
+	 * @brief 获取已加载的物品定义
+	 * 
+	 * @param TID 物品唯一 ID
+	 * @return 物品定义，未加载或不存在时返回 nullptr
+	 */
+	UEveItemDefinition* GetItemDefinition(int32 TID) const;
+
+	/**
+	 * @brief 异步加载一组物品定义及其指定资源包
+	 * 
+	 * 尚未加载的物品定义通过 `LoadPrimaryAssets` 连同资源包一起加载；
+	 * 已加载（或正在加载）的物品定义只添加资源包，不移除其他资源包。没有物品定义的 TID 会被忽略。
+	 * 
+	 * @param TIDs 物品唯一 ID
+	 * @param Bundle 资源包（`UIBundle` 或 `WorldBundle`）
+	 * @param OnLoaded 加载完成回调（全部已加载或没有物品定义时也会调用，只调用一次）
+	 */
+	void LoadItemBundles(const TArray<int32>& TIDs, FName Bundle, FStreamableDelegate OnLoaded = FStreamableDelegate());
+
+	/**
+	 * @brief 释放一组物品定义的指定资源包
+	 * 
+	 * 物品定义本身保持加载，资源包中的资源在下次垃圾回收时释放。
+	 * 
+	 * @param TIDs 物品唯一 ID
+	 * @param Bundle 资源包
+	 */
+	void ReleaseItemBundles(const TArray<int32>& TIDs, FName Bundle);
+
+	/**
+	 * @brief 输出物品资源的驻留内存，并可与整表加载（所有资源常驻）对比
+	 * 
+	 * 统计物品定义中已加载的资源包资源与 `ExtraPaths`（如数据表中的图标）中已加载的资源。
+	 * 
+	 * @param Ar 输出设备
+	 * @param ExtraPaths 其他需要统计的物品资源
+	 * @param bLoadAll 是否同步加载全部资源，测量整表加载的耗时与内存
+	 */
+	void ReportItemAssetMemory(FOutputDevice& Ar, const TArray<FSoftObjectPath>& ExtraPaths, bool bLoadAll);
+
+	/** @brief 是否存在任何物品定义 */
+	bool HasItemDefinitions() const { return TIDToItemDefinition.Num() > 0; }
+
+	/**
+	 * @brief 异步加载背包界面的控件类
+	 * 
+	 * 只加载已配置软引用且尚未加载的类（`SoftInventoryClass`、`SoftItemClass`）。
+	 * 
+	 * @param OnLoaded 加载完成回调（全部已加载或未配置软引用时也会调用）
+	 * @return 加载句柄，没有需要加载的类时返回 nullptr
+	 */
+	TSharedPtr<FStreamableHandle> LoadWidgetClassesAsync(FStreamableDelegate OnLoaded = FStreamableDelegate());
+
+	/**
+	 * @brief 获取背包 UI 类
+	 * 
+	 * 优先使用 `SoftInventoryClass`（未加载完成时同步加载），未配置时使用 `InventoryClass`。
+	 */
+	TSubclassOf<UUserWidget> GetInventoryWidgetClass() const;
+
+	/**
+	 * @brief 获取物品 UI 类
+	 * 
+	 * 优先使用 `SoftItemClass`（未加载完成时同步加载），未配置时使用 `ItemClass`。
+	 */
+	TSubclassOf<UUserWidget> GetItemWidgetClass() const;
+
 	/**
 	 * @brief 物品数据表资源
 	 * 
@@ -66,6 +161,14 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = "DT")
 	TSoftObjectPtr<UDataTable> DTItem;
 
+	/**
+	 * @brief 配方数据表资源
+	 * 
+	 * 行结构为 `FEveRecipeData`，由 `UEveCraftingMgr` 在初始化时加载；未配置时不启用制作。
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "DT")
+	TSoftObjectPtr<UDataTable> DTRecipe;
+
 	/**
 	 * @brief 背包 UI 资源
 	 * 
@@ -81,4 +184,53 @@ public:
 	 */
 	UPROPERTY(EditDefaultsOnly, Category = "UI")
 	TSubclassOf<UUserWidget> ItemClass;
+
+	/**
+	 * @brief 物品提示框 UI 资源
+	 * 
+	 * 所有格子共享的提示框蓝图类（需继承 `UEveItemTooltipWidget`），未配置时使用原生默认布局。
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "UI")
+	TSubclassOf<UUserWidget> TooltipClass;
+
+	/**
+	 * @brief 背包 UI 资源（软引用）
+	 * 
+	 * 配置后背包界面在分帧构建时异步加载，并优先于 `InventoryClass` 使用；
+	 * 同时清空 `InventoryClass` 才能避免该蓝图随资产管理器一起被加载。
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "UI")
+	TSoftClassPtr<UUserWidget> SoftInventoryClass;
+
+	/**
+	 * @brief 物品 UI 资源（软引用）
+	 * 
+	 * 配置后优先于 `ItemClass` 使用，加载方式同 `SoftInventoryClass`。
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "UI")
+	TSoftClassPtr<UUserWidget> SoftItemClass;
+
+	/**
+	 * @brief 物品名称字符串表
+	 * 
+	 * 键为物品 TID，用于本地化物品名称；未配置或缺少某个 TID 时使用物品配置中的名称。
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "UI")
+	TSoftObjectPtr<UStringTable> ItemNameStringTable;
+
+	/**
+	 * @brief 掉落物默认模型
+	 * 
+	 * 物品配置未指定 `WorldMesh` 时，场景中的掉落物使用该模型实例化渲染。
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "World")
+	TSoftObjectPtr<UStaticMesh> DroppedItemMesh;
+
+private:
+	/** 将 TID 转换为物品定义主资产 ID */
+	void GetItemDefinitionIds(const TArray<int32>& TIDs, TArray<FPrimaryAssetId>& OutAssetIds) const;
+
+private:
+	/** TID 到物品定义主资产 ID 的映射 */
+	TMap<int32, FPrimaryAssetId> TIDToItemDefinition;
 };
@@ -0,0 +1,558 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#include "EveItemCatalog.h"
+
+#include "EveItemData.h"
+#include "Engine/DataTable.h"
+#include "EveInventory/EveInventory.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+
+namespace EveItemCatalogCSV
+{
+	constexpr uint64 Ones = 0x0101010101010101ull;
+	constexpr uint64 Highs = 0x8080808080808080ull;
+
+	/**
+	 * 在 8 字节中查找等于 `Byte` 的字节，每个匹配字节的最高位被置位。
+	 * 最低的置位一定是真实匹配；更高位在紧邻匹配之后可能误报，查找第一个匹配时不受影响。
+	 */
+	FORCEINLINE uint64 MatchByte(const uint64 Word, const uint8 Byte)
+	{
+		const uint64 X = Word ^ (Ones * Byte);
+		return (X - Ones) & ~X & Highs;
+	}
+
+	FORCEINLINE uint64 LoadWord(const uint8* P)
+	{
+		uint64 Word;
+		FMemory::Memcpy(&Word, P, sizeof(Word));
+		return Word;
+	}
+
+	/** 查找下一个 `,` / `\n` / `"`，找不到时返回 `End` */
+	FORCEINLINE const uint8* FindSpecial(const uint8* P, const uint8* End)
+	{
+#if PLATFORM_LITTLE_ENDIAN
+		while (End - P >= 8)
+		{
+			const uint64 Word = LoadWord(P);
+			if (const uint64 Mask = MatchByte(Word, ',') | MatchByte(Word, '\n') | MatchByte(Word, '"'))
+			{
+				return P + (FMath::CountTrailingZeros64(Mask) >> 3);
+			}
+			P += 8;
+		}
+#endif
+		while (P < End && *P != ',' && *P != '\n' && *P != '"')
+		{
+			++P;
+		}
+		return P;
+	}
+
+	/** 估算行数（用于预分配，极少数误报不影响结果） */
+	int64 CountLines(const uint8* P, const uint8* End)
+	{
+		int64 Count = 0;
+		while (End - P >= 8)
+		{
+			Count += FMath::CountBits(MatchByte(LoadWord(P), '\n'));
+			P += 8;
+		}
+		while (P < End)
+		{
+			Count += (*P++ == '\n');
+		}
+		return Count;
+	}
+
+	FORCEINLINE FUtf8StringView MakeView(const uint8* Start, const uint8* Stop)
+	{
+		return FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Start), UE_PTRDIFF_TO_INT32(Stop - Start));
+	}
+
+	/**
+	 * 解析一条记录，返回下一条记录的起点。
+	 * 字段视图直接指向文件数据；含 `""` 转义的引号字段反转义到 `Unescaped` 中（按列复用）。
+	 */
+	const uint8* ParseRecord(const uint8* P, const uint8* End, TArray<FUtf8StringView>& OutFields, TArray<TArray<UTF8CHAR>>& Unescaped)
+	{
+		OutFields.Reset();
+		while (true)
+		{
+			if (P < End && *P == '"')
+			{
+				// 引号字段：逐字节处理
+				const uint8* Start = ++P;
+				bool bEscaped = false;
+				while (P < End)
+				{
+					if (*P == '"')
+					{
+						if (P + 1 < End && P[1] == '"')
+						{
+							bEscaped = true;
+							P += 2;
+							continue;
+						}
+						break;
+					}
+					++P;
+				}
+				const uint8* Stop = P;
+				if (P < End) ++P; // 结束引号
+
+				if (bEscaped)
+				{
+					const int32 FieldIdx = OutFields.Num();
+					if (Unescaped.Num() <= FieldIdx) Unescaped.SetNum(FieldIdx + 1);
+
+					TArray<UTF8CHAR>& Buffer = Unescaped[FieldIdx];
+					Buffer.Reset();
+					for (const uint8* Q = Start; Q < Stop; ++Q)
+					{
+						Buffer.Add(static_cast<UTF8CHAR>(*Q));
+						if (*Q == '"') ++Q; // `""` -> `"`
+					}
+					OutFields.Add(FUtf8StringView(Buffer.GetData(), Buffer.Num()));
+				}
+				else
+				{
+					OutFields.Add(MakeView(Start, Stop));
+				}
+
+				// 跳过引号后到分隔符之间的内容（通常只有 `\r`）
+				while (P < End && *P != ',' && *P != '\n') ++P;
+			}
+			else
+			{
+				// 普通字段：按 8 字节扫描分隔符，字段中间的引号按普通字符处理
+				const uint8* Start = P;
+				P = FindSpecial(P, End);
+				while (P < End && *P == '"')
+				{
+					P = FindSpecial(P + 1, End);
+				}
+
+				const uint8* Stop = P;
+				if (Stop > Start && Stop[-1] == '\r') --Stop;
+				OutFields.Add(MakeView(Start, Stop));
+			}
+
+			if (P >= End) return End;
+			if (*P == '\n') return P + 1;
+			++P; // `,`
+		}
+	}
+
+	/** 解析十进制整数（不分配内存） */
+	bool ParseInt(FUtf8StringView Str, int32& OutValue)
+	{
+		Str = Str.TrimStartAndEnd();
+		if (Str.IsEmpty()) return false;
+
+		int32 Idx = 0;
+		const bool bNegative = Str[0] == '-';
+		if (bNegative || Str[0] == '+') Idx++;
+		if (Idx >= Str.Len()) return false;
+
+		int64 Value = 0;
+		for (; Idx < Str.Len(); Idx++)
+		{
+			const UTF8CHAR Char = Str[Idx];
+			if (Char < '0' || Char > '9') return false;
+			Value = Value * 10 + (Char - '0');
+			if (Value > MAX_int32) return false;
+		}
+
+		OutValue = static_cast<int32>(bNegative ? -Value : Value);
+		return true;
+	}
+
+	/** 解析浮点数（空字段为 0） */
+	bool ParseFloat(FUtf8StringView Str, float& OutValue)
+	{
+		Str = Str.TrimStartAndEnd();
+		OutValue = 0.f;
+		if (Str.IsEmpty()) return true;
+
+		ANSICHAR Buffer[64];
+		if (Str.Len() >= UE_ARRAY_COUNT(Buffer)) return false;
+		FMemory::Memcpy(Buffer, Str.GetData(), Str.Len());
+		Buffer[Str.Len()] = '\0';
+
+		ANSICHAR* ParseEnd = nullptr;
+		OutValue = FCStringAnsi::Strtod(Buffer, &ParseEnd);
+		return ParseEnd == Buffer + Str.Len();
+	}
+
+	/** 解析装备槽名称（空字段为 `None`） */
+	bool ParseEquipSlot(FUtf8StringView Str, uint8& OutValue)
+	{
+		Str = Str.TrimStartAndEnd();
+		OutValue = static_cast<uint8>(EEveEquipSlot::None);
+		if (Str.IsEmpty()) return true;
+
+		const int64 Value = StaticEnum<EEveEquipSlot>()->GetValueByNameString(FString(Str));
+		if (Value == INDEX_NONE) return false;
+		OutValue = static_cast<uint8>(Value);
+		return true;
+	}
+
+	FUtf8StringView MakeView(const FTCHARToUTF8& Str)
+	{
+		return FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Str.Get()), Str.Length());
+	}
+
+	/** 按 `FEveItemData` 的反射属性导入导出文本 */
+	void ImportItemProperty(const FName PropertyName, const FUtf8StringView Text, FEveItemData& OutItemData)
+	{
+		if (Text.IsEmpty()) return;
+
+		const FProperty* Property = FEveItemData::StaticStruct()->FindPropertyByName(PropertyName);
+		const FString Buffer(Text);
+		if (!Property || !Property->ImportText_InContainer(*Buffer, &OutItemData, nullptr, PPF_None))
+		{
+			UE_LOG(LogEveInventory, Warning, TEXT("Item %d: failed to import %s from catalog text \"%s\""),
+				OutItemData.TID, *PropertyName.ToString(), *Buffer);
+		}
+	}
+
+	/** 按 `FEveItemData` 的反射属性导出文本（默认值导出为空串） */
+	FString ExportItemProperty(const FName PropertyName, const FEveItemData& ItemData)
+	{
+		static const FEveItemData DefaultItemData;
+
+		FString Text;
+		const FProperty* Property = FEveItemData::StaticStruct()->FindPropertyByName(PropertyName);
+		if (Property && !Property->Identical_InContainer(&ItemData, &DefaultItemData))
+		{
+			Property->ExportText_InContainer(0, Text, &ItemData, nullptr, nullptr, PPF_None);
+		}
+		return Text;
+	}
+}
+
+void FEveItemCatalog::Reset()
+{
+	TIDs.Reset();
+	Names.Reset();
+	IconPaths.Reset();
+	Weights.Reset();
+	Volumes.Reset();
+	Values.Reset();
+	EquipSlots.Reset();
+	TagTexts.Reset();
+	StatModifierTexts.Reset();
+	WorldMeshPaths.Reset();
+	Strings.Reset();
+	TIDToRow.Reset();
+}
+
+void FEveItemCatalog::Reserve(const int32 RowNum, const int64 StringBytes)
+{
+	TIDs.Reserve(RowNum);
+	Names.Reserve(RowNum);
+	IconPaths.Reserve(RowNum);
+	Weights.Reserve(RowNum);
+	Volumes.Reserve(RowNum);
+	Values.Reserve(RowNum);
+	EquipSlots.Reserve(RowNum);
+	TagTexts.Reserve(RowNum);
+	StatModifierTexts.Reserve(RowNum);
+	WorldMeshPaths.Reserve(RowNum);
+	TIDToRow.Reserve(RowNum);
+	Strings.Reserve(static_cast<int32>(FMath::Min<int64>(StringBytes, MAX_int32)));
+}
+
+int32 FEveItemCatalog::AddRow(const FEveItemCatalogRow& InRow)
+{
+	// 字符串池只追加，重复的 TID 必须在写入字符串之前拒绝，否则旧行的字符串会成为无法回收的孤儿
+	if (TIDToRow.Contains(InRow.TID)) return INDEX_NONE;
+
+	const int32 Row = TIDs.Add(InRow.TID);
+	TIDToRow.Add(InRow.TID, Row);
+	Names.Add(AddString(InRow.Name));
+	IconPaths.Add(AddString(InRow.IconPath));
+	Weights.Add(InRow.Weight);
+	Volumes.Add(InRow.Volume);
+	Values.Add(InRow.Value);
+	EquipSlots.Add(InRow.EquipSlot);
+	TagTexts.Add(AddString(InRow.Tags));
+	StatModifierTexts.Add(AddString(InRow.StatModifiers));
+	WorldMeshPaths.Add(AddString(InRow.WorldMeshPath));
+	return Row;
+}
+
+/**
+ * @brief 追加一个物品的完整配置
+ * 
+ * 标签与属性加成导出为文本，与 CSV 导入的格式一致。
+ */
+int32 FEveItemCatalog::AddItemData(const FEveItemData& ItemData)
+{
+	using namespace EveItemCatalogCSV;
+
+	const FTCHARToUTF8 Name(*ItemData.Name);
+	const FTCHARToUTF8 IconPath(*ItemData.Icon.ToString());
+	const FTCHARToUTF8 Tags(*ExportItemProperty(GET_MEMBER_NAME_CHECKED(FEveItemData, Tags), ItemData));
+	const FTCHARToUTF8 StatModifiers(*ExportItemProperty(GET_MEMBER_NAME_CHECKED(FEveItemData, StatModifiers), ItemData));
+	const FTCHARToUTF8 WorldMeshPath(*ItemData.WorldMesh.ToString());
+
+	FEveItemCatalogRow Row;
+	Row.TID = ItemData.TID;
+	Row.Name = MakeView(Name);
+	Row.IconPath = MakeView(IconPath);
+	Row.Weight = ItemData.Weight;
+	Row.Volume = ItemData.Volume;
+	Row.Value = ItemData.Value;
+	Row.EquipSlot = static_cast<uint8>(ItemData.EquipSlot);
+	Row.Tags = MakeView(Tags);
+	Row.StatModifiers = MakeView(StatModifiers);
+	Row.WorldMeshPath = MakeView(WorldMeshPath);
+	return AddRow(Row);
+}
+
+FEveItemCatalogRow FEveItemCatalog::GetRow(const int32 Row) const
+{
+	FEveItemCatalogRow OutRow;
+	OutRow.TID = TIDs[Row];
+	OutRow.Name = GetView(Names[Row]);
+	OutRow.IconPath = GetView(IconPaths[Row]);
+	OutRow.Weight = Weights[Row];
+	OutRow.Volume = Volumes[Row];
+	OutRow.Value = Values[Row];
+	OutRow.EquipSlot = EquipSlots[Row];
+	OutRow.Tags = GetView(TagTexts[Row]);
+	OutRow.StatModifiers = GetView(StatModifierTexts[Row]);
+	OutRow.WorldMeshPath = GetView(WorldMeshPaths[Row]);
+	return OutRow;
+}
+
+/**
+ * @brief 由目录行生成物品数据
+ */
+void FEveItemCatalog::MakeItemData(const FEveItemCatalogRow& Row, FEveItemData& OutItemData)
+{
+	using namespace EveItemCatalogCSV;
+
+	OutItemData.TID = Row.TID;
+	OutItemData.Name = FString(Row.Name);
+	OutItemData.Icon = !Row.IconPath.IsEmpty()
+		? TSoftObjectPtr<UTexture2D>(FSoftObjectPath(FPackageName::ExportTextPathToObjectPath(FString(Row.IconPath))))
+		: TSoftObjectPtr<UTexture2D>();
+	OutItemData.Weight = Row.Weight;
+	OutItemData.Volume = Row.Volume;
+	OutItemData.Value = Row.Value;
+	OutItemData.EquipSlot = StaticEnum<EEveEquipSlot>()->IsValidEnumValue(Row.EquipSlot)
+		? static_cast<EEveEquipSlot>(Row.EquipSlot) : EEveEquipSlot::None;
+	OutItemData.WorldMesh = !Row.WorldMeshPath.IsEmpty()
+		? TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(FPackageName::ExportTextPathToObjectPath(FString(Row.WorldMeshPath))))
+		: TSoftObjectPtr<UStaticMesh>();
+
+	OutItemData.Tags.Reset();
+	OutItemData.StatModifiers.Reset();
+	ImportItemProperty(GET_MEMBER_NAME_CHECKED(FEveItemData, Tags), Row.Tags, OutItemData);
+	ImportItemProperty(GET_MEMBER_NAME_CHECKED(FEveItemData, StatModifiers), Row.StatModifiers, OutItemData);
+}
+
+FEveItemCatalog::FStrRef FEveItemCatalog::AddString(const FUtf8StringView Str)
+{
+	FStrRef Ref;
+	Ref.Offset = Strings.Num();
+	Ref.Len = Str.Len();
+	Strings.Append(Str.GetData(), Str.Len());
+	return Ref;
+}
+
+SIZE_T FEveItemCatalog::GetAllocatedSize() const
+{
+	return TIDs.GetAllocatedSize() + Names.GetAllocatedSize() + IconPaths.GetAllocatedSize()
+		+ Weights.GetAllocatedSize() + Volumes.GetAllocatedSize() + Values.GetAllocatedSize() + EquipSlots.GetAllocatedSize()
+		+ TagTexts.GetAllocatedSize() + StatModifierTexts.GetAllocatedSize() + WorldMeshPaths.GetAllocatedSize()
+		+ Strings.GetAllocatedSize() + TIDToRow.GetAllocatedSize();
+}
+
+/**
+ * @brief 从 CSV 文件流式导入
+ * 
+ * 平台不支持内存映射时退回到一次性读取整个文件。
+ */
+bool FEveItemCatalog::ImportCSV(const FString& FilePath, FString* OutError)
+{
+	const TUniquePtr<IMappedFileHandle> MappedFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FilePath));
+	if (MappedFile && MappedFile->GetFileSize() > 0)
+	{
+		const TUniquePtr<IMappedFileRegion> Region(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+		if (Region)
+		{
+			return ImportCSVBuffer(Region->GetMappedPtr(), Region->GetMappedSize(), OutError);
+		}
+	}
+
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FilePath))
+	{
+		if (OutError) *OutError = FString::Printf(TEXT("Failed to read %s"), *FilePath);
+		return false;
+	}
+	return ImportCSVBuffer(Bytes.GetData(), Bytes.Num(), OutError);
+}
+
+/**
+ * @brief 从内存中的 CSV 数据导入
+ */
+bool FEveItemCatalog::ImportCSVBuffer(const uint8* Data, const int64 Size, FString* OutError)
+{
+	using namespace EveItemCatalogCSV;
+
+	const uint8* P = Data;
+	const uint8* End = Data + Size;
+
+	// 跳过 UTF-8 BOM
+	if (Size >= 3 && P[0] == 0xEF && P[1] == 0xBB && P[2] == 0xBF)
+	{
+		P += 3;
+	}
+
+	TArray<FUtf8StringView> Fields;
+	TArray<TArray<UTF8CHAR>> Unescaped;
+
+	// 表头：定位需要的列（列名与 `FEveItemData` 的字段名相同）
+	enum EColumn { ColTID, ColName, ColIcon, ColWeight, ColVolume, ColValue, ColTags, ColEquipSlot, ColStatModifiers, ColWorldMesh, ColumnNum };
+	static const FUtf8StringView ColumnNames[ColumnNum] = {
+		UTF8TEXTVIEW("TID"), UTF8TEXTVIEW("Name"), UTF8TEXTVIEW("Icon"), UTF8TEXTVIEW("Weight"), UTF8TEXTVIEW("Volume"),
+		UTF8TEXTVIEW("Value"), UTF8TEXTVIEW("Tags"), UTF8TEXTVIEW("EquipSlot"), UTF8TEXTVIEW("StatModifiers"), UTF8TEXTVIEW("WorldMesh"),
+	};
+
+	P = ParseRecord(P, End, Fields, Unescaped);
+	int32 Cols[ColumnNum];
+	int32 MinFieldNum = 0;
+	for (int32 Column = 0; Column < ColumnNum; Column++)
+	{
+		Cols[Column] = INDEX_NONE;
+		for (int32 Col = 0; Col < Fields.Num(); Col++)
+		{
+			if (Fields[Col].TrimStartAndEnd().Equals(ColumnNames[Column], ESearchCase::IgnoreCase))
+			{
+				Cols[Column] = Col;
+				MinFieldNum = FMath::Max(MinFieldNum, Col + 1);
+				break;
+			}
+		}
+	}
+	if (Cols[ColTID] == INDEX_NONE)
+	{
+		if (OutError) *OutError = TEXT("Missing TID column");
+		return false;
+	}
+
+	// 预分配：行数按换行符估算，字符串池按剩余字节数上限预留，导入结束后收缩
+	Reset();
+	Reserve(static_cast<int32>(FMath::Min<int64>(CountLines(P, End), MAX_int32)), End - P);
+
+	int32 BadRowNum = 0;
+	int32 DuplicatedRowNum = 0;
+	while (P < End)
+	{
+		P = ParseRecord(P, End, Fields, Unescaped);
+		if (Fields.Num() == 1 && Fields[0].IsEmpty()) continue; // 空行
+
+		if (Fields.Num() < MinFieldNum)
+		{
+			BadRowNum++;
+			continue;
+		}
+
+		auto Field = [&Fields, &Cols](const EColumn Column)
+		{
+			return Cols[Column] != INDEX_NONE ? Fields[Cols[Column]] : FUtf8StringView();
+		};
+
+		FEveItemCatalogRow Row;
+		Row.Name = Field(ColName);
+		Row.IconPath = Field(ColIcon);
+		Row.Tags = Field(ColTags);
+		Row.StatModifiers = Field(ColStatModifiers);
+		Row.WorldMeshPath = Field(ColWorldMesh);
+
+		const FUtf8StringView ValueField = Field(ColValue);
+		const bool bValid = ParseInt(Field(ColTID), Row.TID)
+			&& ParseFloat(Field(ColWeight), Row.Weight) && ParseFloat(Field(ColVolume), Row.Volume)
+			&& (ValueField.TrimStartAndEnd().IsEmpty() || ParseInt(ValueField, Row.Value))
+			&& ParseEquipSlot(Field(ColEquipSlot), Row.EquipSlot);
+		if (!bValid)
+		{
+			BadRowNum++;
+			continue;
+		}
+
+		if (AddRow(Row) == INDEX_NONE)
+		{
+			DuplicatedRowNum++;
+		}
+	}
+
+	Strings.Shrink();
+
+	if (BadRowNum > 0)
+	{
+		UE_LOG(LogEveInventory, Warning, TEXT("Item catalog import skipped %d malformed row(s)"), BadRowNum);
+	}
+	if (DuplicatedRowNum > 0)
+	{
+		UE_LOG(LogEveInventory, Warning, TEXT("Item catalog import skipped %d row(s) with a duplicated TID"), DuplicatedRowNum);
+	}
+	return true;
+}
+
+#if !UE_BUILD_SHIPPING
+/**
+ * @brief 对比流式导入与 `UDataTable` CSV 导入的耗时和内存
+ * 
+ * 两者读取同一个文件（表头需包含 `---` 行名列以兼容 `UDataTable`）。
+ */
+static FAutoConsoleCommand GEveBenchItemCatalogCmd(
+	TEXT("Eve.BenchItemCatalog"),
+	TEXT("Compare streaming item catalog import with UDataTable CSV import. Usage: Eve.BenchItemCatalog <File.csv>"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() < 1)
+		{
+			UE_LOG(LogEveInventory, Display, TEXT("Usage: Eve.BenchItemCatalog <File.csv>"));
+			return;
+		}
+		const FString& FilePath = Args[0];
+
+		// 流式导入
+		double StartTime = FPlatformTime::Seconds();
+		FEveItemCatalog Catalog;
+		FString Error;
+		if (!Catalog.ImportCSV(FilePath, &Error))
+		{
+			UE_LOG(LogEveInventory, Warning, TEXT("Item catalog import failed: %s"), *Error);
+			return;
+		}
+		const double CatalogMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		// `UDataTable` 导入
+		StartTime = FPlatformTime::Seconds();
+		FString FileContent;
+		FFileHelper::LoadFileToString(FileContent, *FilePath);
+		UDataTable* DataTable = NewObject<UDataTable>(GetTransientPackage());
+		DataTable->RowStruct = FEveItemData::StaticStruct();
+		const TArray<FString> Problems = DataTable->CreateTableFromCSVString(FileContent);
+		const double DataTableMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+		const SIZE_T DataTableBytes = DataTable->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+
+		UE_LOG(LogEveInventory, Display, TEXT("Catalog:   %d rows, %.2f ms, %.2f MB"),
+			Catalog.Num(), CatalogMs, Catalog.GetAllocatedSize() / (1024.0 * 1024.0));
+		UE_LOG(LogEveInventory, Display, TEXT("DataTable: %d rows, %.2f ms, %.2f MB (%d problem(s))"),
+			DataTable->GetRowMap().Num(), DataTableMs, DataTableBytes / (1024.0 * 1024.0), Problems.Num());
+
+		DataTable->MarkAsGarbage();
+	}));
+#endif
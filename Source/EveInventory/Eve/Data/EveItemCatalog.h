@@ -0,0 +1,171 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FEveItemData;
+
+/**
+ * @brief 物品目录中的一行（字符串为视图，指向目录的字符串池或调用方的缓冲区）
+ * 
+ * 与 `FEveItemData` 的配置字段一一对应；标签与属性加成保存为导出文本（与 `UDataTable` CSV 的格式相同），
+ * 生成物品配置时才解析。
+ */
+struct FEveItemCatalogRow
+{
+	int32 TID = -1;
+	FUtf8StringView Name;
+	FUtf8StringView IconPath;
+	float Weight = 0.f;
+	float Volume = 0.f;
+	int32 Value = 0;
+	/** `EEveEquipSlot` */
+	uint8 EquipSlot = 0;
+	/** `FGameplayTagContainer` 的导出文本 */
+	FUtf8StringView Tags;
+	/** `TArray<FEveStatModifier>` 的导出文本 */
+	FUtf8StringView StatModifiers;
+	FUtf8StringView WorldMeshPath;
+};
+
+/**
+ * @brief 紧凑的物品目录（结构数组存储）
+ * 
+ * 面向几十万行的外部物品表：每列一个连续数组，字符串统一存放在 UTF-8 字符串池中，
+ * 每行只占用 TID + 数值列 + 若干字符串引用，不为每个物品创建 `UEveItemCfg` 或 `FEveItemData`。
+ * 背包真正用到某个物品时，再由 `UEveInventoryMgr` 按需生成物品配置。
+ */
+struct FEveItemCatalog
+{
+public:
+	/** 字符串池中的一段字符串 */
+	struct FStrRef
+	{
+		uint32 Offset = 0;
+		uint32 Len = 0;
+	};
+
+	/** 清空目录 */
+	void Reset();
+
+	/**
+	 * @brief 预分配空间
+	 * 
+	 * @param RowNum 预计行数
+	 * @param StringBytes 预计字符串总字节数
+	 */
+	void Reserve(int32 RowNum, int64 StringBytes);
+
+	/**
+	 * @brief 追加一行（TID 重复时拒绝，不写入字符串池）
+	 * 
+	 * @return 行索引，TID 重复时返回 `INDEX_NONE`
+	 */
+	int32 AddRow(const FEveItemCatalogRow& Row);
+
+	/**
+	 * @brief 追加一个物品的完整配置（用于从 `DTItem` 烘焙）
+	 * 
+	 * @return 行索引，TID 重复时返回 `INDEX_NONE`
+	 */
+	int32 AddItemData(const FEveItemData& ItemData);
+
+	/** @brief 行数 */
+	int32 Num() const { return TIDs.Num(); }
+
+	/**
+	 * @brief 查找 TID 所在的行
+	 * 
+	 * @return 行索引，不存在时返回 `INDEX_NONE`
+	 */
+	int32 FindRow(const int32 TID) const
+	{
+		const int32* Row = TIDToRow.Find(TID);
+		return Row ? *Row : INDEX_NONE;
+	}
+
+	int32 GetTID(const int32 Row) const { return TIDs[Row]; }
+	FUtf8StringView GetNameView(const int32 Row) const { return GetView(Names[Row]); }
+	FUtf8StringView GetIconPathView(const int32 Row) const { return GetView(IconPaths[Row]); }
+
+	FString GetName(const int32 Row) const { return FString(GetNameView(Row)); }
+	FString GetIconPath(const int32 Row) const { return FString(GetIconPathView(Row)); }
+
+	/** @brief 读取整行（字符串视图指向字符串池，目录修改后失效） */
+	FEveItemCatalogRow GetRow(int32 Row) const;
+
+	/**
+	 * @brief 由目录行生成物品数据
+	 * 
+	 * 标签与属性加成按 `FEveItemData` 的反射属性导入，解析失败的列保持默认值并输出警告。
+	 */
+	static void MakeItemData(const FEveItemCatalogRow& Row, FEveItemData& OutItemData);
+
+	/** @brief 目录占用的堆内存（字节） */
+	SIZE_T GetAllocatedSize() const;
+
+	/**
+	 * @brief 从 CSV 文件流式导入
+	 * 
+	 * - 通过内存映射读取文件，不把整个文件复制到内存
+	 * - 以 8 字节为单位（SWAR）扫描分隔符，只在遇到引号时逐字节处理
+	 * - 表头中与 `FEveItemData` 配置字段同名的列（`TID`、`Name`、`Icon`、`Weight`、`Volume`、`Value`、`Tags`、
+	 *   `EquipSlot`、`StatModifiers`、`WorldMesh`）写入目录，其他列忽略（兼容 `UDataTable` 的行名列）
+	 * 
+	 * @param FilePath CSV 文件路径
+	 * @param OutError 可选输出，失败原因
+	 * @return 是否导入成功
+	 */
+	bool ImportCSV(const FString& FilePath, FString* OutError = nullptr);
+
+	/**
+	 * @brief 从内存中的 CSV 数据导入（`ImportCSV` 的解析部分）
+	 */
+	bool ImportCSVBuffer(const uint8* Data, int64 Size, FString* OutError = nullptr);
+
+private:
+	FUtf8StringView GetView(const FStrRef& Ref) const
+	{
+		return FUtf8StringView(Strings.GetData() + Ref.Offset, Ref.Len);
+	}
+
+	FStrRef AddString(FUtf8StringView Str);
+
+private:
+	/** 物品 TID（按行） */
+	TArray<int32> TIDs;
+
+	/** 物品名称（按行，指向字符串池） */
+	TArray<FStrRef> Names;
+
+	/** 图标资源路径（按行，指向字符串池） */
+	TArray<FStrRef> IconPaths;
+
+	/** 单个物品的重量（按行） */
+	TArray<float> Weights;
+
+	/** 单个物品的体积（按行） */
+	TArray<float> Volumes;
+
+	/** 单个物品的价值（按行） */
+	TArray<int32> Values;
+
+	/** 装备槽（按行，`EEveEquipSlot`） */
+	TArray<uint8> EquipSlots;
+
+	/** 标签导出文本（按行，指向字符串池） */
+	TArray<FStrRef> TagTexts;
+
+	/** 属性加成导出文本（按行，指向字符串池） */
+	TArray<FStrRef> StatModifierTexts;
+
+	/** 掉落模型资源路径（按行，指向字符串池） */
+	TArray<FStrRef> WorldMeshPaths;
+
+	/** UTF-8 字符串池 */
+	TArray<UTF8CHAR> Strings;
+
+	/** TID 到行索引的映射 */
+	TMap<int32, int32> TIDToRow;
+};
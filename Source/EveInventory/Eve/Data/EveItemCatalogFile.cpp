@@ -0,0 +1,234 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#include "EveItemCatalogFile.h"
+
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+
+static_assert(sizeof(FEveItemCatalogFile::FHeader) == 48, "Item catalog header layout changed");
+static_assert(sizeof(FEveItemCatalogFile::FRecord) == 60, "Item catalog record layout changed");
+
+FEveItemCatalogFile::FEveItemCatalogFile() = default;
+
+FEveItemCatalogFile::~FEveItemCatalogFile()
+{
+	Close();
+}
+
+/**
+ * @brief 映射并打开烘焙文件
+ * 
+ * 只校验文件头与各段边界（常数时间），不读取记录。
+ */
+bool FEveItemCatalogFile::Open(const FString& FilePath, FString* OutError)
+{
+	Close();
+
+#if PLATFORM_LITTLE_ENDIAN
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FilePath));
+	if (!MappedFile)
+	{
+		if (OutError) *OutError = FString::Printf(TEXT("Failed to map %s"), *FilePath);
+		return false;
+	}
+
+	const int64 FileSize = MappedFile->GetFileSize();
+	if (FileSize < static_cast<int64>(sizeof(FHeader)))
+	{
+		if (OutError) *OutError = TEXT("File too small");
+		Close();
+		return false;
+	}
+
+	MappedRegion.Reset(MappedFile->MapRegion(0, FileSize));
+	if (!MappedRegion)
+	{
+		if (OutError) *OutError = TEXT("Failed to map region");
+		Close();
+		return false;
+	}
+
+	const uint8* Base = MappedRegion->GetMappedPtr();
+	const FHeader* FileHeader = reinterpret_cast<const FHeader*>(Base);
+
+	const uint64 RecordsEnd = FileHeader->RecordsOffset + static_cast<uint64>(FileHeader->RowNum) * sizeof(FRecord);
+	const uint64 HashEnd = FileHeader->HashOffset + static_cast<uint64>(FileHeader->HashSize) * sizeof(int32);
+	const uint64 StringsEnd = FileHeader->StringsOffset + FileHeader->StringsSize;
+	const bool bValid = FileHeader->Magic == Magic && FileHeader->Version == Version
+		&& FMath::IsPowerOfTwo(FileHeader->HashSize) && FileHeader->HashSize > FileHeader->RowNum
+		&& FileHeader->RecordsOffset % alignof(FRecord) == 0 && FileHeader->HashOffset % alignof(int32) == 0
+		&& RecordsEnd <= static_cast<uint64>(FileSize) && HashEnd <= static_cast<uint64>(FileSize) && StringsEnd <= static_cast<uint64>(FileSize);
+	if (!bValid)
+	{
+		if (OutError) *OutError = FString::Printf(TEXT("Invalid or outdated item catalog %s"), *FilePath);
+		Close();
+		return false;
+	}
+
+	Header = FileHeader;
+	Records = reinterpret_cast<const FRecord*>(Base + FileHeader->RecordsOffset);
+	HashTable = reinterpret_cast<const int32*>(Base + FileHeader->HashOffset);
+	Strings = reinterpret_cast<const UTF8CHAR*>(Base + FileHeader->StringsOffset);
+	return true;
+#else
+	if (OutError) *OutError = TEXT("Binary item catalog requires a little-endian platform");
+	return false;
+#endif
+}
+
+void FEveItemCatalogFile::Close()
+{
+	Header = nullptr;
+	Records = nullptr;
+	HashTable = nullptr;
+	Strings = nullptr;
+
+	// 先释放映射区域，再关闭文件
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+/**
+ * @brief 查找 TID 所在的行（线性探测）
+ */
+int32 FEveItemCatalogFile::FindRow(const int32 TID) const
+{
+	if (!Header) return INDEX_NONE;
+
+	const uint32 Mask = Header->HashSize - 1;
+	for (uint32 Slot = HashTID(TID) & Mask, Probe = 0; Probe < Header->HashSize; Slot = (Slot + 1) & Mask, Probe++)
+	{
+		const int32 Row = HashTable[Slot];
+		if (Row < 0 || static_cast<uint32>(Row) >= Header->RowNum) return INDEX_NONE;
+		if (Records[Row].TID == TID) return Row;
+	}
+	return INDEX_NONE;
+}
+
+FEveItemCatalogRow FEveItemCatalogFile::GetRow(const int32 Row) const
+{
+	const FRecord& Record = Records[Row];
+
+	FEveItemCatalogRow OutRow;
+	OutRow.TID = Record.TID;
+	OutRow.Name = GetView(Record.NameOffset, Record.NameLen);
+	OutRow.IconPath = GetView(Record.IconOffset, Record.IconLen);
+	OutRow.Weight = Record.Weight;
+	OutRow.Volume = Record.Volume;
+	OutRow.Value = Record.Value;
+	OutRow.EquipSlot = Record.EquipSlot;
+	OutRow.Tags = GetView(Record.TagsOffset, Record.TagsLen);
+	OutRow.StatModifiers = GetView(Record.StatModifiersOffset, Record.StatModifiersLen);
+	OutRow.WorldMeshPath = GetView(Record.WorldMeshOffset, Record.WorldMeshLen);
+	return OutRow;
+}
+
+FUtf8StringView FEveItemCatalogFile::GetView(const uint32 Offset, const uint32 Len) const
+{
+	if (static_cast<uint64>(Offset) + Len > Header->StringsSize) return FUtf8StringView();
+	return FUtf8StringView(Strings + Offset, Len);
+}
+
+uint32 FEveItemCatalogFile::HashTID(const int32 TID)
+{
+	uint32 Hash = static_cast<uint32>(TID);
+	Hash ^= Hash >> 16;
+	Hash *= 0x7feb352d;
+	Hash ^= Hash >> 15;
+	Hash *= 0x846ca68b;
+	Hash ^= Hash >> 16;
+	return Hash;
+}
+
+/**
+ * @brief 将物品目录烘焙为二进制文件
+ */
+bool FEveItemCatalogFile::Write(const FEveItemCatalog& Catalog, const FString& FilePath, FString* OutError)
+{
+	const int32 RowNum = Catalog.Num();
+
+	// 字符串去重，写入字符串池
+	TArray<UTF8CHAR> StringPool;
+	TMap<FString, uint32> InternedOffsets;
+	auto Intern = [&StringPool, &InternedOffsets](const FUtf8StringView Str) -> uint32
+	{
+		const FString Key(Str);
+		if (const uint32* Offset = InternedOffsets.Find(Key))
+		{
+			return *Offset;
+		}
+		const uint32 Offset = StringPool.Num();
+		StringPool.Append(Str.GetData(), Str.Len());
+		InternedOffsets.Add(Key, Offset);
+		return Offset;
+	};
+
+	TArray<FRecord> OutRecords;
+	OutRecords.SetNum(RowNum);
+	for (int32 Row = 0; Row < RowNum; Row++)
+	{
+		const FEveItemCatalogRow CatalogRow = Catalog.GetRow(Row);
+
+		FRecord& Record = OutRecords[Row];
+		Record.TID = CatalogRow.TID;
+		Record.NameOffset = Intern(CatalogRow.Name);
+		Record.NameLen = CatalogRow.Name.Len();
+		Record.IconOffset = Intern(CatalogRow.IconPath);
+		Record.IconLen = CatalogRow.IconPath.Len();
+		Record.Weight = CatalogRow.Weight;
+		Record.Volume = CatalogRow.Volume;
+		Record.Value = CatalogRow.Value;
+		Record.TagsOffset = Intern(CatalogRow.Tags);
+		Record.TagsLen = CatalogRow.Tags.Len();
+		Record.StatModifiersOffset = Intern(CatalogRow.StatModifiers);
+		Record.StatModifiersLen = CatalogRow.StatModifiers.Len();
+		Record.WorldMeshOffset = Intern(CatalogRow.WorldMeshPath);
+		Record.WorldMeshLen = CatalogRow.WorldMeshPath.Len();
+		Record.EquipSlot = CatalogRow.EquipSlot;
+	}
+
+	// TID 哈希表，负载不超过 50%
+	const uint32 HashSize = FMath::RoundUpToPowerOfTwo(FMath::Max(2u, static_cast<uint32>(RowNum) * 2));
+	TArray<int32> OutHashTable;
+	OutHashTable.Init(-1, HashSize);
+	for (int32 Row = 0; Row < RowNum; Row++)
+	{
+		uint32 Slot = HashTID(OutRecords[Row].TID) & (HashSize - 1);
+		while (OutHashTable[Slot] != -1)
+		{
+			Slot = (Slot + 1) & (HashSize - 1);
+		}
+		OutHashTable[Slot] = Row;
+	}
+
+	FHeader OutHeader;
+	OutHeader.Magic = Magic;
+	OutHeader.Version = Version;
+	OutHeader.RowNum = RowNum;
+	OutHeader.HashSize = HashSize;
+	OutHeader.RecordsOffset = Align(sizeof(FHeader), 8);
+	OutHeader.HashOffset = Align(OutHeader.RecordsOffset + OutRecords.Num() * sizeof(FRecord), 8);
+	OutHeader.StringsOffset = Align(OutHeader.HashOffset + OutHashTable.Num() * sizeof(int32), 8);
+	OutHeader.StringsSize = StringPool.Num();
+
+	const TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!Writer)
+	{
+		if (OutError) *OutError = FString::Printf(TEXT("Failed to create %s"), *FilePath);
+		return false;
+	}
+
+	auto WritePadded = [&Writer](const void* Data, const int64 Size, const uint64 Offset)
+	{
+		uint8 Zero[8] = {};
+		Writer->Serialize(Zero, Offset - Writer->Tell());
+		Writer->Serialize(const_cast<void*>(Data), Size);
+	};
+	WritePadded(&OutHeader, sizeof(OutHeader), 0);
+	WritePadded(OutRecords.GetData(), OutRecords.Num() * sizeof(FRecord), OutHeader.RecordsOffset);
+	WritePadded(OutHashTable.GetData(), OutHashTable.Num() * sizeof(int32), OutHeader.HashOffset);
+	WritePadded(StringPool.GetData(), StringPool.Num(), OutHeader.StringsOffset);
+
+	return Writer->Close();
+}
@@ -0,0 +1,128 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EveItemCatalog.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * @brief 烘焙后的二进制物品目录（只读，内存映射）
+ * 
+ * 文件布局（小端）：
+ * - 文件头 `FHeader`
+ * - 定长记录 `FRecord` 数组（按行）
+ * - TID 哈希表（开放寻址，槽位存行索引，空槽为 -1）
+ * - 去重后的 UTF-8 字符串池
+ * 
+ * 打开时只映射文件并校验文件头，不逐行反序列化，启动开销与行数无关；
+ * 查询直接读取映射内存，不产生任何分配。
+ */
+class FEveItemCatalogFile
+{
+public:
+	/** 文件标识 `EVIC` */
+	static constexpr uint32 Magic = 0x43495645;
+
+	/** 文件格式版本 */
+	static constexpr uint32 Version = 2;
+
+	/** 默认的烘焙文件扩展名 */
+	static constexpr const TCHAR* Extension = TEXT("evecat");
+
+	struct FHeader
+	{
+		uint32 Magic = 0;
+		uint32 Version = 0;
+		uint32 RowNum = 0;
+		uint32 HashSize = 0;
+		uint64 RecordsOffset = 0;
+		uint64 HashOffset = 0;
+		uint64 StringsOffset = 0;
+		uint64 StringsSize = 0;
+	};
+
+	struct FRecord
+	{
+		int32 TID = -1;
+		uint32 NameOffset = 0;
+		uint32 NameLen = 0;
+		uint32 IconOffset = 0;
+		uint32 IconLen = 0;
+		float Weight = 0.f;
+		float Volume = 0.f;
+		int32 Value = 0;
+		uint32 TagsOffset = 0;
+		uint32 TagsLen = 0;
+		uint32 StatModifiersOffset = 0;
+		uint32 StatModifiersLen = 0;
+		uint32 WorldMeshOffset = 0;
+		uint32 WorldMeshLen = 0;
+		uint8 EquipSlot = 0;
+		uint8 Padding[3] = {};
+	};
+
+public:
+	FEveItemCatalogFile();
+	~FEveItemCatalogFile();
+
+	UE_NONCOPYABLE(FEveItemCatalogFile);
+
+	/**
+	 * @brief 映射并打开烘焙文件
+	 * 
+	 * @param FilePath 文件路径
+	 * @param OutError 可选输出，失败原因
+	 * @return 是否打开成功
+	 */
+	bool Open(const FString& FilePath, FString* OutError = nullptr);
+
+	/** @brief 关闭并解除映射 */
+	void Close();
+
+	bool IsOpen() const { return Header != nullptr; }
+
+	int32 Num() const { return Header ? static_cast<int32>(Header->RowNum) : 0; }
+
+	/**
+	 * @brief 查找 TID 所在的行（哈希表原地查询）
+	 * 
+	 * @return 行索引，不存在时返回 `INDEX_NONE`
+	 */
+	int32 FindRow(int32 TID) const;
+
+	int32 GetTID(const int32 Row) const { return Records[Row].TID; }
+	FUtf8StringView GetNameView(const int32 Row) const { return GetView(Records[Row].NameOffset, Records[Row].NameLen); }
+	FUtf8StringView GetIconPathView(const int32 Row) const { return GetView(Records[Row].IconOffset, Records[Row].IconLen); }
+
+	/** @brief 读取整行（字符串视图指向映射内存） */
+	FEveItemCatalogRow GetRow(int32 Row) const;
+
+	/**
+	 * @brief 将物品目录烘焙为二进制文件（字符串去重）
+	 * 
+	 * @param Catalog 物品目录
+	 * @param FilePath 输出文件路径
+	 * @param OutError 可选输出，失败原因
+	 * @return 是否写入成功
+	 */
+	static bool Write(const FEveItemCatalog& Catalog, const FString& FilePath, FString* OutError = nullptr);
+
+private:
+	/** 字符串池中的一段字符串，越界时返回空串 */
+	FUtf8StringView GetView(uint32 Offset, uint32 Len) const;
+
+	static uint32 HashTID(int32 TID);
+
+private:
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/** 以下指针均指向映射内存 */
+	const FHeader* Header = nullptr;
+	const FRecord* Records = nullptr;
+	const int32* HashTable = nullptr;
+	const UTF8CHAR* Strings = nullptr;
+};
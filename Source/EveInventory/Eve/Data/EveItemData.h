@@ -4,9 +4,66 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DataTable.h"
+#include "GameplayTagContainer.h"
+#include "Styling/SlateBrush.h"
 #include "EveItemData.generated.h"
 
 class UEveItemCfg;
+class UStaticMesh;
+class UTexture2D;
+
+/**
+ * @brief 装备槽类型
+ */
+UENUM(BlueprintType)
+enum class EEveEquipSlot : uint8
+{
+	/** 不可装备 */
+	None,
+	Head,
+	Chest,
+	Weapon,
+	Ring,
+};
+
+/**
+ * @brief 角色属性通道
+ * 
+ * 每个通道独立缓存、独立标脏，装备变化只重新计算受影响的通道。
+ */
+UENUM(BlueprintType)
+enum class EEveStatChannel : uint8
+{
+	MaxHealth,
+	Attack,
+	Defense,
+	MoveSpeed,
+	CritChance,
+	Num UMETA(Hidden),
+};
+
+/**
+ * @brief 装备提供的单条属性加成
+ */
+USTRUCT(BlueprintType)
+struct FEveStatModifier
+{
+	GENERATED_BODY()
+
+public:
+	/** 属性通道 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Equipment")
+	EEveStatChannel Channel = EEveStatChannel::MaxHealth;
+
+	/** 加成数值 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Equipment")
+	float Value = 0.f;
+
+	bool operator==(const FEveStatModifier& Other) const
+	{
+		return Channel == Other.Channel && Value == Other.Value;
+	}
+};
 
 /**
  * @brief 物品数据结构体，继承自 `FTableRowBase`
@@ -27,9 +84,143 @@ public:
 	UPROPERTY(EditDefaultsOnly)
 	FString Name;
 
-	/** 物品图标 */
+	/** 物品图标（软引用，物品进入背包后才异步加载，不随数据表常驻） */
+	UPROPERTY(EditDefaultsOnly)
+	TSoftObjectPtr<UTexture2D> Icon;
+
+	/** 单个物品的重量 */
+	UPROPERTY(EditDefaultsOnly)
+	float Weight = 0.f;
+
+	/** 单个物品的体积 */
 	UPROPERTY(EditDefaultsOnly)
-	UTexture2D* Icon;
+	float Volume = 0.f;
+
+	/** 单个物品的价值 */
+	UPROPERTY(EditDefaultsOnly)
+	int32 Value = 0;
+
+	/** 物品分类标签（如 `Item.Consumable`、`Item.Quest`），加载时编译为位掩码用于筛选 */
+	UPROPERTY(EditDefaultsOnly, meta=(Categories="Item"))
+	FGameplayTagContainer Tags;
+
+	/** 可装备到的槽类型（`None` 表示不可装备） */
+	UPROPERTY(EditDefaultsOnly)
+	EEveEquipSlot EquipSlot = EEveEquipSlot::None;
+
+	/** 装备后提供的属性加成 */
+	UPROPERTY(EditDefaultsOnly)
+	TArray<FEveStatModifier> StatModifiers;
+
+	/** 掉落到场景中时使用的模型（为空时使用 `UEveAssetMgr::DroppedItemMesh`） */
+	UPROPERTY(EditDefaultsOnly)
+	TSoftObjectPtr<UStaticMesh> WorldMesh;
+
+	/**
+	 * 预生成的图标画刷（运行时由 `UEveIconAtlas` 写入，不参与序列化）
+	 * 
+	 * 指向图标图集中的 UV 区域，UI 直接 `SetBrush` 使用，无需每次更新时重新构建。
+	 */
+	UPROPERTY(Transient, BlueprintReadOnly)
+	FSlateBrush IconBrush;
+
+	/** 配置字段是否一致（不比较运行时生成的 `IconBrush`） */
+	bool HasSameCfg(const FEveItemData& Other) const
+	{
+		return TID == Other.TID && Name == Other.Name && Icon == Other.Icon && Weight == Other.Weight && Volume == Other.Volume
+			&& Value == Other.Value && Tags == Other.Tags && EquipSlot == Other.EquipSlot && StatModifiers == Other.StatModifiers && WorldMesh == Other.WorldMesh;
+	}
+};
+
+/**
+ * @brief 物品堆叠（TID + 数量）
+ * 
+ * 用于批量添加、掉落、配方等只关心 "哪种物品多少个" 的场景。
+ */
+USTRUCT(BlueprintType)
+struct FEveItemStack
+{
+	GENERATED_BODY()
+
+public:
+	/** 物品唯一 ID */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory")
+	int32 TID = -1;
+
+	/** 物品数量 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory")
+	int32 Amount = 0;
+
+	FEveItemStack() = default;
+	FEveItemStack(const int32 InTID, const int32 InAmount) : TID(InTID), Amount(InAmount) {}
+};
+
+/**
+ * @brief 紧凑的格子记录（8 字节：TID + 24 位数量 + 8 位标记）
+ * 
+ * 不含 UObject 与哈希容器，用于存档、快照与大量格子的存储，下标即格子索引。
+ */
+struct FEveItemSlotRecord
+{
+	/** 标记位 */
+	enum EFlags : uint8
+	{
+		/** 格子中有物品 */
+		Occupied = 1 << 0,
+		/** 格子被预留 */
+		Reserved = 1 << 1,
+	};
+
+	/** 数量上限（24 位） */
+	static constexpr int32 MaxAmount = (1 << 24) - 1;
+
+	/** 物品唯一 ID（空格子为 -1） */
+	int32 TID = -1;
+
+	/** 物品数量 */
+	uint32 Amount : 24;
+
+	/** `EFlags` 组合 */
+	uint32 Flags : 8;
+
+	FEveItemSlotRecord() : Amount(0), Flags(0) {}
+
+	/** 格子中是否有物品 */
+	bool IsOccupied() const { return (Flags & Occupied) != 0; }
+};
+static_assert(sizeof(FEveItemSlotRecord) == 8, "FEveItemSlotRecord should stay packed");
+
+/**
+ * @brief 物品统计汇总（数量、总重量、总体积、总价值）
+ * 
+ * 由 `UEveInventoryMgr` 在物品数量变化时增量维护，查询时无需遍历背包。
+ */
+USTRUCT(BlueprintType)
+struct FEveItemAggregate
+{
+	GENERATED_BODY()
+
+public:
+	/** 物品总数量 */
+	UPROPERTY(BlueprintReadOnly, Category = "Inventory")
+	int32 Amount = 0;
+
+	/** 总重量 */
+	UPROPERTY(BlueprintReadOnly, Category = "Inventory")
+	float Weight = 0.f;
+
+	/** 总体积 */
+	UPROPERTY(BlueprintReadOnly, Category = "Inventory")
+	float Volume = 0.f;
+
+	/** 总价值 */
+	UPROPERTY(BlueprintReadOnly, Category = "Inventory")
+	int64 Value = 0;
+
+	bool operator==(const FEveItemAggregate& Other) const
+	{
+		return Amount == Other.Amount && Weight == Other.Weight && Volume == Other.Volume && Value == Other.Value;
+	}
 };
 
 /**
@@ -55,6 +246,10 @@ public:
 	UPROPERTY(BlueprintReadWrite, Category = "Inventory")
 	int32 PosIdx = 0;
 
+	/** 物品配置在 `UEveInventoryMgr::ItemCfgs` 中的稠密索引（添加时解析一次，之后直接数组访问） */
+	UPROPERTY(BlueprintReadOnly, Category = "Inventory")
+	int32 CfgIdx = INDEX_NONE;
+
 	/**
 	 * @brief 初始化物品信息
 	 * 
@@ -109,6 +304,23 @@ public:
 	UPROPERTY(BlueprintReadOnly)
 	FEveItemData ItemData;
 
+	/** 编译后的标签掩码（由 `UEveInventoryMgr` 在创建或更新配置时写入，见 `FEveItemTagIndex`） */
+	uint64 TagBits = 0;
+
+	/** 物品定义 UI 资源包提供的名称（UI 加载后写入，不属于 `ItemData`，热重载比较时不受影响） */
+	UPROPERTY(BlueprintReadOnly)
+	FString DefinitionName;
+
+	/** 物品定义 UI 资源包提供的图标（同上） */
+	UPROPERTY(BlueprintReadOnly)
+	TSoftObjectPtr<UTexture2D> DefinitionIcon;
+
+	/** @brief 显示用的名称：物品定义提供时优先，否则为配置中的名称 */
+	const FString& GetDisplayName() const { return DefinitionName.IsEmpty() ? ItemData.Name : DefinitionName; }
+
+	/** @brief 显示用的图标：物品定义提供时优先，否则为配置中的图标 */
+	const TSoftObjectPtr<UTexture2D>& GetDisplayIcon() const { return DefinitionIcon.IsNull() ? ItemData.Icon : DefinitionIcon; }
+
 	/**
 	 * @brief 从 `FEveItemData` 结构体创建 `UEveItemCfg` 实例
 	 * 
@@ -122,4 +334,22 @@ public:
 		Obj->ItemData = Data;
 		return Obj;
 	}
+
+	/**
+	 * @brief 原地更新配置（热重载）
+	 * 
+	 * 保留运行时生成的 `IconBrush`，配置对象本身不变，已有的引用和配置索引继续有效。
+	 * 
+	 * @param Data 新的物品数据
+	 * @return 配置是否发生变化
+	 */
+	bool PatchFromStruct(const FEveItemData& Data)
+	{
+		if (ItemData.HasSameCfg(Data)) return false;
+
+		const FSlateBrush IconBrush = ItemData.IconBrush;
+		ItemData = Data;
+		ItemData.IconBrush = IconBrush;
+		return true;
+	}
 };
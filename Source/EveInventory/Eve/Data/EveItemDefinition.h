@@ -0,0 +1,56 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "EveItemDefinition.generated.h"
+
+class UNiagaraSystem;
+class UStaticMesh;
+class UTexture2D;
+
+/**
+ * @brief 物品定义（主资产）
+ * 
+ * 每个物品一个资产，资源全部为软引用并按用途划分资源包（Asset Bundle）：
+ * - `UI`：图标，打开背包时只为持有的物品加载
+ * - `World`：掉落模型、掉落特效，掉落到场景时才加载
+ * 
+ * 由 `UEveAssetMgr` 按 TID 索引，通过 `LoadItemBundles` 异步加载。
+ */
+UCLASS(BlueprintType)
+class UEveItemDefinition : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** 主资产类型 */
+	static inline const FPrimaryAssetType ItemDefinitionType = FName(TEXT("EveItem"));
+
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override
+	{
+		return FPrimaryAssetId(ItemDefinitionType, GetFName());
+	}
+
+public:
+	/** 物品唯一 ID（写入资产注册表，未加载资产时即可按 TID 建立索引） */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item", AssetRegistrySearchable)
+	int32 TID = -1;
+
+	/** 物品名称 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item")
+	FString Name;
+
+	/** 物品图标 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "UI", meta = (AssetBundles = "UI"))
+	TSoftObjectPtr<UTexture2D> Icon;
+
+	/** 掉落到场景中时使用的模型 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "World", meta = (AssetBundles = "World"))
+	TSoftObjectPtr<UStaticMesh> WorldMesh;
+
+	/** 掉落到场景中时播放的特效 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "World", meta = (AssetBundles = "World"))
+	TSoftObjectPtr<UNiagaraSystem> WorldFX;
+};
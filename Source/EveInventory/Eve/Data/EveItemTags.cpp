@@ -0,0 +1,90 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#include "EveItemTags.h"
+
+#include "EveInventory/EveInventory.h"
+
+/**
+ * @brief 将物品的标签编译为掩码
+ * 
+ * 父标签一并展开，查询 `Item.Consumable` 时 `Item.Consumable.Potion` 的物品也会匹配。
+ */
+uint64 FEveItemTagIndex::Compile(const FGameplayTagContainer& Tags)
+{
+	uint64 Mask = 0;
+	for (const FGameplayTag& Tag : Tags.GetGameplayTagParents())
+	{
+		int32* Bit = TagToBit.Find(Tag);
+		if (!Bit)
+		{
+			// 第 0 位是占用位；位用完后的标签由查询退回到标签容器匹配
+			if (TagToBit.Num() >= 63)
+			{
+				if (!bOverflowed)
+				{
+					UE_LOG(LogEveInventory, Warning, TEXT("More than 63 item tags, queries using %s and later tags fall back to tag container matching"), *Tag.ToString());
+					bOverflowed = true;
+				}
+				continue;
+			}
+			Bit = &TagToBit.Add(Tag, TagToBit.Num() + 1);
+		}
+		Mask |= uint64(1) << *Bit;
+	}
+	return Mask;
+}
+
+/**
+ * @brief 编译查询条件
+ */
+FEveItemTagQuery FEveItemTagIndex::MakeQuery(const FGameplayTagContainer& AnyTags, const FGameplayTagContainer& AllTags, const FGameplayTagContainer& NoneTags) const
+{
+	FEveItemTagQuery Query;
+	int32 AnyMissingNum = 0;
+	int32 AllMissingNum = 0;
+	int32 NoneMissingNum = 0;
+
+	Query.AnyMask = GetMask(AnyTags, AnyMissingNum);
+	Query.AllMask = GetMask(AllTags, AllMissingNum) | OccupiedBit;
+	Query.NoneMask = GetMask(NoneTags, NoneMissingNum);
+
+	// 位已用完时，未分配位的标签可能被物品拥有，掩码无法表达，改为精确匹配标签容器
+	if (bOverflowed && AnyMissingNum + AllMissingNum + NoneMissingNum > 0)
+	{
+		Query.bNeedsTagFallback = true;
+		Query.AnyTags = AnyTags;
+		Query.AllTags = AllTags;
+		Query.NoneTags = NoneTags;
+		return Query;
+	}
+
+	if ((AnyTags.Num() > 0 && Query.AnyMask == 0) || AllMissingNum > 0)
+	{
+		Query.bImpossible = true;
+	}
+
+	// 不可能匹配时让 “全部” 条件恒不满足，匹配仍保持无分支
+	if (Query.bImpossible)
+	{
+		Query.AnyMask = 0;
+		Query.AllMask = ~uint64(0);
+	}
+	return Query;
+}
+
+uint64 FEveItemTagIndex::GetMask(const FGameplayTagContainer& Tags, int32& OutMissingNum) const
+{
+	uint64 Mask = 0;
+	for (const FGameplayTag& Tag : Tags)
+	{
+		if (const int32* Bit = TagToBit.Find(Tag))
+		{
+			Mask |= uint64(1) << *Bit;
+		}
+		else
+		{
+			OutMissingNum++;
+		}
+	}
+	return Mask;
+}
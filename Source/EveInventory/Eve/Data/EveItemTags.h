@@ -0,0 +1,102 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+/**
+ * @brief 编译后的物品标签查询
+ * 
+ * 三个掩码分别对应 “任一 / 全部 / 都不” 条件，匹配只是几次位运算，
+ * 对整个背包的格子标签数组逐个匹配时没有分支，便于编译器向量化。
+ */
+struct FEveItemTagQuery
+{
+	/** 至少包含其中一个标签（为 0 时不限制） */
+	uint64 AnyMask = 0;
+
+	/** 必须包含全部标签（始终包含占用位，空格子不会匹配） */
+	uint64 AllMask = 0;
+
+	/** 不能包含其中任何标签 */
+	uint64 NoneMask = 0;
+
+	/** 查询中包含没有任何物品拥有的 “全部” 标签，不可能匹配 */
+	bool bImpossible = false;
+
+	/**
+	 * 查询用到了没有分配位的标签，而索引的位已经用完（可能有物品拥有该标签），
+	 * 掩码无法表达，需要用 `MatchesTags` 对物品的标签容器精确匹配。
+	 */
+	bool bNeedsTagFallback = false;
+
+	/** 原始查询条件（只在 `bNeedsTagFallback` 时保存） */
+	FGameplayTagContainer AnyTags;
+	FGameplayTagContainer AllTags;
+	FGameplayTagContainer NoneTags;
+
+	/** @brief 格子（或物品）的标签位是否匹配 */
+	FORCEINLINE bool Matches(const uint64 Bits) const
+	{
+		return (((Bits & AnyMask) != 0) | (AnyMask == 0)) & ((Bits & AllMask) == AllMask) & ((Bits & NoneMask) == 0);
+	}
+
+	/** @brief 物品的标签容器是否匹配（父标签同样匹配子标签，与掩码的语义一致） */
+	bool MatchesTags(const FGameplayTagContainer& Tags) const
+	{
+		return (AnyTags.IsEmpty() || Tags.HasAny(AnyTags)) && Tags.HasAll(AllTags) && !Tags.HasAny(NoneTags);
+	}
+};
+
+/**
+ * @brief 物品标签位索引
+ * 
+ * 加载物品配置时为出现过的每个标签（及其父标签）分配一个位，
+ * 每个物品的 `FGameplayTagContainer` 被编译为一个 64 位掩码，查询父标签时自动匹配子标签。
+ * 第 0 位保留为 “格子有物品” 的占用位，最多为 63 个不同的标签分配位；
+ * 超出后新标签不再分配位，用到这些标签的查询退回到 `FGameplayTagContainer` 精确匹配。
+ */
+struct FEveItemTagIndex
+{
+public:
+	/** 占用位：格子中有物品 */
+	static constexpr uint64 OccupiedBit = 1;
+
+	/** 清空索引 */
+	void Reset()
+	{
+		TagToBit.Reset();
+		bOverflowed = false;
+	}
+
+	/**
+	 * @brief 将物品的标签编译为掩码，新出现的标签会分配新的位
+	 * 
+	 * @param Tags 物品的标签
+	 * @return 物品的标签掩码（包含所有父标签，不含占用位）
+	 */
+	uint64 Compile(const FGameplayTagContainer& Tags);
+
+	/**
+	 * @brief 编译查询条件
+	 * 
+	 * 没有分配位的标签说明没有任何物品拥有：在 “任一 / 都不” 中忽略，在 “全部” 中使查询不可能匹配。
+	 * 位已用完时则无法确定，查询标记为 `bNeedsTagFallback`。
+	 */
+	FEveItemTagQuery MakeQuery(const FGameplayTagContainer& AnyTags, const FGameplayTagContainer& AllTags, const FGameplayTagContainer& NoneTags) const;
+
+	/** @brief 已分配位的标签数量 */
+	int32 Num() const { return TagToBit.Num(); }
+
+private:
+	/** @brief 查询标签掩码，没有分配位的标签计入 `OutMissingNum` */
+	uint64 GetMask(const FGameplayTagContainer& Tags, int32& OutMissingNum) const;
+
+private:
+	/** 标签到位下标的映射 */
+	TMap<FGameplayTag, int32> TagToBit;
+
+	/** 是否有标签因为位已用完而没有分配位 */
+	bool bOverflowed = false;
+};
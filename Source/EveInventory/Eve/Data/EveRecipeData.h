@@ -0,0 +1,32 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataTable.h"
+#include "EveItemData.h"
+#include "EveRecipeData.generated.h"
+
+/**
+ * @brief 配方数据结构体，继承自 `FTableRowBase`
+ * 
+ * 一次制作消耗 `Inputs` 中的全部材料，产出 `Outputs` 中的全部物品。
+ */
+USTRUCT(Blueprintable, BlueprintType)
+struct FEveRecipeData : public FTableRowBase
+{
+	GENERATED_BODY()
+
+public:
+	/** 配方唯一 ID */
+	UPROPERTY(EditDefaultsOnly)
+	int32 RecipeID = -1;
+
+	/** 消耗的材料（同一 TID 出现多次时在加载时合并） */
+	UPROPERTY(EditDefaultsOnly)
+	TArray<FEveItemStack> Inputs;
+
+	/** 产出的物品 */
+	UPROPERTY(EditDefaultsOnly)
+	TArray<FEveItemStack> Outputs;
+};
@@ -0,0 +1,283 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#include "EveCraftingMgr.h"
+#include "Engine/DataTable.h"
+#include "EveInventory/EveInventory.h"
+#include "EveInventory/Eve/Asset/EveAssetMgr.h"
+#include "EveInventory/Eve/Manager/EveInventoryMgr.h"
+
+DECLARE_CYCLE_STAT(TEXT("Crafting Update"), STAT_EveCraftingUpdate, STATGROUP_EveInventory);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Craftable Recipes"), STAT_EveCraftableRecipes, STATGROUP_EveInventory);
+
+/**
+ * 初始化制作管理器，加载配方表。
+ */
+void UEveCraftingMgr::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    InventoryMgr = Collection.InitializeDependency<UEveInventoryMgr>();
+    if (!ensure(InventoryMgr)) return;
+
+    InventoryMgr->OnItemAmountChanged.AddUObject(this, &ThisClass::HandleItemAmountChanged);
+    InventoryMgr->OnInventorySlotsChanged.AddUObject(this, &ThisClass::HandleInventorySlotsChanged);
+
+    UEveAssetMgr& AssetMgr = UEveAssetMgr::Get();
+    if (!AssetMgr.DTRecipe.IsNull())
+    {
+        LoadRecipes(AssetMgr.GetAssetSync(AssetMgr.DTRecipe));
+    }
+}
+
+/**
+ * 反初始化，取消事件绑定。
+ */
+void UEveCraftingMgr::Deinitialize()
+{
+    if (InventoryMgr)
+    {
+        InventoryMgr->OnItemAmountChanged.RemoveAll(this);
+        InventoryMgr->OnInventorySlotsChanged.RemoveAll(this);
+    }
+
+    Recipes.Empty();
+    RecipeIDToIdx.Empty();
+    IngredientToRecipes.Empty();
+    MaxCrafts.Empty();
+    CraftableBits.Empty();
+    CraftableNum = 0;
+    PendingRecipeIdxes.Empty();
+    PendingBits.Empty();
+
+    Super::Deinitialize();
+}
+
+/**
+ * 加载配方并建立倒排索引。
+ */
+int32 UEveCraftingMgr::LoadRecipes(const UDataTable* DataTable)
+{
+    if (!ensure(DataTable)) return 0;
+    if (!ensure(DataTable->GetRowStruct() == FEveRecipeData::StaticStruct())) return 0;
+
+    TArray<FEveRecipeData*> Rows;
+    DataTable->GetAllRows<FEveRecipeData>(TEXT("RecipeDataContext"), Rows);
+
+    Recipes.Reset(Rows.Num());
+    RecipeIDToIdx.Reset();
+    IngredientToRecipes.Reset();
+
+    for (const FEveRecipeData* Row : Rows)
+    {
+        if (!Row || Row->Inputs.Num() == 0) continue;
+
+        // 合并重复的材料，每个材料 TID 在配方中只出现一次
+        FEveRecipeData Recipe;
+        Recipe.RecipeID = Row->RecipeID;
+        Recipe.Outputs = Row->Outputs;
+        bool bValid = true;
+        for (const FEveItemStack& Input : Row->Inputs)
+        {
+            if (Input.Amount <= 0)
+            {
+                bValid = false;
+                break;
+            }
+
+            if (FEveItemStack* Existing = Recipe.Inputs.FindByPredicate([&Input](const FEveItemStack& Stack) { return Stack.TID == Input.TID; }))
+            {
+                Existing->Amount += Input.Amount;
+            }
+            else
+            {
+                Recipe.Inputs.Add(Input);
+            }
+        }
+        if (!bValid)
+        {
+            UE_LOG(LogEveInventory, Warning, TEXT("Recipe %d has a non-positive input amount, skipped"), Row->RecipeID);
+            continue;
+        }
+
+        const int32 RecipeIdx = Recipes.Add(MoveTemp(Recipe));
+        RecipeIDToIdx.Add(Row->RecipeID, RecipeIdx);
+        for (const FEveItemStack& Input : Recipes[RecipeIdx].Inputs)
+        {
+            IngredientToRecipes.FindOrAdd(Input.TID).Add(RecipeIdx);
+        }
+    }
+
+    MaxCrafts.Init(0, Recipes.Num());
+    CraftableBits.Init(false, Recipes.Num());
+    PendingBits.Init(false, Recipes.Num());
+    PendingRecipeIdxes.Reset();
+    CraftableNum = 0;
+
+    // 首次完整计算一次，之后只按数量变化增量更新
+    for (int32 RecipeIdx = 0; RecipeIdx < Recipes.Num(); RecipeIdx++)
+    {
+        UpdateRecipe(RecipeIdx);
+    }
+    PendingRecipeIdxes.Reset();
+    PendingBits.Init(false, Recipes.Num());
+
+    UE_LOG(LogEveInventory, Log, TEXT("Loaded %d recipe(s), %d ingredient(s) indexed, %d craftable"),
+        Recipes.Num(), IngredientToRecipes.Num(), CraftableNum);
+    return Recipes.Num();
+}
+
+/**
+ * 重新计算一个配方的最大可制作次数。
+ */
+void UEveCraftingMgr::UpdateRecipe(const int32 RecipeIdx)
+{
+    int32 NewMaxCrafts = MAX_int32;
+    for (const FEveItemStack& Input : Recipes[RecipeIdx].Inputs)
+    {
+        NewMaxCrafts = FMath::Min(NewMaxCrafts, InventoryMgr->GetItemAggregate(Input.TID).Amount / Input.Amount);
+        if (NewMaxCrafts == 0) break;
+    }
+
+    if (MaxCrafts[RecipeIdx] == NewMaxCrafts) return;
+    MaxCrafts[RecipeIdx] = NewMaxCrafts;
+
+    const bool bCraftable = NewMaxCrafts > 0;
+    if (CraftableBits[RecipeIdx] != bCraftable)
+    {
+        CraftableBits[RecipeIdx] = bCraftable;
+        CraftableNum += bCraftable ? 1 : -1;
+    }
+
+    if (!PendingBits[RecipeIdx])
+    {
+        PendingBits[RecipeIdx] = true;
+        PendingRecipeIdxes.Add(RecipeIdx);
+    }
+}
+
+/**
+ * 背包中某个 TID 的数量变化，只重新计算用到该材料的配方。
+ */
+void UEveCraftingMgr::HandleItemAmountChanged(const int32 TID, const int32 OldAmount, const int32 NewAmount)
+{
+    SCOPE_CYCLE_COUNTER(STAT_EveCraftingUpdate);
+
+    const TArray<int32>* RecipeIdxes = IngredientToRecipes.Find(TID);
+    if (!RecipeIdxes) return;
+
+    for (const int32 RecipeIdx : *RecipeIdxes)
+    {
+        UpdateRecipe(RecipeIdx);
+    }
+}
+
+/**
+ * 随背包格子增量事件广播本批次的变化。
+ */
+void UEveCraftingMgr::HandleInventorySlotsChanged(const TArray<int32>& ChangedPosIdxes)
+{
+    SET_DWORD_STAT(STAT_EveCraftableRecipes, CraftableNum);
+
+    if (PendingRecipeIdxes.Num() == 0) return;
+
+    // 先清空待广播列表，回调中再次修改背包时可以继续记录
+    TArray<int32> ChangedRecipeIdxes = MoveTemp(PendingRecipeIdxes);
+    PendingRecipeIdxes.Reset();
+    for (const int32 RecipeIdx : ChangedRecipeIdxes)
+    {
+        PendingBits[RecipeIdx] = false;
+    }
+
+    OnCraftableRecipesChanged.Broadcast(ChangedRecipeIdxes);
+}
+
+/**
+ * 获取当前可以制作的所有配方。
+ */
+void UEveCraftingMgr::GetCraftableRecipes(TArray<int32>& OutRecipeIdxes) const
+{
+    OutRecipeIdxes.Reset(CraftableNum);
+    for (TConstSetBitIterator<> It(CraftableBits); It; ++It)
+    {
+        OutRecipeIdxes.Add(It.GetIndex());
+    }
+}
+
+/**
+ * 产物能否在扣除材料后放入背包。
+ * 
+ * 被完全消耗的材料会空出格子，与已有堆叠相同 TID 的产物不占用新格子。
+ */
+bool UEveCraftingMgr::CanFitOutputs(const FEveRecipeData& Recipe, const int32 Times) const
+{
+    float DeltaWeight = 0.f;
+    float DeltaVolume = 0.f;
+    int32 StackNum = InventoryMgr->GetUsedSlotNum();
+
+    auto IsConsumed = [&Recipe, Times, this](const int32 TID)
+    {
+        const FEveItemStack* Input = Recipe.Inputs.FindByPredicate([TID](const FEveItemStack& Stack) { return Stack.TID == TID; });
+        return Input && InventoryMgr->GetItemAggregate(TID).Amount == Input->Amount * Times;
+    };
+
+    for (const FEveItemStack& Input : Recipe.Inputs)
+    {
+        const UEveItemCfg* ItemCfg = InventoryMgr->GetCfgByIdx(InventoryMgr->FindCfgIdx(Input.TID));
+        if (!ensure(ItemCfg)) return false;
+
+        DeltaWeight -= Input.Amount * Times * ItemCfg->ItemData.Weight;
+        DeltaVolume -= Input.Amount * Times * ItemCfg->ItemData.Volume;
+        if (IsConsumed(Input.TID))
+        {
+            StackNum--;
+        }
+    }
+
+    TSet<int32, DefaultKeyFuncs<int32>, TInlineSetAllocator<8>> NewTIDs;
+    for (const FEveItemStack& Output : Recipe.Outputs)
+    {
+        if (Output.Amount <= 0) continue;
+
+        float Weight = 0.f;
+        float Volume = 0.f;
+        if (!InventoryMgr->FindItemFootprint(Output.TID, Weight, Volume)) return false;
+
+        DeltaWeight += Output.Amount * Times * Weight;
+        DeltaVolume += Output.Amount * Times * Volume;
+        if (!InventoryMgr->InventoryItems.Contains(Output.TID) || IsConsumed(Output.TID))
+        {
+            NewTIDs.Add(Output.TID);
+        }
+    }
+
+    return StackNum + NewTIDs.Num() <= InventoryMgr->SlotNum && InventoryMgr->FitsCapacity(DeltaWeight, DeltaVolume);
+}
+
+/**
+ * 制作配方，扣除材料与添加产物在同一个批量修改中完成。
+ */
+bool UEveCraftingMgr::Craft(const int32 RecipeIdx, const int32 Times)
+{
+    if (!Recipes.IsValidIndex(RecipeIdx) || Times <= 0) return false;
+    if (MaxCrafts[RecipeIdx] < Times) return false; // 材料不足
+
+    const FEveRecipeData& Recipe = Recipes[RecipeIdx];
+    if (!CanFitOutputs(Recipe, Times)) return false; // 产物放不下
+
+    // 校验已完成，以下步骤不会失败；整个事务只广播一次
+    FEveInventoryBatchScope Batch(InventoryMgr);
+
+    for (const FEveItemStack& Input : Recipe.Inputs)
+    {
+        ensure(InventoryMgr->RemoveItemByTID(Input.TID, Input.Amount * Times));
+    }
+
+    for (const FEveItemStack& Output : Recipe.Outputs)
+    {
+        if (Output.Amount <= 0) continue;
+        ensure(InventoryMgr->AddItemByTID(Output.TID, Output.Amount * Times));
+    }
+
+    UE_LOG(LogEveInventory, Verbose, TEXT("Crafted recipe %d x%d"), Recipe.RecipeID, Times);
+    return true;
+}
@@ -0,0 +1,146 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "EveInventory/Eve/Data/EveRecipeData.h"
+#include "EveCraftingMgr.generated.h"
+
+class UEveInventoryMgr;
+
+/**
+ * 制作管理系统，继承自 UGameInstanceSubsystem，
+ * 基于 `UEveInventoryMgr` 回答“当前可以制作哪些配方”并执行制作。
+ * 
+ * - 建立材料 TID 到配方的倒排索引，背包中某个 TID 的数量变化时只重新计算用到它的配方
+ * - 每个配方缓存最大可制作次数，可制作的配方记录在位数组中，查询与配方总数无关
+ * - 制作在一个批量修改中先扣除材料、再添加产物，背包只广播一次
+ */
+UCLASS()
+class UEveCraftingMgr : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * 初始化制作管理系统，加载配方表并建立倒排索引。
+	 */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/**
+	 * 反初始化，取消事件绑定并清理数据。
+	 */
+	virtual void Deinitialize() override;
+
+public:
+	/**
+	 * 可制作状态变化事件，参数为最大可制作次数发生变化的配方索引。
+	 * 随背包的格子增量事件一起广播，批量修改期间的变化只广播一次。
+	 */
+	DECLARE_MULTICAST_DELEGATE_OneParam(FEveOnCraftableRecipesChanged, const TArray<int32>& /* ChangedRecipeIdxes */);
+	FEveOnCraftableRecipesChanged OnCraftableRecipesChanged;
+
+public:
+	/**
+	 * 从数据表加载配方并重新计算所有配方的可制作次数。
+	 * @param DataTable 行结构为 `FEveRecipeData` 的数据表。
+	 * @return 加载的配方数量。
+	 */
+	int32 LoadRecipes(const UDataTable* DataTable);
+
+	/**
+	 * 制作配方：先完整校验（材料、产物的格子与负重），再在一个批量修改中扣除材料、添加产物。
+	 * @param RecipeIdx 配方索引。
+	 * @param Times 制作次数。
+	 * @return 是否制作成功，失败时背包保持不变。
+	 */
+	bool Craft(int32 RecipeIdx, int32 Times = 1);
+
+	/**
+	 * 获取当前可以制作的所有配方（按位遍历可制作位数组）。
+	 * @param OutRecipeIdxes 可制作的配方索引（覆盖写入）。
+	 */
+	void GetCraftableRecipes(TArray<int32>& OutRecipeIdxes) const;
+
+	/**
+	 * 配方的最大可制作次数（只考虑材料，不考虑产物能否放下）。
+	 * @param RecipeIdx 配方索引。
+	 */
+	int32 GetMaxCrafts(const int32 RecipeIdx) const
+	{
+		return MaxCrafts.IsValidIndex(RecipeIdx) ? MaxCrafts[RecipeIdx] : 0;
+	}
+
+	/** 当前可以制作的配方数量 */
+	int32 GetCraftableNum() const { return CraftableNum; }
+
+	/**
+	 * 将配方 ID 解析为配方索引。
+	 * @param RecipeID 配方唯一 ID。
+	 * @return 配方索引，不存在时返回 `INDEX_NONE`。
+	 */
+	int32 FindRecipeIdx(const int32 RecipeID) const
+	{
+		const int32* RecipeIdx = RecipeIDToIdx.Find(RecipeID);
+		return RecipeIdx ? *RecipeIdx : INDEX_NONE;
+	}
+
+	/**
+	 * 通过配方索引获取配方数据。
+	 * @param RecipeIdx 配方索引。
+	 * @return 配方数据，索引无效时返回 nullptr。
+	 */
+	const FEveRecipeData* GetRecipe(const int32 RecipeIdx) const
+	{
+		return Recipes.IsValidIndex(RecipeIdx) ? &Recipes[RecipeIdx] : nullptr;
+	}
+
+private:
+	/**
+	 * 按背包中的材料数量重新计算一个配方的最大可制作次数，变化时记录到待广播列表。
+	 */
+	void UpdateRecipe(int32 RecipeIdx);
+
+	/**
+	 * 产物能否在扣除材料后放入背包（格子数量、负重与体积）。
+	 */
+	bool CanFitOutputs(const FEveRecipeData& Recipe, int32 Times) const;
+
+	/**
+	 * 背包中某个 TID 的数量变化：只重新计算用到该材料的配方。
+	 */
+	void HandleItemAmountChanged(int32 TID, int32 OldAmount, int32 NewAmount);
+
+	/**
+	 * 背包格子增量事件：广播本批次中可制作次数发生变化的配方。
+	 */
+	void HandleInventorySlotsChanged(const TArray<int32>& ChangedPosIdxes);
+
+private:
+	/** 背包管理子系统（初始化时缓存） */
+	UPROPERTY()
+	TObjectPtr<UEveInventoryMgr> InventoryMgr;
+
+	/** 所有配方，下标即配方索引 */
+	TArray<FEveRecipeData> Recipes;
+
+	/** 配方 ID 到配方索引的映射 */
+	TMap<int32, int32> RecipeIDToIdx;
+
+	/** 倒排索引：材料 TID 到用到该材料的配方索引 */
+	TMap<int32, TArray<int32>> IngredientToRecipes;
+
+	/** 每个配方的最大可制作次数 */
+	TArray<int32> MaxCrafts;
+
+	/** 可制作的配方（最大可制作次数大于 0） */
+	TBitArray<> CraftableBits;
+
+	/** 可制作的配方数量 */
+	int32 CraftableNum = 0;
+
+	/** 本批次中可制作次数发生变化、尚未广播的配方（位数组去重） */
+	TArray<int32> PendingRecipeIdxes;
+	TBitArray<> PendingBits;
+};
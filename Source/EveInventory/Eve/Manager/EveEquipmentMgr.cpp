@@ -0,0 +1,223 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#include "EveEquipmentMgr.h"
+#include "EveInventory/EveInventory.h"
+#include "EveInventory/Eve/Manager/EveInventoryMgr.h"
+
+static_assert(static_cast<int32>(EEveStatChannel::Num) <= 32, "Stat channel mask is a uint32");
+
+/**
+ * 初始化装备管理器。
+ */
+void UEveEquipmentMgr::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    InventoryMgr = Collection.InitializeDependency<UEveInventoryMgr>();
+    if (!ensure(InventoryMgr)) return;
+
+    InventoryMgr->OnItemCfgsChanged.AddUObject(this, &ThisClass::HandleItemCfgsChanged);
+
+    SlotLayout = { EEveEquipSlot::Head, EEveEquipSlot::Chest, EEveEquipSlot::Weapon, EEveEquipSlot::Ring, EEveEquipSlot::Ring };
+    EquippedTIDs.Init(-1, SlotLayout.Num());
+    EquippedCfgIdxes.Init(INDEX_NONE, SlotLayout.Num());
+}
+
+/**
+ * 反初始化，取消事件绑定。
+ */
+void UEveEquipmentMgr::Deinitialize()
+{
+    if (InventoryMgr)
+    {
+        InventoryMgr->OnItemCfgsChanged.RemoveAll(this);
+    }
+
+    Super::Deinitialize();
+}
+
+/**
+ * 从背包中装备一件物品。
+ */
+bool UEveEquipmentMgr::Equip(const int32 TID, int32 EquipIdx)
+{
+    const int32 CfgIdx = InventoryMgr->FindCfgIdx(TID);
+    const UEveItemCfg* ItemCfg = InventoryMgr->GetCfgByIdx(CfgIdx);
+    if (!ItemCfg || ItemCfg->ItemData.EquipSlot == EEveEquipSlot::None) return false; // 不可装备
+    if (InventoryMgr->GetItemAggregate(TID).Amount < 1) return false; // 背包中没有该物品
+
+    // 未指定装备槽时优先选择同类型的空槽，没有空槽时与第一个同类型的槽交换
+    if (EquipIdx == INDEX_NONE)
+    {
+        for (int32 Idx = 0; Idx < SlotLayout.Num(); Idx++)
+        {
+            if (SlotLayout[Idx] != ItemCfg->ItemData.EquipSlot) continue;
+            if (EquipIdx == INDEX_NONE || EquippedTIDs[Idx] == -1)
+            {
+                EquipIdx = Idx;
+            }
+            if (EquippedTIDs[Idx] == -1) break;
+        }
+    }
+    if (!SlotLayout.IsValidIndex(EquipIdx) || SlotLayout[EquipIdx] != ItemCfg->ItemData.EquipSlot) return false;
+
+    const int32 OldTID = EquippedTIDs[EquipIdx];
+    if (OldTID == TID) return true;
+
+    // 先完整校验背包能否接收换下的装备（装备的物品离开背包后可能空出格子、减轻负重）
+    const UEveItemCfg* OldItemCfg = InventoryMgr->GetCfgByIdx(EquippedCfgIdxes[EquipIdx]);
+    if (OldTID != -1)
+    {
+        if (!ensure(OldItemCfg)) return false;
+
+        const bool bFreesSlot = InventoryMgr->GetItemAggregate(TID).Amount == 1;
+        const bool bNeedsSlot = !InventoryMgr->InventoryItems.Contains(OldTID);
+        if (InventoryMgr->GetUsedSlotNum() - (bFreesSlot ? 1 : 0) + (bNeedsSlot ? 1 : 0) > InventoryMgr->SlotNum) return false;
+        if (!InventoryMgr->FitsCapacity(OldItemCfg->ItemData.Weight - ItemCfg->ItemData.Weight,
+            OldItemCfg->ItemData.Volume - ItemCfg->ItemData.Volume)) return false;
+    }
+
+    {
+        // 背包只广播一次
+        FEveInventoryBatchScope Batch(InventoryMgr);
+        ensure(InventoryMgr->RemoveItemByTID(TID, 1));
+        if (OldTID != -1)
+        {
+            ensure(InventoryMgr->AddItemByTID(OldTID, 1));
+        }
+    }
+
+    EquippedTIDs[EquipIdx] = TID;
+    EquippedCfgIdxes[EquipIdx] = CfgIdx;
+
+    // 只标脏换上与换下的装备涉及的通道
+    MarkStatsDirty(OldItemCfg);
+    MarkStatsDirty(ItemCfg);
+
+    OnEquipmentChanged.Broadcast(EquipIdx);
+    BroadcastStatsDirty();
+    return true;
+}
+
+/**
+ * 卸下装备并放回背包。
+ */
+bool UEveEquipmentMgr::Unequip(const int32 EquipIdx)
+{
+    const int32 OldTID = GetEquippedTID(EquipIdx);
+    if (OldTID == -1) return false;
+
+    if (!InventoryMgr->CanAddItem(OldTID, 1)) return false; // 背包放不下
+    if (!ensure(InventoryMgr->AddItemByTID(OldTID, 1))) return false;
+
+    const UEveItemCfg* OldItemCfg = InventoryMgr->GetCfgByIdx(EquippedCfgIdxes[EquipIdx]);
+    EquippedTIDs[EquipIdx] = -1;
+    EquippedCfgIdxes[EquipIdx] = INDEX_NONE;
+
+    MarkStatsDirty(OldItemCfg);
+
+    OnEquipmentChanged.Broadcast(EquipIdx);
+    BroadcastStatsDirty();
+    return true;
+}
+
+/**
+ * 获取汇总后的属性值，通道为脏时才重新计算。
+ */
+float UEveEquipmentMgr::GetStat(const EEveStatChannel Channel)
+{
+    const int32 ChannelIdx = static_cast<int32>(Channel);
+    if (!ensure(ChannelIdx >= 0 && ChannelIdx < StatChannelNum)) return 0.f;
+
+    if (DirtyChannels & (1u << ChannelIdx))
+    {
+        RecomputeStat(ChannelIdx);
+    }
+    return CachedStats[ChannelIdx];
+}
+
+/**
+ * 设置属性的基础值。
+ */
+void UEveEquipmentMgr::SetBaseStat(const EEveStatChannel Channel, const float Value)
+{
+    const int32 ChannelIdx = static_cast<int32>(Channel);
+    if (!ensure(ChannelIdx >= 0 && ChannelIdx < StatChannelNum)) return;
+    if (BaseStats[ChannelIdx] == Value) return;
+
+    BaseStats[ChannelIdx] = Value;
+    DirtyChannels |= 1u << ChannelIdx;
+    PendingDirtyChannels |= 1u << ChannelIdx;
+    BroadcastStatsDirty();
+}
+
+/**
+ * 将物品配置中涉及的属性通道标脏。
+ */
+void UEveEquipmentMgr::MarkStatsDirty(const UEveItemCfg* ItemCfg)
+{
+    if (!ItemCfg) return;
+
+    for (const FEveStatModifier& Modifier : ItemCfg->ItemData.StatModifiers)
+    {
+        const uint32 Bit = 1u << static_cast<int32>(Modifier.Channel);
+        DirtyChannels |= Bit;
+        PendingDirtyChannels |= Bit;
+    }
+}
+
+/**
+ * 重新计算一个属性通道：基础值加上所有装备在该通道上的加成。
+ */
+void UEveEquipmentMgr::RecomputeStat(const int32 ChannelIdx)
+{
+    const EEveStatChannel Channel = static_cast<EEveStatChannel>(ChannelIdx);
+
+    float Value = BaseStats[ChannelIdx];
+    for (const int32 CfgIdx : EquippedCfgIdxes)
+    {
+        const UEveItemCfg* ItemCfg = InventoryMgr->GetCfgByIdx(CfgIdx);
+        if (!ItemCfg) continue;
+
+        for (const FEveStatModifier& Modifier : ItemCfg->ItemData.StatModifiers)
+        {
+            if (Modifier.Channel == Channel)
+            {
+                Value += Modifier.Value;
+            }
+        }
+    }
+
+    CachedStats[ChannelIdx] = Value;
+    DirtyChannels &= ~(1u << ChannelIdx);
+}
+
+/**
+ * 物品配置热重载，已装备物品的旧加成已被覆盖，无法得知涉及哪些通道，全部标脏。
+ */
+void UEveEquipmentMgr::HandleItemCfgsChanged(const TArray<int32>& ChangedTIDs)
+{
+    for (const int32 TID : ChangedTIDs)
+    {
+        if (EquippedTIDs.Contains(TID))
+        {
+            const uint32 AllChannels = (1u << StatChannelNum) - 1;
+            DirtyChannels |= AllChannels;
+            PendingDirtyChannels |= AllChannels;
+            BroadcastStatsDirty();
+            return;
+        }
+    }
+}
+
+/**
+ * 广播本次操作产生的脏通道。
+ */
+void UEveEquipmentMgr::BroadcastStatsDirty()
+{
+    if (PendingDirtyChannels == 0) return;
+
+    const uint32 ChannelMask = PendingDirtyChannels;
+    PendingDirtyChannels = 0;
+    OnStatsDirty.Broadcast(ChannelMask);
+}
@@ -0,0 +1,142 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "EveInventory/Eve/Data/EveItemData.h"
+#include "EveEquipmentMgr.generated.h"
+
+class UEveInventoryMgr;
+
+/**
+ * 装备管理系统，继承自 UGameInstanceSubsystem，
+ * 负责装备槽与背包之间的物品移动，以及装备提供的角色属性汇总。
+ * 
+ * - 装备 / 卸下是原子的移动：先完整校验背包能否接收换下的装备，再在一个批量修改中完成
+ * - 每个属性通道独立缓存，装备变化只将该装备涉及的通道标脏，读取时才重新计算脏通道
+ * - 没有变化时读取属性只是一次数组访问
+ */
+UCLASS()
+class UEveEquipmentMgr : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * 初始化装备管理系统，建立默认的装备槽布局。
+	 */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/**
+	 * 反初始化，取消事件绑定。
+	 */
+	virtual void Deinitialize() override;
+
+public:
+	/**
+	 * 装备变化事件，参数为发生变化的装备槽索引。
+	 */
+	DECLARE_MULTICAST_DELEGATE_OneParam(FEveOnEquipmentChanged, int32 /* EquipIdx */);
+	FEveOnEquipmentChanged OnEquipmentChanged;
+
+	/**
+	 * 属性标脏事件，参数为被标脏的通道掩码（第 N 位对应 `EEveStatChannel` 的第 N 个通道）。
+	 * 只需要关心部分通道的监听者可据此跳过无关的变化。
+	 */
+	DECLARE_MULTICAST_DELEGATE_OneParam(FEveOnStatsDirty, uint32 /* ChannelMask */);
+	FEveOnStatsDirty OnStatsDirty;
+
+public:
+	/**
+	 * 从背包中装备一件物品，目标槽已有装备时与其交换（换下的装备放回背包）。
+	 * @param TID 物品的唯一 ID（背包中必须有该物品）。
+	 * @param EquipIdx 目标装备槽索引，默认为 `INDEX_NONE`，表示优先选择同类型的空槽。
+	 * @return 是否装备成功，失败时背包与装备均保持不变。
+	 */
+	bool Equip(int32 TID, int32 EquipIdx = INDEX_NONE);
+
+	/**
+	 * 卸下装备并放回背包。
+	 * @param EquipIdx 装备槽索引。
+	 * @return 是否卸下成功，背包放不下时保持不变。
+	 */
+	bool Unequip(int32 EquipIdx);
+
+	/**
+	 * 获取装备槽中的物品 TID。
+	 * @param EquipIdx 装备槽索引。
+	 * @return 物品 TID，槽为空或越界时返回 -1。
+	 */
+	int32 GetEquippedTID(const int32 EquipIdx) const
+	{
+		return EquippedTIDs.IsValidIndex(EquipIdx) ? EquippedTIDs[EquipIdx] : -1;
+	}
+
+	/** 装备槽的类型布局，下标即装备槽索引 */
+	const TArray<EEveEquipSlot>& GetSlotLayout() const { return SlotLayout; }
+
+	/**
+	 * 获取汇总后的属性值（基础值 + 所有装备加成），通道为脏时才重新计算该通道。
+	 * @param Channel 属性通道。
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Equipment")
+	float GetStat(EEveStatChannel Channel);
+
+	/**
+	 * 设置属性的基础值，只将该通道标脏。
+	 * @param Channel 属性通道。
+	 * @param Value 基础值。
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Equipment")
+	void SetBaseStat(EEveStatChannel Channel, float Value);
+
+private:
+	/**
+	 * 将物品配置中涉及的属性通道标脏。
+	 */
+	void MarkStatsDirty(const UEveItemCfg* ItemCfg);
+
+	/**
+	 * 重新计算一个属性通道。
+	 */
+	void RecomputeStat(int32 ChannelIdx);
+
+	/**
+	 * 物品配置热重载：已装备物品的加成可能变化，将所有通道标脏。
+	 */
+	void HandleItemCfgsChanged(const TArray<int32>& ChangedTIDs);
+
+	/**
+	 * 广播本次操作产生的脏通道。
+	 */
+	void BroadcastStatsDirty();
+
+private:
+	static constexpr int32 StatChannelNum = static_cast<int32>(EEveStatChannel::Num);
+
+	/** 背包管理子系统（初始化时缓存） */
+	UPROPERTY()
+	TObjectPtr<UEveInventoryMgr> InventoryMgr;
+
+	/** 装备槽的类型布局（两个戒指槽） */
+	TArray<EEveEquipSlot> SlotLayout;
+
+	/** 每个装备槽中的物品 TID（-1 表示为空） */
+	TArray<int32> EquippedTIDs;
+
+	/** 每个装备槽中物品的配置索引 */
+	TArray<int32> EquippedCfgIdxes;
+
+	/** 属性基础值 */
+	float BaseStats[StatChannelNum] = {};
+
+	/** 缓存的属性汇总值 */
+	float CachedStats[StatChannelNum] = {};
+
+	/** 需要重新计算的属性通道掩码 */
+	uint32 DirtyChannels = 0;
+
+	/** 尚未广播的脏通道掩码 */
+	uint32 PendingDirtyChannels = 0;
+};
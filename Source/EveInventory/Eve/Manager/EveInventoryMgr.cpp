@@ -1,8 +1,84 @@
 ﻿// Copyright Night Gamer, Inc. All Rights Reserved.
 
 #include "EveInventoryMgr.h"
+#include "Dom/JsonObject.h"
 #include "Engine/DataTable.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "EveInventory/EveInventory.h"
 #include "EveInventory/Eve/Asset/EveAssetMgr.h"
+#include "EveInventory/Eve/Manager/EveInventoryOpLog.h"
+#include "Engine/Texture2D.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Serialization/Csv/CsvParser.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "UObject/UObjectArray.h"
+
+static FAutoConsoleCommandWithWorldAndArgs GEveReloadItemCfgsCmd(
+    TEXT("Eve.ReloadItemCfgs"),
+    TEXT("Hot reload item configs. Usage: Eve.ReloadItemCfgs [OverrideFile.csv|.json] (no argument: reload DTItem)"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+        UEveInventoryMgr* InventoryMgr = GameInstance ? GameInstance->GetSubsystem<UEveInventoryMgr>() : nullptr;
+        if (!InventoryMgr) return;
+
+        if (Args.Num() > 0)
+        {
+            InventoryMgr->ReloadItemCfgsFromFile(Args[0]);
+        }
+        else
+        {
+            InventoryMgr->ReloadItemCfgs(UEveAssetMgr::Get().GetAssetSync(UEveAssetMgr::Get().DTItem));
+        }
+    }));
+
+static FAutoConsoleCommandWithWorldAndArgs GEveImportItemCatalogCmd(
+    TEXT("Eve.ImportItemCatalog"),
+    TEXT("Stream an external item catalog CSV into the inventory. Usage: Eve.ImportItemCatalog <File.csv>"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+        UEveInventoryMgr* InventoryMgr = GameInstance ? GameInstance->GetSubsystem<UEveInventoryMgr>() : nullptr;
+        if (!InventoryMgr || Args.Num() < 1) return;
+
+        InventoryMgr->ImportItemCatalog(Args[0]);
+    }));
+
+static FAutoConsoleCommand GEveCookItemCatalogCmd(
+    TEXT("Eve.CookItemCatalog"),
+    TEXT("Cook DTItem (or a catalog CSV) into the flat binary item catalog. Usage: Eve.CookItemCatalog [In.csv] [Out.evecat]"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        FEveItemCatalog Catalog;
+        FString Error;
+        if (Args.Num() > 0)
+        {
+            if (!Catalog.ImportCSV(Args[0], &Error))
+            {
+                UE_LOG(LogEveInventory, Warning, TEXT("Failed to read %s: %s"), *Args[0], *Error);
+                return;
+            }
+        }
+        else if (const UDataTable* DataTable = UEveAssetMgr::Get().GetAssetSync(UEveAssetMgr::Get().DTItem))
+        {
+            DataTable->ForeachRow<FEveItemData>(TEXT("CookItemCatalog"), [&Catalog](const FName&, const FEveItemData& Row)
+            {
+                Catalog.AddItemData(Row);
+            });
+        }
+
+        const FString OutPath = Args.Num() > 1 ? Args[1] : UEveInventoryMgr::GetCookedItemCatalogPath();
+        if (!FEveItemCatalogFile::Write(Catalog, OutPath, &Error))
+        {
+            UE_LOG(LogEveInventory, Warning, TEXT("Failed to cook item catalog: %s"), *Error);
+            return;
+        }
+        UE_LOG(LogEveInventory, Display, TEXT("Cooked %d item(s) to %s"), Catalog.Num(), *OutPath);
+    }));
 
 /**
  * 初始化库存管理器，加载物品数据表。
@@ -12,16 +88,349 @@ void UEveInventoryMgr::Initialize(FSubsystemCollectionBase& Collection)
     Super::Initialize(Collection);
 
     // 获取物品数据表
-    const UDataTable* DataTable = UEveAssetMgr::Get().GetAssetSync(UEveAssetMgr::Get().DTItem);
+    UDataTable* DataTable = UEveAssetMgr::Get().GetAssetSync(UEveAssetMgr::Get().DTItem);
     TArray<FEveItemData*> AllFItemsCfg;
     DataTable->GetAllRows<FEveItemData>(TEXT("ItemDataContext"), AllFItemsCfg);
 
-    // 将数据表中的数据存入 AllItemsCfg
+    // 将数据表中的数据存入 AllItemsCfg，并建立稠密的配置索引
+    ItemCfgs.Reserve(AllFItemsCfg.Num());
     for (const FEveItemData* FItemData : AllFItemsCfg)
     {
         if (!ensure(FItemData)) return;
-        AllItemsCfg.Add(FItemData->TID, UEveItemCfg::CreateFromStruct(*FItemData));
+        UEveItemCfg* ItemCfg = UEveItemCfg::CreateFromStruct(*FItemData);
+        CompileItemTags(ItemCfg);
+        AllItemsCfg.Add(FItemData->TID, ItemCfg);
+        TIDToCfgIdx.Add(FItemData->TID, ItemCfgs.Add(ItemCfg));
+    }
+
+    SlotItems.SetNum(SlotNum);
+    SlotTagBits.Init(0, SlotNum);
+
+    // 映射烘焙的二进制物品目录（只校验文件头，与行数无关）
+    const FString CookedCatalogPath = GetCookedItemCatalogPath();
+    if (FPaths::FileExists(CookedCatalogPath))
+    {
+        FString Error;
+        if (CookedItemCatalog.Open(CookedCatalogPath, &Error))
+        {
+            UE_LOG(LogEveInventory, Log, TEXT("Mapped cooked item catalog: %d row(s)"), CookedItemCatalog.Num());
+        }
+        else
+        {
+            UE_LOG(LogEveInventory, Warning, TEXT("Failed to open cooked item catalog: %s"), *Error);
+        }
+    }
+
+    // 监听数据表修改（编辑器中编辑或重新导入）
+    ItemDataTable = DataTable;
+    DataTable->OnDataTableChanged().AddUObject(this, &ThisClass::HandleDataTableChanged);
+
+#if !UE_BUILD_SHIPPING
+    // 定期检查运行时覆盖文件
+    ItemOverrideWatchHandle = FTSTicker::GetCoreTicker().AddTicker(
+        FTickerDelegate::CreateUObject(this, &ThisClass::TickItemOverrideWatch), ItemOverridePollInterval);
+#endif
+}
+
+/**
+ * 热重载物品配置，只原地更新发生变化的配置。
+ */
+int32 UEveInventoryMgr::ReloadItemCfgs(const UDataTable* DataTable, const bool bFullTable)
+{
+    if (!ensure(DataTable)) return 0;
+    if (!ensure(DataTable->GetRowStruct() == FEveItemData::StaticStruct())) return 0;
+
+    TArray<FEveItemData*> Rows;
+    DataTable->GetAllRows<FEveItemData>(TEXT("ItemDataReload"), Rows);
+
+    TArray<int32> ChangedTIDs;
+    TSet<int32> SeenTIDs;
+    SeenTIDs.Reserve(Rows.Num());
+
+    for (const FEveItemData* Row : Rows)
+    {
+        if (!Row) continue;
+        SeenTIDs.Add(Row->TID);
+
+        const int32 CfgIdx = FindCfgIdx(Row->TID);
+        if (UEveItemCfg* ItemCfg = GetCfgByIdx(CfgIdx))
+        {
+            // 已有配置：内容变化时原地更新
+            if (ItemCfg->PatchFromStruct(*Row))
+            {
+                CompileItemTags(ItemCfg);
+                ChangedTIDs.Add(Row->TID);
+            }
+        }
+        else
+        {
+            // 新增配置：追加到稠密数组末尾，不影响已有的配置索引
+            UEveItemCfg* NewItemCfg = UEveItemCfg::CreateFromStruct(*Row);
+            CompileItemTags(NewItemCfg);
+            AllItemsCfg.Add(Row->TID, NewItemCfg);
+            TIDToCfgIdx.Add(Row->TID, ItemCfgs.Add(NewItemCfg));
+            ChangedTIDs.Add(Row->TID);
+        }
+    }
+
+    // 删除的行：保留配置，避免背包中的物品失去配置
+    if (bFullTable && SeenTIDs.Num() < TIDToCfgIdx.Num())
+    {
+        for (const TPair<int32, int32>& Pair : TIDToCfgIdx)
+        {
+            if (!SeenTIDs.Contains(Pair.Key))
+            {
+                UE_LOG(LogEveInventory, Warning, TEXT("Item %d was removed from the data table, keeping its config"), Pair.Key);
+            }
+        }
+    }
+
+    UE_LOG(LogEveInventory, Log, TEXT("Item configs reloaded: %d of %d row(s) changed"), ChangedTIDs.Num(), Rows.Num());
+
+    // 重量、价值、标签可能变化，只重新计算变化的物品
+    for (const int32 TID : ChangedTIDs)
+    {
+        RefreshItemAggregate(TID);
+        if (const TObjectPtr<UEveInventoryItem>* Item = InventoryItems.Find(TID); Item && *Item)
+        {
+            SlotTagBits[(*Item)->PosIdx] = GetSlotTagBits(*Item);
+        }
+    }
+
+    if (ChangedTIDs.Num() > 0)
+    {
+        OnItemCfgsChanged.Broadcast(ChangedTIDs);
+    }
+    return ChangedTIDs.Num();
+}
+
+/**
+ * 解析配置索引，必要时从外部物品目录生成物品配置。
+ */
+int32 UEveInventoryMgr::ResolveCfgIdx(const int32 TID)
+{
+    const int32 CfgIdx = FindCfgIdx(TID);
+    if (CfgIdx != INDEX_NONE) return CfgIdx;
+
+    FEveItemCatalogRow Row;
+    if (!FindCatalogRow(TID, Row)) return INDEX_NONE;
+
+    // 按需生成物品配置：只有真正进入背包的物品才会占用 UObject，图标与模型只保存软引用，由 UI / 掉落物异步加载
+    FEveItemData ItemData;
+    FEveItemCatalog::MakeItemData(Row, ItemData);
+
+    UEveItemCfg* ItemCfg = UEveItemCfg::CreateFromStruct(ItemData);
+    CompileItemTags(ItemCfg);
+    AllItemsCfg.Add(TID, ItemCfg);
+    const int32 NewCfgIdx = ItemCfgs.Add(ItemCfg);
+    TIDToCfgIdx.Add(TID, NewCfgIdx);
+
+    // 复用热重载事件，UI 为新物品追加图集格子
+    OnItemCfgsChanged.Broadcast({ TID });
+    return NewCfgIdx;
+}
+
+/**
+ * 查询单个物品的重量与体积（不生成物品配置）。
+ */
+bool UEveInventoryMgr::FindItemFootprint(const int32 TID, float& OutWeight, float& OutVolume) const
+{
+    if (const UEveItemCfg* ItemCfg = GetCfgByIdx(FindCfgIdx(TID)))
+    {
+        OutWeight = ItemCfg->ItemData.Weight;
+        OutVolume = ItemCfg->ItemData.Volume;
+        return true;
+    }
+
+    FEveItemCatalogRow Row;
+    if (!FindCatalogRow(TID, Row)) return false;
+
+    OutWeight = Row.Weight;
+    OutVolume = Row.Volume;
+    return true;
+}
+
+/**
+ * 在外部物品目录中查找物品：先查导入的物品目录，再查烘焙的二进制目录（映射内存中原地查询）。
+ */
+bool UEveInventoryMgr::FindCatalogRow(const int32 TID, FEveItemCatalogRow& OutRow) const
+{
+    if (const int32 Row = ItemCatalog.FindRow(TID); Row != INDEX_NONE)
+    {
+        OutRow = ItemCatalog.GetRow(Row);
+        return true;
+    }
+    if (const int32 CookedRow = CookedItemCatalog.FindRow(TID); CookedRow != INDEX_NONE)
+    {
+        OutRow = CookedItemCatalog.GetRow(CookedRow);
+        return true;
+    }
+    if (const UEveInventoryMgr* Source = CatalogSource.Get())
+    {
+        return Source->FindCatalogRow(TID, OutRow);
+    }
+    return false;
+}
+
+/**
+ * 烘焙的二进制物品目录路径。
+ */
+FString UEveInventoryMgr::GetCookedItemCatalogPath()
+{
+    return FPaths::ProjectContentDir() / TEXT("Eve/ItemCatalog.") + FEveItemCatalogFile::Extension;
+}
+
+/**
+ * 从外部 CSV 物品目录导入物品。
+ */
+bool UEveInventoryMgr::ImportItemCatalog(const FString& FilePath)
+{
+    const double StartTime = FPlatformTime::Seconds();
+
+    FString Error;
+    if (!ItemCatalog.ImportCSV(FilePath, &Error))
+    {
+        UE_LOG(LogEveInventory, Warning, TEXT("Failed to import item catalog %s: %s"), *FilePath, *Error);
+        return false;
+    }
+
+    UE_LOG(LogEveInventory, Log, TEXT("Imported item catalog %s: %d row(s), %.2f MB in %.2f ms"), *FilePath,
+        ItemCatalog.Num(), ItemCatalog.GetAllocatedSize() / (1024.0 * 1024.0), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+    return true;
+}
+
+/**
+ * 读取覆盖文件中每一行实际提供的列（CSV 所有行共用表头，JSON 每行可以不同）。
+ */
+static void GetItemOverrideColumns(const FString& FileContent, const bool bCSV,
+    TArray<const FProperty*>& OutCSVColumns, TMap<FName, TArray<const FProperty*>>& OutJSONColumns)
+{
+    const UScriptStruct* RowStruct = FEveItemData::StaticStruct();
+    if (bCSV)
+    {
+        const FCsvParser Parser(FileContent);
+        const FCsvParser::FRows& CSVRows = Parser.GetRows();
+        if (CSVRows.Num() == 0) return;
+
+        // 第一列为行名
+        for (int32 Col = 1; Col < CSVRows[0].Num(); Col++)
+        {
+            if (const FProperty* Property = RowStruct->FindPropertyByName(FName(CSVRows[0][Col])))
+            {
+                OutCSVColumns.Add(Property);
+            }
+        }
+        return;
+    }
+
+    TArray<TSharedPtr<FJsonValue>> JSONRows;
+    if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(FileContent), JSONRows)) return;
+
+    for (const TSharedPtr<FJsonValue>& JSONRow : JSONRows)
+    {
+        const TSharedPtr<FJsonObject>* RowObject = nullptr;
+        FString RowName;
+        if (!JSONRow.IsValid() || !JSONRow->TryGetObject(RowObject) || !(*RowObject)->TryGetStringField(TEXT("Name"), RowName)) continue;
+
+        TArray<const FProperty*>& Columns = OutJSONColumns.Add(FName(RowName));
+        for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : (*RowObject)->Values)
+        {
+            // 行名键 `Name` 与 `FEveItemData::Name` 同名，导入时行名会被写进 Name，不能当作覆盖列合并
+            if (Field.Key == TEXT("Name")) continue;
+
+            if (const FProperty* Property = RowStruct->FindPropertyByName(FName(Field.Key)))
+            {
+                Columns.Add(Property);
+            }
+        }
+    }
+}
+
+/**
+ * 从 CSV / JSON 覆盖文件热重载物品配置。
+ */
+bool UEveInventoryMgr::ReloadItemCfgsFromFile(const FString& FilePath)
+{
+    FString FileContent;
+    if (!FFileHelper::LoadFileToString(FileContent, *FilePath))
+    {
+        UE_LOG(LogEveInventory, Warning, TEXT("Failed to read item override file %s"), *FilePath);
+        return false;
+    }
+
+    UDataTable* OverrideTable = NewObject<UDataTable>(GetTransientPackage());
+    OverrideTable->RowStruct = FEveItemData::StaticStruct();
+
+    const bool bCSV = FPaths::GetExtension(FilePath).Equals(TEXT("csv"), ESearchCase::IgnoreCase);
+    const TArray<FString> Problems = bCSV
+        ? OverrideTable->CreateTableFromCSVString(FileContent)
+        : OverrideTable->CreateTableFromJSONString(FileContent);
+    for (const FString& Problem : Problems)
+    {
+        UE_LOG(LogEveInventory, Warning, TEXT("%s: %s"), *FilePath, *Problem);
+    }
+
+    // 只合并覆盖行中实际提供的列，缺少的列（如 `Icon`、`WorldMesh`）保留当前配置的值；
+    // 新增物品使用整行，缺少 `TID` 列的行无法定位物品，直接拒绝
+    TArray<const FProperty*> CSVColumns;
+    TMap<FName, TArray<const FProperty*>> JSONColumns;
+    GetItemOverrideColumns(FileContent, bCSV, CSVColumns, JSONColumns);
+    const FProperty* TIDProperty = FEveItemData::StaticStruct()->FindPropertyByName(GET_MEMBER_NAME_CHECKED(FEveItemData, TID));
+
+    TArray<FName> RejectedRows;
+    for (const TPair<FName, uint8*>& Pair : OverrideTable->GetRowMap())
+    {
+        const TArray<const FProperty*>* Columns = bCSV ? &CSVColumns : JSONColumns.Find(Pair.Key);
+        if (!Columns || !Columns->Contains(TIDProperty))
+        {
+            UE_LOG(LogEveInventory, Warning, TEXT("%s: row %s has no TID column, skipped"), *FilePath, *Pair.Key.ToString());
+            RejectedRows.Add(Pair.Key);
+            continue;
+        }
+
+        FEveItemData& Row = *reinterpret_cast<FEveItemData*>(Pair.Value);
+        const UEveItemCfg* ItemCfg = GetCfgByIdx(FindCfgIdx(Row.TID));
+        if (!ItemCfg) continue;
+
+        FEveItemData Merged = ItemCfg->ItemData;
+        for (const FProperty* Property : *Columns)
+        {
+            Property->CopyCompleteValue_InContainer(&Merged, &Row);
+        }
+        Row = Merged;
+    }
+    for (const FName RowName : RejectedRows)
+    {
+        OverrideTable->RemoveRow(RowName);
+    }
+
+    ReloadItemCfgs(OverrideTable, false);
+    return true;
+}
+
+/**
+ * 编辑器中数据表被修改或重新导入时热重载。
+ */
+void UEveInventoryMgr::HandleDataTableChanged()
+{
+    if (const UDataTable* DataTable = ItemDataTable.Get())
+    {
+        ReloadItemCfgs(DataTable);
+    }
+}
+
+/**
+ * 定期检查覆盖文件，修改时间变化时热重载。
+ */
+bool UEveInventoryMgr::TickItemOverrideWatch(float DeltaTime)
+{
+    const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp(*ItemOverridePath);
+    if (TimeStamp != FDateTime::MinValue() && TimeStamp != ItemOverrideTimeStamp)
+    {
+        ItemOverrideTimeStamp = TimeStamp;
+        ReloadItemCfgsFromFile(ItemOverridePath);
     }
+    return true;
 }
 
 /**
@@ -50,11 +459,12 @@ void UEveInventoryMgr::InventoryTestAddBtn()
     if (!ensure(AllItemsCfg.Contains(SelectedTID))) return;
     Item->ItemCfg = AllItemsCfg[SelectedTID];
 
-    // 添加到集合
+    AddItem(Item);
+
+    // 只有真正添加成功（如未超出负重）才记录，保证移除按钮与背包一致
+    if (!InventoryItems.Contains(SelectedTID)) return;
     AddedItemsSet.Add(SelectedTID);
     AddedItemsStack.Push(SelectedTID);
-
-    AddItem(Item);
 }
 
 /**
@@ -76,27 +486,40 @@ void UEveInventoryMgr::InventoryTestRemoveBtn()
 void UEveInventoryMgr::AddItem(const TObjectPtr<UEveItem> Item, const int32 PosIdx)
 {
     if (!ensure(Item)) return;
-    if (!ensure(InventoryItems.Num() < SlotNum)) return; // 背包容量限制
+    if (!ensure(GetUsedSlotNum() < SlotNum)) return; // 背包容量限制
+
+    AddItemByTID(Item->TID, 1, PosIdx);
+}
 
-    int32 TID = Item->TID;
+/**
+ * 按 TID 添加指定数量的物品。
+ */
+bool UEveInventoryMgr::AddItemByTID(const int32 TID, const int32 Amount, const int32 PosIdx)
+{
+    // 先完整校验：失败的调用不修改背包，也不写入日志（回放时这样的操作视为日志损坏）
+    if (!ensure(Amount > 0)) return false;
+    if (!ensure(PosIdx >= -1 && PosIdx < SlotNum)) return false; // 目标格子超出背包范围
 
-    // 物品已存在，则增加数量
-    if (InventoryItems.Contains(TID))
-    {
-        if (!ensure(InventoryItems[TID])) return;
-        InventoryItems[TID]->Amount++;
-    }
-    else
+    const int32 CfgIdx = ResolveCfgIdx(TID);
+    if (!ensure(CfgIdx != INDEX_NONE)) return false; // 物品配置不存在
+
+    const FEveItemData& ItemData = ItemCfgs[CfgIdx]->ItemData;
+    if (!FitsCapacity(Amount * ItemData.Weight, Amount * ItemData.Volume)) return false; // 超出负重 / 体积是正常的游戏输入，不触发 ensure
+
+    TObjectPtr<UEveInventoryItem>* ExistingItem = InventoryItems.Find(TID);
+    if (ExistingItem && !ensure(*ExistingItem)) return false;
+
+    int32 SavePosIdx = 0;
+    if (!ExistingItem)
     {
-        TObjectPtr<UEveInventoryItem> NewInventoryItem = NewObject<UEveInventoryItem>();
-        int32 SavePosIdx = 0;
+        if (!ensure(GetUsedSlotNum() < SlotNum)) return false; // 背包容量限制（含预留的格子）
 
-        // 计算第一个空位存放物品
+        // 计算第一个空位存放物品（跳过被预留的格子）
         if (PosIdx == -1)
         {
             for (int32 Idx = 0; Idx < SlotNum; Idx++)
             {
-                if (CurPosIdxes.Contains(Idx))
+                if (CurPosIdxes.Contains(Idx) || IsSlotReserved(Idx))
                 {
                     SavePosIdx++;
                 }
@@ -108,16 +531,105 @@ void UEveInventoryMgr::AddItem(const TObjectPtr<UEveItem> Item, const int32 PosI
         }
         else
         {
+            if (!ensure(!CurPosIdxes.Contains(PosIdx) && !IsSlotReserved(PosIdx))) return false; // 目标格子已被占用或预留
             SavePosIdx = PosIdx;
         }
+    }
+
+    FEveInventoryOpRecordScope RecordScope(OpRecorder, OpRecordDepth);
+    RecordScope.Record(EEveInventoryOp::AddItemByTID, { TID, Amount, PosIdx });
 
-        NewInventoryItem->Init(TID, 1, SavePosIdx);
+    // 物品已存在，则增加数量
+    if (ExistingItem)
+    {
+        (*ExistingItem)->Amount += Amount;
+        MarkSlotDirty((*ExistingItem)->PosIdx);
+    }
+    else
+    {
+        TObjectPtr<UEveInventoryItem> NewInventoryItem = NewObject<UEveInventoryItem>();
+        NewInventoryItem->Init(TID, Amount, SavePosIdx);
+        NewInventoryItem->CfgIdx = CfgIdx;
         InventoryItems.Add(TID, NewInventoryItem);
+        SlotItems[SavePosIdx] = NewInventoryItem;
+        SlotTagBits[SavePosIdx] = GetSlotTagBits(NewInventoryItem);
         CurPosIdxes.Add(SavePosIdx);
         PosToTIDMap.Add(SavePosIdx, TID);
+        MarkSlotDirty(SavePosIdx);
     }
 
-    OnInventoryUpdated.Broadcast(); // 触发库存更新事件
+    RefreshItemAggregate(TID);
+    NotifyInventoryUpdated(); // 触发库存更新事件
+    return true;
+}
+
+/**
+ * 按 TID 移除指定数量的物品。
+ */
+bool UEveInventoryMgr::RemoveItemByTID(const int32 TID, const int32 Amount)
+{
+    if (!ensure(Amount > 0)) return false;
+
+    const TObjectPtr<UEveInventoryItem>* Item = InventoryItems.Find(TID);
+    if (!Item || !*Item || (*Item)->Amount < Amount) return false;
+
+    // 校验通过后才记录，失败的调用不写入日志
+    FEveInventoryOpRecordScope RecordScope(OpRecorder, OpRecordDepth);
+    RecordScope.Record(EEveInventoryOp::RemoveItemByTID, { TID, Amount });
+
+    // 全部移除时移除整个堆叠
+    if ((*Item)->Amount == Amount)
+    {
+        RemoveItem(TID);
+        return true;
+    }
+
+    (*Item)->Amount -= Amount;
+    MarkSlotDirty((*Item)->PosIdx);
+
+    RefreshItemAggregate(TID);
+    NotifyInventoryUpdated(); // 触发库存更新事件
+    return true;
+}
+
+/**
+ * 批量添加物品，整批只触发一次更新事件。
+ */
+int32 UEveInventoryMgr::AddItemStacks(const TConstArrayView<FEveItemStack> Stacks, TBitArray<>* OutAdded)
+{
+    if (OutAdded)
+    {
+        OutAdded->Init(false, Stacks.Num());
+    }
+
+    FEveInventoryOpRecordScope RecordScope(OpRecorder, OpRecordDepth);
+    if (RecordScope.IsRecording())
+    {
+        TArray<int32, TInlineAllocator<16>> Args;
+        for (const FEveItemStack& Stack : Stacks)
+        {
+            Args.Add(Stack.TID);
+            Args.Add(Stack.Amount);
+        }
+        RecordScope.Record(EEveInventoryOp::AddItemStacks, Args);
+    }
+
+    FEveInventoryBatchScope Batch(this);
+
+    int32 AddedNum = 0;
+    for (int32 Idx = 0; Idx < Stacks.Num(); Idx++)
+    {
+        const FEveItemStack& Stack = Stacks[Idx];
+        if (Stack.Amount <= 0 || !CanAddItem(Stack.TID, Stack.Amount)) continue;
+
+        if (AddItemByTID(Stack.TID, Stack.Amount))
+        {
+            AddedNum++;
+            if (OutAdded) (*OutAdded)[Idx] = true;
+        }
+    }
+
+    return AddedNum;
 }
 
 /**
@@ -128,49 +640,872 @@ void UEveInventoryMgr::RemoveItem(const int32 TID)
     if (!ensure(InventoryItems.Contains(TID))) return;
     if (!ensure(InventoryItems[TID])) return;
 
+    FEveInventoryOpRecordScope RecordScope(OpRecorder, OpRecordDepth);
+    RecordScope.Record(EEveInventoryOp::RemoveItem, { TID });
+
+    MarkSlotDirty(InventoryItems[TID]->PosIdx);
+    SlotItems[InventoryItems[TID]->PosIdx] = nullptr;
+    SlotTagBits[InventoryItems[TID]->PosIdx] = 0;
     CurPosIdxes.Remove(InventoryItems[TID]->PosIdx);
     PosToTIDMap.Remove(InventoryItems[TID]->PosIdx);
     InventoryItems.Remove(TID);
 
-    OnInventoryUpdated.Broadcast(); // 触发库存更新事件
+    RefreshItemAggregate(TID);
+    NotifyInventoryUpdated(); // 触发库存更新事件
 }
 
 /**
- * 交换两个物品的位置。
+ * 是否可以添加该物品。
  */
-void UEveInventoryMgr::ExchangeItem(const int32 OldPosIdx, const int32 NewPosIdx)
+bool UEveInventoryMgr::CanAddItem(const int32 TID, const int32 Amount) const
 {
-    if (!ensure(CurPosIdxes.Contains(OldPosIdx))) return;
-    if (!ensure(CurPosIdxes.Contains(NewPosIdx))) return;
-    if (!ensure(PosToTIDMap.Contains(OldPosIdx))) return;
-    if (!ensure(PosToTIDMap.Contains(NewPosIdx))) return;
-
-    int32 OldTID = PosToTIDMap[OldPosIdx];
-    int32 NewTID = PosToTIDMap[NewPosIdx];
+    float Weight = 0.f;
+    float Volume = 0.f;
+    if (!FindItemFootprint(TID, Weight, Volume)) return false;
 
-    TObjectPtr<UEveInventoryItem>& OldInventoryItem = InventoryItems.FindOrAdd(OldTID);
-    if (!ensure(OldInventoryItem)) return;
-    OldInventoryItem->PosIdx = NewPosIdx;
-
-    TObjectPtr<UEveInventoryItem>& NewInventoryItem = InventoryItems.FindOrAdd(NewTID);
-    if (!ensure(NewInventoryItem)) return;
-    NewInventoryItem->PosIdx = OldPosIdx;
-
-    PosToTIDMap[OldPosIdx] = NewTID;
-    PosToTIDMap[NewPosIdx] = OldTID;
-
-    OnInventoryUpdated.Broadcast(); // 触发库存更新事件
+    if (!InventoryItems.Contains(TID) && GetUsedSlotNum() >= SlotNum) return false;
+    return FitsCapacity(Amount * Weight, Amount * Volume);
 }
 
 /**
- * 反初始化，清空所有库存数据。
+ * 整批物品能否全部放入背包。
  */
-void UEveInventoryMgr::Deinitialize()
+bool UEveInventoryMgr::CanAddItemStacks(const TConstArrayView<FEveItemStack> Stacks) const
 {
-    Super::Deinitialize();
+    float AddWeight = 0.f;
+    float AddVolume = 0.f;
+    TSet<int32, DefaultKeyFuncs<int32>, TInlineSetAllocator<16>> NewTIDs;
+
+    for (const FEveItemStack& Stack : Stacks)
+    {
+        if (Stack.Amount <= 0) return false;
+
+        float Weight = 0.f;
+        float Volume = 0.f;
+        if (!FindItemFootprint(Stack.TID, Weight, Volume)) return false;
+
+        AddWeight += Stack.Amount * Weight;
+        AddVolume += Stack.Amount * Volume;
+        if (!InventoryItems.Contains(Stack.TID))
+        {
+            NewTIDs.Add(Stack.TID);
+        }
+    }
+
+    return GetUsedSlotNum() + NewTIDs.Num() <= SlotNum && FitsCapacity(AddWeight, AddVolume);
+}
+
+/**
+ * 预留容量。
+ */
+bool UEveInventoryMgr::ReserveCapacity(const int32 SlotCount, const float Weight, const float Volume, FEveInventoryReservation& OutReservation)
+{
+    FEveInventoryOpRecordScope RecordScope(OpRecorder, OpRecordDepth);
+
+    if (!ensure(SlotCount >= 0)) return false;
+    if (GetUsedSlotNum() + SlotCount > SlotNum) return false;
+
+    const float ReserveWeight = FMath::Max(Weight, 0.f);
+    const float ReserveVolume = FMath::Max(Volume, 0.f);
+    if (!FitsCapacity(ReserveWeight, ReserveVolume)) return false;
+
+    if (ReservedSlotBits.Num() < SlotNum)
+    {
+        ReservedSlotBits.Add(false, SlotNum - ReservedSlotBits.Num());
+    }
+
+    // 只记录成功的结果（选中的格子），回放时按原格子恢复，不依赖回放时的空位顺序
+    FEveInventoryReservation Added;
+    Added.Weight = ReserveWeight;
+    Added.Volume = ReserveVolume;
+
+    for (int32 Idx = 0; Idx < SlotNum && Added.PosIdxes.Num() < SlotCount; Idx++)
+    {
+        if (CurPosIdxes.Contains(Idx) || ReservedSlotBits[Idx]) continue;
+
+        ReservedSlotBits[Idx] = true;
+        Added.PosIdxes.Add(Idx);
+    }
+    ReservedSlotNum += Added.PosIdxes.Num();
+    ReservedWeight += ReserveWeight;
+    ReservedVolume += ReserveVolume;
+
+    if (RecordScope.IsRecording())
+    {
+        OpRecorder->RecordReservation(EEveInventoryOp::ReserveCapacity, Added);
+    }
+
+    OutReservation.PosIdxes.Append(Added.PosIdxes);
+    OutReservation.Weight += ReserveWeight;
+    OutReservation.Volume += ReserveVolume;
+    return true;
+}
+
+/**
+ * 释放预留的容量。
+ */
+void UEveInventoryMgr::ReleaseReservation(FEveInventoryReservation& Reservation)
+{
+    FEveInventoryOpRecordScope RecordScope(OpRecorder, OpRecordDepth);
+    if (RecordScope.IsRecording() && !Reservation.IsEmpty())
+    {
+        OpRecorder->RecordReservation(EEveInventoryOp::ReleaseReservation, Reservation);
+    }
+
+    for (const int32 PosIdx : Reservation.PosIdxes)
+    {
+        if (IsSlotReserved(PosIdx))
+        {
+            ReservedSlotBits[PosIdx] = false;
+            ReservedSlotNum--;
+        }
+    }
+
+    ReservedWeight = FMath::Max(ReservedWeight - Reservation.Weight, 0.f);
+    ReservedVolume = FMath::Max(ReservedVolume - Reservation.Volume, 0.f);
+    Reservation = FEveInventoryReservation();
+}
+
+/**
+ * 恢复一份已知的预留。
+ */
+bool UEveInventoryMgr::RestoreReservation(const FEveInventoryReservation& Reservation)
+{
+    FEveInventoryOpRecordScope RecordScope(OpRecorder, OpRecordDepth);
+
+    if (!(Reservation.Weight >= 0.f) || !(Reservation.Volume >= 0.f)) return false;
+
+    // 先完整校验，失败时不预留任何格子
+    TSet<int32, DefaultKeyFuncs<int32>, TInlineSetAllocator<16>> PosIdxSet;
+    for (const int32 PosIdx : Reservation.PosIdxes)
+    {
+        if (PosIdx < 0 || PosIdx >= SlotNum) return false;
+        if (CurPosIdxes.Contains(PosIdx) || IsSlotReserved(PosIdx)) return false;
+
+        bool bDuplicated = false;
+        PosIdxSet.Add(PosIdx, &bDuplicated);
+        if (bDuplicated) return false;
+    }
+
+    if (RecordScope.IsRecording())
+    {
+        OpRecorder->RecordReservation(EEveInventoryOp::ReserveCapacity, Reservation);
+    }
+
+    if (ReservedSlotBits.Num() < SlotNum)
+    {
+        ReservedSlotBits.Add(false, SlotNum - ReservedSlotBits.Num());
+    }
+
+    for (const int32 PosIdx : Reservation.PosIdxes)
+    {
+        ReservedSlotBits[PosIdx] = true;
+    }
+    ReservedSlotNum += Reservation.PosIdxes.Num();
+    ReservedWeight += Reservation.Weight;
+    ReservedVolume += Reservation.Volume;
+    return true;
+}
+
+/**
+ * 当前所有预留的汇总。
+ */
+FEveInventoryReservation UEveInventoryMgr::GetReservedCapacity() const
+{
+    FEveInventoryReservation Reservation;
+    for (TConstSetBitIterator<> It(ReservedSlotBits); It; ++It)
+    {
+        Reservation.PosIdxes.Add(It.GetIndex());
+    }
+    Reservation.Weight = ReservedWeight;
+    Reservation.Volume = ReservedVolume;
+    return Reservation;
+}
+
+/**
+ * 对所有格子执行标签查询。
+ */
+int32 UEveInventoryMgr::QuerySlots(const FEveItemTagQuery& Query, TBitArray<>& OutMatches) const
+{
+    OutMatches.Init(false, SlotTagBits.Num());
+
+    // 标签超过位上限时，对格子中物品的标签容器逐个精确匹配
+    if (Query.bNeedsTagFallback)
+    {
+        int32 MatchNum = 0;
+        for (int32 PosIdx = 0; PosIdx < SlotItems.Num(); PosIdx++)
+        {
+            const UEveItemCfg* ItemCfg = SlotItems[PosIdx] ? GetCfgByIdx(SlotItems[PosIdx]->CfgIdx) : nullptr;
+            const bool bMatch = ItemCfg && Query.MatchesTags(ItemCfg->ItemData.Tags);
+            OutMatches[PosIdx] = bMatch;
+            MatchNum += bMatch;
+        }
+        return MatchNum;
+    }
+
+    // 只读连续的掩码数组，匹配无分支
+    int32 MatchNum = 0;
+    const uint64* Bits = SlotTagBits.GetData();
+    for (int32 PosIdx = 0; PosIdx < SlotTagBits.Num(); PosIdx++)
+    {
+        const bool bMatch = Query.Matches(Bits[PosIdx]);
+        OutMatches[PosIdx] = bMatch;
+        MatchNum += bMatch;
+    }
+    return MatchNum;
+}
+
+/**
+ * 将物品配置的标签编译为掩码。
+ */
+void UEveInventoryMgr::CompileItemTags(UEveItemCfg* ItemCfg)
+{
+    ItemCfg->TagBits = ItemTagIndex.Compile(ItemCfg->ItemData.Tags);
+}
+
+/**
+ * 格子中物品的标签掩码。
+ */
+uint64 UEveInventoryMgr::GetSlotTagBits(const UEveInventoryItem* Item) const
+{
+    if (!Item) return 0;
+
+    const UEveItemCfg* ItemCfg = GetCfgByIdx(Item->CfgIdx);
+    return (ItemCfg ? ItemCfg->TagBits : 0) | FEveItemTagIndex::OccupiedBit;
+}
+
+/**
+ * 重新计算某种物品的统计汇总，并增量更新背包总计。
+ */
+void UEveInventoryMgr::RefreshItemAggregate(const int32 TID)
+{
+    FEveItemAggregate NewAggregate;
+    if (const TObjectPtr<UEveInventoryItem>* Item = InventoryItems.Find(TID); Item && *Item)
+    {
+        if (const UEveItemCfg* ItemCfg = GetCfgByIdx((*Item)->CfgIdx))
+        {
+            NewAggregate.Amount = (*Item)->Amount;
+            NewAggregate.Weight = NewAggregate.Amount * ItemCfg->ItemData.Weight;
+            NewAggregate.Volume = NewAggregate.Amount * ItemCfg->ItemData.Volume;
+            NewAggregate.Value = static_cast<int64>(NewAggregate.Amount) * ItemCfg->ItemData.Value;
+        }
+    }
+
+    const FEveItemAggregate OldAggregate = GetItemAggregate(TID);
+    TotalAggregate.Amount += NewAggregate.Amount - OldAggregate.Amount;
+    TotalAggregate.Weight += NewAggregate.Weight - OldAggregate.Weight;
+    TotalAggregate.Volume += NewAggregate.Volume - OldAggregate.Volume;
+    TotalAggregate.Value += NewAggregate.Value - OldAggregate.Value;
+
+    if (NewAggregate.Amount > 0)
+    {
+        ItemAggregates.Add(TID, NewAggregate);
+    }
+    else
+    {
+        ItemAggregates.Remove(TID);
+    }
+
+    // 背包清空时归零，避免浮点增减累积误差
+    if (ItemAggregates.Num() == 0)
+    {
+        TotalAggregate = FEveItemAggregate();
+    }
+
+    if (NewAggregate.Amount != OldAggregate.Amount)
+    {
+        OnItemAmountChanged.Broadcast(TID, OldAggregate.Amount, NewAggregate.Amount);
+    }
+}
+
+/**
+ * 交换两个物品的位置。
+ */
+void UEveInventoryMgr::ExchangeItem(const int32 OldPosIdx, const int32 NewPosIdx)
+{
+    if (IsSlotReserved(OldPosIdx) || IsSlotReserved(NewPosIdx)) return; // 预留的格子不能放入物品
+    if (!ensure(CurPosIdxes.Contains(OldPosIdx))) return;
+    if (!ensure(CurPosIdxes.Contains(NewPosIdx))) return;
+    if (!ensure(PosToTIDMap.Contains(OldPosIdx))) return;
+    if (!ensure(PosToTIDMap.Contains(NewPosIdx))) return;
+
+    // 校验通过后才记录，失败的调用不写入日志
+    FEveInventoryOpRecordScope RecordScope(OpRecorder, OpRecordDepth);
+    RecordScope.Record(EEveInventoryOp::ExchangeItem, { OldPosIdx, NewPosIdx });
+
+    int32 OldTID = PosToTIDMap[OldPosIdx];
+    int32 NewTID = PosToTIDMap[NewPosIdx];
+
+    TObjectPtr<UEveInventoryItem>& OldInventoryItem = InventoryItems.FindOrAdd(OldTID);
+    if (!ensure(OldInventoryItem)) return;
+    OldInventoryItem->PosIdx = NewPosIdx;
+
+    TObjectPtr<UEveInventoryItem>& NewInventoryItem = InventoryItems.FindOrAdd(NewTID);
+    if (!ensure(NewInventoryItem)) return;
+    NewInventoryItem->PosIdx = OldPosIdx;
+
+    PosToTIDMap[OldPosIdx] = NewTID;
+    PosToTIDMap[NewPosIdx] = OldTID;
+    Swap(SlotItems[OldPosIdx], SlotItems[NewPosIdx]);
+    Swap(SlotTagBits[OldPosIdx], SlotTagBits[NewPosIdx]);
+    MarkSlotDirty(OldPosIdx);
+    MarkSlotDirty(NewPosIdx);
+
+    NotifyInventoryUpdated(); // 触发库存更新事件
+}
+
+/**
+ * 批量移动物品（一次排列）。
+ */
+bool UEveInventoryMgr::MoveItems(const TArray<int32>& FromPosIdxes, const TArray<int32>& ToPosIdxes)
+{
+    if (!ensure(FromPosIdxes.Num() == ToPosIdxes.Num())) return false;
+
+    const int32 Num = FromPosIdxes.Num();
+    if (Num == 0) return true;
+
+    // 校验：源格子必须有物品且互不重复，目标格子必须在背包范围内、未被预留且互不重复
+    TSet<int32> FromSet;
+    TSet<int32> ToSet;
+    FromSet.Reserve(Num);
+    ToSet.Reserve(Num);
+
+    for (int32 Idx = 0; Idx < Num; Idx++)
+    {
+        const int32 From = FromPosIdxes[Idx];
+        const int32 To = ToPosIdxes[Idx];
+        if (!PosToTIDMap.Contains(From)) return false;
+        if (To < 0 || To >= SlotNum || IsSlotReserved(To)) return false;
+
+        bool bDuplicated = false;
+        FromSet.Add(From, &bDuplicated);
+        if (bDuplicated) return false;
+        ToSet.Add(To, &bDuplicated);
+        if (bDuplicated) return false;
+    }
+
+    // 校验通过后才记录，失败的调用不写入日志
+    FEveInventoryOpRecordScope RecordScope(OpRecorder, OpRecordDepth);
+    if (RecordScope.IsRecording())
+    {
+        TArray<int32, TInlineAllocator<16>> Args(FromPosIdxes);
+        Args.Append(ToPosIdxes);
+        RecordScope.Record(EEveInventoryOp::MoveItems, Args);
+    }
+
+    // 被挤出的物品：目标格子上未参与移动的物品
+    TArray<int32> DisplacedTIDs;
+    for (const int32 To : ToPosIdxes)
+    {
+        if (const int32* TID = PosToTIDMap.Find(To); TID && !FromSet.Contains(To))
+        {
+            DisplacedTIDs.Add(*TID);
+        }
+    }
+
+    // 空出的格子：没有被任何目标占用的源格子，按索引升序保证结果确定
+    TArray<int32> VacatedPosIdxes;
+    for (const int32 From : FromPosIdxes)
+    {
+        if (!ToSet.Contains(From))
+        {
+            VacatedPosIdxes.Add(From);
+        }
+    }
+    VacatedPosIdxes.Sort();
+
+    // |From| == |To|，因此空出的格子一定能容纳所有被挤出的物品
+    check(DisplacedTIDs.Num() <= VacatedPosIdxes.Num());
+
+    // 先记录移动物品的 TID 并清除旧位置，再统一写入，避免中途互相覆盖
+    TArray<int32> MovingTIDs;
+    MovingTIDs.Reserve(Num);
+    for (const int32 From : FromPosIdxes)
+    {
+        MovingTIDs.Add(PosToTIDMap.FindAndRemoveChecked(From));
+        CurPosIdxes.Remove(From);
+        SlotItems[From] = nullptr;
+        SlotTagBits[From] = 0;
+        MarkSlotDirty(From);
+    }
+
+    auto PlaceItem = [this](const int32 TID, const int32 NewPosIdx)
+    {
+        UEveInventoryItem* Item = InventoryItems.FindChecked(TID);
+        Item->PosIdx = NewPosIdx;
+        SlotItems[NewPosIdx] = Item;
+        SlotTagBits[NewPosIdx] = GetSlotTagBits(Item);
+        PosToTIDMap.Add(NewPosIdx, TID);
+        CurPosIdxes.Add(NewPosIdx);
+        MarkSlotDirty(NewPosIdx);
+    };
+
+    for (int32 Idx = 0; Idx < Num; Idx++)
+    {
+        PlaceItem(MovingTIDs[Idx], ToPosIdxes[Idx]);
+    }
+
+    for (int32 Idx = 0; Idx < DisplacedTIDs.Num(); Idx++)
+    {
+        PlaceItem(DisplacedTIDs[Idx], VacatedPosIdxes[Idx]);
+    }
+
+    NotifyInventoryUpdated(); // 整个排列只触发一次更新事件
+    return true;
+}
+
+/**
+ * 将一组物品转移到另一个背包。
+ */
+bool UEveInventoryMgr::TransferItemsTo(UEveInventoryMgr* Target, const TArray<int32>& FromPosIdxes, const TArray<int32>& ToPosIdxes)
+{
+    if (!ensure(Target) || !ensure(Target != this)) return false;
+    if (!ensure(FromPosIdxes.Num() == ToPosIdxes.Num())) return false;
+
+    // 先完整校验，保证失败时两侧都不被修改；源格子与 `MoveItems` 一样必须互不重复
+    TSet<int32> FromSet;
+    TSet<int32> ClaimedPosIdxes;
+    FromSet.Reserve(FromPosIdxes.Num());
+    int32 NewStackNum = 0;
+    float AddWeight = 0.f;
+    float AddVolume = 0.f;
+    for (int32 Idx = 0; Idx < FromPosIdxes.Num(); Idx++)
+    {
+        const int32* TID = PosToTIDMap.Find(FromPosIdxes[Idx]);
+        if (!TID) return false;
+
+        // 目标背包必须能解析该物品（可能需要从物品目录生成配置）
+        if (Target->ResolveCfgIdx(*TID) == INDEX_NONE) return false;
+
+        bool bDuplicatedFrom = false;
+        FromSet.Add(FromPosIdxes[Idx], &bDuplicatedFrom);
+        if (bDuplicatedFrom) return false;
+
+        // 整堆转移，重量与体积直接取本背包维护的汇总
+        const FEveItemAggregate& Aggregate = GetItemAggregate(*TID);
+        AddWeight += Aggregate.Weight;
+        AddVolume += Aggregate.Volume;
+
+        // 目标背包已有该物品，叠加到已有堆叠
+        if (Target->InventoryItems.Contains(*TID)) continue;
+
+        const int32 To = ToPosIdxes[Idx];
+        if (To < 0 || To >= Target->SlotNum) return false;
+        if (Target->CurPosIdxes.Contains(To) || Target->IsSlotReserved(To)) return false;
+
+        bool bDuplicated = false;
+        ClaimedPosIdxes.Add(To, &bDuplicated);
+        if (bDuplicated) return false;
+
+        NewStackNum++;
+    }
+    if (Target->GetUsedSlotNum() + NewStackNum > Target->SlotNum) return false;
+    if (!Target->FitsCapacity(AddWeight, AddVolume)) return false;
+
+    // 两侧各只广播一次
+    FEveInventoryBatchScope SourceBatch(this);
+    FEveInventoryBatchScope TargetBatch(Target);
+
+    // 先加入目标再移出源，加入失败时把已转移的物品放回原格子
+    TArray<TPair<int32, int32>> Transferred;
+    Transferred.Reserve(FromPosIdxes.Num());
+    for (int32 Idx = 0; Idx < FromPosIdxes.Num(); Idx++)
+    {
+        const int32 TID = PosToTIDMap.FindChecked(FromPosIdxes[Idx]);
+        const int32 Amount = InventoryItems.FindChecked(TID)->Amount;
+
+        if (!Target->AddItemByTID(TID, Amount, Target->InventoryItems.Contains(TID) ? -1 : ToPosIdxes[Idx]))
+        {
+            for (int32 UndoIdx = Transferred.Num() - 1; UndoIdx >= 0; UndoIdx--)
+            {
+                const TPair<int32, int32>& Undo = Transferred[UndoIdx];
+                verify(Target->RemoveItemByTID(Undo.Key, Undo.Value));
+                verify(AddItemByTID(Undo.Key, Undo.Value, FromPosIdxes[UndoIdx]));
+            }
+            return false;
+        }
+        RemoveItem(TID);
+        Transferred.Emplace(TID, Amount);
+    }
+
+    return true;
+}
+
+/**
+ * 检查内部结构的一致性。
+ */
+bool UEveInventoryMgr::CheckInvariants(FString* OutError) const
+{
+    auto Fail = [OutError](const FString& Error)
+    {
+        if (OutError) *OutError = Error;
+        return false;
+    };
+
+    if (SlotItems.Num() != SlotNum || SlotTagBits.Num() != SlotNum)
+    {
+        return Fail(FString::Printf(TEXT("Slot arrays have %d/%d entries, expected %d"), SlotItems.Num(), SlotTagBits.Num(), SlotNum));
+    }
+    if (CurPosIdxes.Num() != InventoryItems.Num() || PosToTIDMap.Num() != InventoryItems.Num() || ItemAggregates.Num() != InventoryItems.Num())
+    {
+        return Fail(FString::Printf(TEXT("%d item(s) but %d position(s), %d position mapping(s), %d aggregate(s)"),
+            InventoryItems.Num(), CurPosIdxes.Num(), PosToTIDMap.Num(), ItemAggregates.Num()));
+    }
+
+    int32 TotalAmount = 0;
+    for (const TPair<int32, TObjectPtr<UEveInventoryItem>>& Pair : InventoryItems)
+    {
+        const UEveInventoryItem* Item = Pair.Value;
+        if (!Item) return Fail(FString::Printf(TEXT("Item %d is null"), Pair.Key));
+        if (Item->TID != Pair.Key) return Fail(FString::Printf(TEXT("Item %d is stored under TID %d"), Item->TID, Pair.Key));
+        if (Item->Amount <= 0) return Fail(FString::Printf(TEXT("Item %d has amount %d"), Item->TID, Item->Amount));
+        if (!GetCfgByIdx(Item->CfgIdx)) return Fail(FString::Printf(TEXT("Item %d has invalid config index %d"), Item->TID, Item->CfgIdx));
+
+        const int32 PosIdx = Item->PosIdx;
+        if (!SlotItems.IsValidIndex(PosIdx) || SlotItems[PosIdx] != Item)
+        {
+            return Fail(FString::Printf(TEXT("Item %d is not in its slot %d"), Item->TID, PosIdx));
+        }
+        const int32* MappedTID = PosToTIDMap.Find(PosIdx);
+        if (!CurPosIdxes.Contains(PosIdx) || !MappedTID || *MappedTID != Item->TID)
+        {
+            return Fail(FString::Printf(TEXT("Slot %d of item %d is not mapped back to it"), PosIdx, Item->TID));
+        }
+        if (SlotTagBits[PosIdx] != GetSlotTagBits(Item))
+        {
+            return Fail(FString::Printf(TEXT("Slot %d has stale tag bits"), PosIdx));
+        }
+        if (GetItemAggregate(Item->TID).Amount != Item->Amount)
+        {
+            return Fail(FString::Printf(TEXT("Item %d aggregate amount %d != %d"), Item->TID, GetItemAggregate(Item->TID).Amount, Item->Amount));
+        }
+        TotalAmount += Item->Amount;
+    }
+
+    // 每个物品都在自己的格子中且数量相等，则非空格子与物品一一对应
+    int32 OccupiedNum = 0;
+    for (int32 PosIdx = 0; PosIdx < SlotNum; PosIdx++)
+    {
+        if (SlotItems[PosIdx])
+        {
+            if (IsSlotReserved(PosIdx)) return Fail(FString::Printf(TEXT("Occupied slot %d is also reserved"), PosIdx));
+            OccupiedNum++;
+        }
+        else if (SlotTagBits[PosIdx] != 0)
+        {
+            return Fail(FString::Printf(TEXT("Empty slot %d has tag bits"), PosIdx));
+        }
+    }
+    if (OccupiedNum != InventoryItems.Num())
+    {
+        return Fail(FString::Printf(TEXT("%d occupied slot(s) for %d item(s)"), OccupiedNum, InventoryItems.Num()));
+    }
+
+    if (TotalAggregate.Amount != TotalAmount)
+    {
+        return Fail(FString::Printf(TEXT("Total amount %d != %d"), TotalAggregate.Amount, TotalAmount));
+    }
+    if (ReservedSlotNum != ReservedSlotBits.CountSetBits())
+    {
+        return Fail(FString::Printf(TEXT("%d reserved slot(s) but %d reserved bit(s)"), ReservedSlotNum, ReservedSlotBits.CountSetBits()));
+    }
+    return true;
+}
+
+/**
+ * 清空背包中的所有物品。
+ */
+void UEveInventoryMgr::ResetItems()
+{
+    FEveInventoryOpRecordScope RecordScope(OpRecorder, OpRecordDepth);
+    RecordScope.Record(EEveInventoryOp::ResetItems, TConstArrayView<int32>());
+
+    FEveInventoryBatchScope Batch(this);
+
+    TArray<int32> TIDs;
+    InventoryItems.GetKeys(TIDs);
+    for (const int32 TID : TIDs)
+    {
+        RemoveItem(TID);
+    }
+}
+
+/**
+ * 初始化一个共享物品配置的临时背包。
+ */
+void UEveInventoryMgr::InitializeHeadless(const UEveInventoryMgr& Source)
+{
+    AllItemsCfg = Source.AllItemsCfg;
+    ItemCfgs = Source.ItemCfgs;
+    TIDToCfgIdx = Source.TIDToCfgIdx;
+    ItemTagIndex = Source.ItemTagIndex;
+    MaxWeight = Source.MaxWeight;
+    MaxVolume = Source.MaxVolume;
+    CatalogSource = &Source;
+
+    SlotItems.SetNum(SlotNum);
+    SlotTagBits.Init(0, SlotNum);
+}
+
+/**
+ * 将所有格子打包为紧凑记录。
+ */
+void UEveInventoryMgr::PackSlots(TArray<FEveItemSlotRecord>& OutRecords) const
+{
+    OutRecords.Init(FEveItemSlotRecord(), SlotNum);
+    for (int32 PosIdx = 0; PosIdx < SlotNum; PosIdx++)
+    {
+        FEveItemSlotRecord& Record = OutRecords[PosIdx];
+        if (IsSlotReserved(PosIdx))
+        {
+            Record.Flags |= FEveItemSlotRecord::Reserved;
+        }
+        if (const UEveInventoryItem* Item = GetSlotItem(PosIdx))
+        {
+            ensure(Item->Amount <= FEveItemSlotRecord::MaxAmount);
+            Record.TID = Item->TID;
+            Record.Amount = static_cast<uint32>(FMath::Min(Item->Amount, FEveItemSlotRecord::MaxAmount));
+            Record.Flags |= FEveItemSlotRecord::Occupied;
+        }
+    }
+}
+
+/**
+ * 用紧凑记录替换背包内容。
+ */
+bool UEveInventoryMgr::UnpackSlots(const TConstArrayView<FEveItemSlotRecord> Records)
+{
+    if (Records.Num() > SlotNum) return false;
+
+    // 先完整校验，失败时背包保持不变
+    TSet<int32, DefaultKeyFuncs<int32>, TInlineSetAllocator<16>> TIDs;
+    float Weight = 0.f;
+    float Volume = 0.f;
+    for (const FEveItemSlotRecord& Record : Records)
+    {
+        if (!Record.IsOccupied()) continue;
+
+        float ItemWeight = 0.f;
+        float ItemVolume = 0.f;
+        if (!FindItemFootprint(Record.TID, ItemWeight, ItemVolume) || Record.Amount == 0) return false;
+
+        bool bDuplicated = false;
+        TIDs.Add(Record.TID, &bDuplicated);
+        if (bDuplicated) return false;
+
+        Weight += Record.Amount * ItemWeight;
+        Volume += Record.Amount * ItemVolume;
+    }
+    if (GetUsedSlotNum() - InventoryItems.Num() + TIDs.Num() > SlotNum) return false;
+    if (!FitsCapacity(Weight - TotalAggregate.Weight, Volume - TotalAggregate.Volume)) return false;
+
+    FEveInventoryBatchScope Batch(this);
+
+    // 任何一次添加失败时恢复原有内容（原有物品所在的格子都没有被预留）
+    TArray<FEveItemSlotRecord> Backup;
+    PackSlots(Backup);
+
+    // 第一遍放入原格子可用的记录，第二遍再把原格子被预留的记录放到剩余的空位，
+    // 避免自动寻位占用后面记录的原格子
+    auto PlaceRecords = [this](const TConstArrayView<FEveItemSlotRecord> PlaceFrom, const bool bReservedPass)
+    {
+        for (int32 PosIdx = 0; PosIdx < PlaceFrom.Num(); PosIdx++)
+        {
+            const FEveItemSlotRecord& Record = PlaceFrom[PosIdx];
+            if (!Record.IsOccupied() || IsSlotReserved(PosIdx) != bReservedPass) continue;
+
+            if (!AddItemByTID(Record.TID, Record.Amount, bReservedPass ? -1 : PosIdx)) return false;
+        }
+        return true;
+    };
+
+    ResetItems();
+    if (PlaceRecords(Records, false) && PlaceRecords(Records, true)) return true;
+
+    ResetItems();
+    verify(PlaceRecords(Backup, false));
+    return false;
+}
+
+/**
+ * 输出背包的内存占用。
+ */
+void UEveInventoryMgr::ReportMemory(FOutputDevice& Ar) const
+{
+    auto Line = [&Ar](const TCHAR* Name, const SIZE_T Bytes, const int32 Count)
+    {
+        Ar.Logf(TEXT("  %-32s %10llu B  %8.1f B each"), Name, static_cast<uint64>(Bytes), Count > 0 ? static_cast<double>(Bytes) / Count : 0.0);
+    };
+
+    // UObject 的大小取反射的结构大小，另加全局对象数组中的一项
+    const SIZE_T ItemObjectSize = UEveInventoryItem::StaticClass()->GetStructureSize() + sizeof(FUObjectItem);
+    const SIZE_T CfgObjectSize = UEveItemCfg::StaticClass()->GetStructureSize() + sizeof(FUObjectItem);
+    const int32 ItemNum = InventoryItems.Num();
+
+    Ar.Logf(TEXT("Inventory slots: %d item(s) in %d slot(s)"), ItemNum, SlotNum);
+    Line(TEXT("UEveInventoryItem objects"), ItemObjectSize * ItemNum, ItemNum);
+    Line(TEXT("InventoryItems (TMap)"), InventoryItems.GetAllocatedSize(), ItemNum);
+    Line(TEXT("PosToTIDMap (TMap)"), PosToTIDMap.GetAllocatedSize(), ItemNum);
+    Line(TEXT("CurPosIdxes (TSet)"), CurPosIdxes.GetAllocatedSize(), ItemNum);
+    Line(TEXT("ItemAggregates (TMap)"), ItemAggregates.GetAllocatedSize(), ItemNum);
+    Line(TEXT("SlotItems (TArray)"), SlotItems.GetAllocatedSize(), SlotNum);
+    Line(TEXT("SlotTagBits (TArray)"), SlotTagBits.GetAllocatedSize(), SlotNum);
+    Line(TEXT("Dirty / reserved bits"), DirtySlotBits.GetAllocatedSize() + DirtyPosIdxes.GetAllocatedSize() + ReservedSlotBits.GetAllocatedSize(), SlotNum);
+
+    // 配置的堆内存：名称字符串、显式标签、属性修正
+    SIZE_T CfgHeapSize = 0;
+    for (const UEveItemCfg* ItemCfg : ItemCfgs)
+    {
+        if (!ItemCfg) continue;
+
+        const FEveItemData& ItemData = ItemCfg->ItemData;
+        CfgHeapSize += ItemData.Name.GetAllocatedSize() + ItemData.Tags.Num() * sizeof(FGameplayTag) + ItemData.StatModifiers.GetAllocatedSize();
+    }
+    const int32 CfgNum = ItemCfgs.Num();
+
+    Ar.Logf(TEXT("Item configs: %d config(s), FEveItemData is %d B inline"), CfgNum, static_cast<int32>(sizeof(FEveItemData)));
+    Line(TEXT("UEveItemCfg objects"), CfgObjectSize * CfgNum, CfgNum);
+    Line(TEXT("FEveItemData heap (approx.)"), CfgHeapSize, CfgNum);
+    Line(TEXT("AllItemsCfg (TMap)"), AllItemsCfg.GetAllocatedSize(), CfgNum);
+    Line(TEXT("ItemCfgs (TArray)"), ItemCfgs.GetAllocatedSize(), CfgNum);
+    Line(TEXT("TIDToCfgIdx (TMap)"), TIDToCfgIdx.GetAllocatedSize(), CfgNum);
+    Line(TEXT("ItemCatalog"), ItemCatalog.GetAllocatedSize(), ItemCatalog.Num());
+
+    // 10 万格子：实际填充两种布局的容器测量，UObject 按单个对象大小计算（不实际创建）
+    constexpr int32 BenchSlotNum = 100000;
+    SIZE_T ObjectLayoutSize = ItemObjectSize * BenchSlotNum;
+    {
+        TMap<int32, TObjectPtr<UEveInventoryItem>> BenchItems;
+        TMap<int32, int32> BenchPosToTID;
+        TSet<int32> BenchPosIdxes;
+        TArray<TObjectPtr<UEveInventoryItem>> BenchSlotItems;
+        BenchItems.Reserve(BenchSlotNum);
+        BenchPosToTID.Reserve(BenchSlotNum);
+        BenchPosIdxes.Reserve(BenchSlotNum);
+        BenchSlotItems.SetNum(BenchSlotNum);
+        for (int32 Idx = 0; Idx < BenchSlotNum; Idx++)
+        {
+            BenchItems.Add(Idx, nullptr);
+            BenchPosToTID.Add(Idx, Idx);
+            BenchPosIdxes.Add(Idx);
+        }
+        ObjectLayoutSize += BenchItems.GetAllocatedSize() + BenchPosToTID.GetAllocatedSize() + BenchPosIdxes.GetAllocatedSize() + BenchSlotItems.GetAllocatedSize();
+    }
+
+    // 紧凑布局：记录数组 + 一个 TID 到格子的索引（按 TID 查找仍需要）
+    SIZE_T PackedLayoutSize = 0;
+    {
+        TArray<FEveItemSlotRecord> BenchRecords;
+        TMap<int32, int32> BenchTIDToPos;
+        BenchRecords.SetNum(BenchSlotNum);
+        BenchTIDToPos.Reserve(BenchSlotNum);
+        for (int32 Idx = 0; Idx < BenchSlotNum; Idx++)
+        {
+            BenchTIDToPos.Add(Idx, Idx);
+        }
+        PackedLayoutSize = BenchRecords.GetAllocatedSize() + BenchTIDToPos.GetAllocatedSize();
+    }
+
+    Ar.Logf(TEXT("%d slots: UObject layout %.2f MB (%.1f B/slot), packed records %.2f MB (%.1f B/slot), %.1fx smaller"),
+        BenchSlotNum,
+        ObjectLayoutSize / (1024.0 * 1024.0), static_cast<double>(ObjectLayoutSize) / BenchSlotNum,
+        PackedLayoutSize / (1024.0 * 1024.0), static_cast<double>(PackedLayoutSize) / BenchSlotNum,
+        static_cast<double>(ObjectLayoutSize) / FMath::Max<SIZE_T>(PackedLayoutSize, 1));
+}
+
+/**
+ * 开始批量修改。
+ */
+void UEveInventoryMgr::BeginBatch()
+{
+    BatchDepth++;
+}
+
+/**
+ * 结束批量修改，最外层结束时合并广播一次。
+ */
+void UEveInventoryMgr::EndBatch()
+{
+    if (!ensure(BatchDepth > 0)) return;
+
+    if (--BatchDepth == 0 && bPendingUpdate)
+    {
+        bPendingUpdate = false;
+        BroadcastInventoryUpdated();
+    }
+}
+
+/**
+ * 通知背包已更新。
+ */
+void UEveInventoryMgr::NotifyInventoryUpdated()
+{
+    if (BatchDepth > 0)
+    {
+        bPendingUpdate = true;
+        return;
+    }
+
+    BroadcastInventoryUpdated();
+}
+
+/**
+ * 记录发生变化的格子（去重）。
+ */
+void UEveInventoryMgr::MarkSlotDirty(const int32 PosIdx)
+{
+    if (PosIdx < 0) return;
+
+    if (PosIdx >= DirtySlotBits.Num())
+    {
+        DirtySlotBits.Add(false, PosIdx + 1 - DirtySlotBits.Num());
+    }
+
+    if (!DirtySlotBits[PosIdx])
+    {
+        DirtySlotBits[PosIdx] = true;
+        DirtyPosIdxes.Add(PosIdx);
+    }
+}
+
+/**
+ * 广播格子增量与整体更新事件，并清空增量记录。
+ */
+void UEveInventoryMgr::BroadcastInventoryUpdated()
+{
+    // 交换出本次增量，避免回调中再次修改背包时覆盖正在广播的数组
+    TArray<int32> ChangedPosIdxes = MoveTemp(DirtyPosIdxes);
+    DirtyPosIdxes.Reset();
+    for (const int32 PosIdx : ChangedPosIdxes)
+    {
+        DirtySlotBits[PosIdx] = false;
+    }
+
+    OnInventorySlotsChanged.Broadcast(ChangedPosIdxes);
+    OnInventoryUpdated.Broadcast(); // 触发库存更新事件
+}
+
+/**
+ * 反初始化，清空所有库存数据。
+ */
+void UEveInventoryMgr::Deinitialize()
+{
+    Super::Deinitialize();
+
+    if (UDataTable* DataTable = ItemDataTable.Get())
+    {
+        DataTable->OnDataTableChanged().RemoveAll(this);
+    }
+    FTSTicker::GetCoreTicker().RemoveTicker(ItemOverrideWatchHandle);
+    CookedItemCatalog.Close();
 
     InventoryItems.Empty();
     CurPosIdxes.Empty();
     PosToTIDMap.Empty();
+    SlotItems.Empty();
+    SlotTagBits.Empty();
+    ItemTagIndex.Reset();
     AddedItemsStack.Empty();
+    ItemAggregates.Empty();
+    TotalAggregate = FEveItemAggregate();
 }
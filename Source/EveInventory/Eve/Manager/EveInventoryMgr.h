@@ -4,15 +4,39 @@
 
 #include "CoreMinimal.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
 #include "Templates/SharedPointer.h"
+#include "EveInventory/Eve/Data/EveItemCatalog.h"
+#include "EveInventory/Eve/Data/EveItemCatalogFile.h"
 #include "EveInventory/Eve/Data/EveItemData.h"
+#include "EveInventory/Eve/Data/EveItemTags.h"
 #include "EveInventoryMgr.generated.h"
 
+class FEveInventoryOpLog;
+
+/**
+ * 背包容量预留（格子、负重、体积），由交易等多阶段操作持有，释放前其他添加无法占用。
+ */
+struct FEveInventoryReservation
+{
+	/** 预留的格子索引 */
+	TArray<int32> PosIdxes;
+
+	/** 预留的负重 */
+	float Weight = 0.f;
+
+	/** 预留的体积 */
+	float Volume = 0.f;
+
+	/** 是否持有任何预留 */
+	bool IsEmpty() const { return PosIdxes.Num() == 0 && Weight <= 0.f && Volume <= 0.f; }
+};
+
 /**
  * 背包管理系统，继承自 UGameInstanceSubsystem，
  * 负责管理物品的添加、移除、交换等功能。
  */
-UCLASS()
+UCLASS(Config = Game)
 class UEveInventoryMgr : public UGameInstanceSubsystem
 {
 	GENERATED_BODY()
@@ -40,6 +64,27 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FEveOnInventoryUpdated OnInventoryUpdated;
 
+	/**
+	 * 格子增量事件，参数为本次发生变化的格子索引（去重）。
+	 * 先于 `OnInventoryUpdated` 广播，UI 只需刷新这些格子。
+	 */
+	DECLARE_MULTICAST_DELEGATE_OneParam(FEveOnInventorySlotsChanged, const TArray<int32>& /* ChangedPosIdxes */);
+	FEveOnInventorySlotsChanged OnInventorySlotsChanged;
+
+	/**
+	 * 物品配置热重载事件，参数为内容发生变化或新增的 TID。
+	 * 配置对象原地更新，UI 只需刷新显示这些物品的格子。
+	 */
+	DECLARE_MULTICAST_DELEGATE_OneParam(FEveOnItemCfgsChanged, const TArray<int32>& /* ChangedTIDs */);
+	FEveOnItemCfgsChanged OnItemCfgsChanged;
+
+	/**
+	 * 物品数量变化事件，每次某个 TID 的数量变化时立即触发（不合并），数量为 0 表示已移除。
+	 * 用于维护按 TID 的增量索引（如配方可制作数量），批量结束后仍会照常广播 `OnInventorySlotsChanged`。
+	 */
+	DECLARE_MULTICAST_DELEGATE_ThreeParams(FEveOnItemAmountChanged, int32 /* TID */, int32 /* OldAmount */, int32 /* NewAmount */);
+	FEveOnItemAmountChanged OnItemAmountChanged;
+
 public:
 	/**
 	 * 测试用：随机添加一个物品到背包。
@@ -74,6 +119,375 @@ public:
 	 */
 	void ExchangeItem(int32 OldPosIdx, int32 NewPosIdx);
 
+	/**
+	 * 按 TID 添加指定数量的物品，已存在时叠加数量。
+	 * @param TID 物品的唯一 ID。
+	 * @param Amount 添加数量。
+	 * @param PosIdx 目标格子索引，默认为 -1，表示自动寻找空闲位置。
+	 * @return 是否添加成功，超出负重或体积上限时返回 false（不触发 ensure）。
+	 */
+	bool AddItemByTID(int32 TID, int32 Amount, int32 PosIdx = -1);
+
+	/**
+	 * 按 TID 移除指定数量的物品，数量减为 0 时移除整个堆叠。
+	 * @param TID 物品的唯一 ID。
+	 * @param Amount 移除数量。
+	 * @return 是否移除成功，物品不足时背包保持不变。
+	 */
+	bool RemoveItemByTID(int32 TID, int32 Amount);
+
+	/**
+	 * 批量添加物品，整批只触发一次更新事件。
+	 * 背包已满时无法叠加到已有堆叠的物品、以及没有配置的物品会被跳过（不触发 ensure）。
+	 * @param Stacks 要添加的物品堆叠。
+	 * @param OutAdded 可选输出，每个堆叠是否被添加（与 `Stacks` 一一对应）。
+	 * @return 成功添加的堆叠数量。
+	 */
+	int32 AddItemStacks(TConstArrayView<FEveItemStack> Stacks, TBitArray<>* OutAdded = nullptr);
+
+	/**
+	 * 是否可以添加该物品（已有堆叠或还有空格子，且不超过负重与体积上限）。
+	 * 只读取增量维护的总计，不遍历背包。
+	 * @param TID 物品的唯一 ID（数据表或外部物品目录中的物品，不会因此生成配置）。
+	 * @param Amount 添加的数量。
+	 */
+	bool CanAddItem(int32 TID, int32 Amount = 1) const;
+
+	/**
+	 * 整批物品能否全部放入背包（如拾取一整包掉落物前的可行性检查）。
+	 * 同一批中重复的 TID 只占用一个新格子；耗时只与批次大小有关，与背包中的物品数量无关。
+	 * @param Stacks 待添加的物品堆叠。
+	 * @return 是否全部可以添加，任何一项无效或超出容量时返回 false。
+	 */
+	bool CanAddItemStacks(TConstArrayView<FEveItemStack> Stacks) const;
+
+	/**
+	 * 已占用的格子数量（已有堆叠 + 被预留的空格子）。
+	 */
+	int32 GetUsedSlotNum() const { return InventoryItems.Num() + ReservedSlotNum; }
+
+	/**
+	 * 预留容量：选取指定数量的空格子并预留负重与体积，释放前普通添加不会占用。
+	 * @param SlotCount 预留的格子数量。
+	 * @param Weight 预留的负重（小于等于 0 时不预留）。
+	 * @param Volume 预留的体积（小于等于 0 时不预留）。
+	 * @param OutReservation 预留结果，需通过 `ReleaseReservation` 释放。
+	 * @return 是否预留成功，失败时不预留任何容量。
+	 */
+	bool ReserveCapacity(int32 SlotCount, float Weight, float Volume, FEveInventoryReservation& OutReservation);
+
+	/**
+	 * 释放预留的容量。
+	 * @param Reservation 由 `ReserveCapacity` 得到的预留，释放后被清空。
+	 */
+	void ReleaseReservation(FEveInventoryReservation& Reservation);
+
+	/**
+	 * 恢复一份已知的预留（日志回放与快照使用），格子与录制时完全相同，不再检查负重与体积上限。
+	 * @param Reservation 要恢复的预留，格子必须在背包范围内、为空、未被预留且互不重复。
+	 * @return 是否恢复成功，失败时不预留任何容量。
+	 */
+	bool RestoreReservation(const FEveInventoryReservation& Reservation);
+
+	/** 当前所有预留的汇总（格子按索引升序） */
+	FEveInventoryReservation GetReservedCapacity() const;
+
+	/** 格子是否被预留 */
+	bool IsSlotReserved(const int32 PosIdx) const
+	{
+		return ReservedSlotBits.IsValidIndex(PosIdx) && ReservedSlotBits[PosIdx];
+	}
+
+	/**
+	 * 在当前总计上再增加指定的重量与体积后是否仍不超过上限（已预留的容量视为已占用）。
+	 * @param AddWeight 增加的重量。
+	 * @param AddVolume 增加的体积。
+	 */
+	bool FitsCapacity(const float AddWeight, const float AddVolume) const
+	{
+		return (MaxWeight <= 0.f || TotalAggregate.Weight + ReservedWeight + AddWeight <= MaxWeight + KINDA_SMALL_NUMBER)
+			&& (MaxVolume <= 0.f || TotalAggregate.Volume + ReservedVolume + AddVolume <= MaxVolume + KINDA_SMALL_NUMBER);
+	}
+
+	/**
+	 * 修改本背包的负重与体积上限（为 0 时不限制），默认值来自配置 `[/Script/EveInventory.EveInventoryMgr]`。
+	 * 已有物品超出新上限时不会被移除，只是之后无法再放入。
+	 * @param InMaxWeight 负重上限。
+	 * @param InMaxVolume 体积上限。
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	void SetCapacityLimits(const float InMaxWeight, const float InMaxVolume)
+	{
+		MaxWeight = FMath::Max(InMaxWeight, 0.f);
+		MaxVolume = FMath::Max(InMaxVolume, 0.f);
+	}
+
+	/**
+	 * 批量移动物品（一次排列），只触发一次更新事件。
+	 * 目标格子上未参与移动的物品会被依次放入空出的源格子，等价于批量交换。
+	 * @param FromPosIdxes 源格子索引（必须有物品，且互不重复）。
+	 * @param ToPosIdxes 目标格子索引（与源一一对应，互不重复，且不能是预留的格子）。
+	 * @return 是否移动成功，校验失败时背包保持不变。
+	 */
+	bool MoveItems(const TArray<int32>& FromPosIdxes, const TArray<int32>& ToPosIdxes);
+
+	/**
+	 * 将一组物品转移到另一个背包，两侧各只触发一次更新事件。
+	 * 目标背包已有相同 TID 时叠加到已有堆叠，否则放入对应的目标格子（必须为空）。
+	 * @param Target 目标背包。
+	 * @param FromPosIdxes 本背包中的源格子索引。
+	 * @param ToPosIdxes 目标背包中的格子索引（与源一一对应）。
+	 * @return 是否转移成功，失败时两侧背包均保持不变。
+	 */
+	bool TransferItemsTo(UEveInventoryMgr* Target, const TArray<int32>& FromPosIdxes, const TArray<int32>& ToPosIdxes);
+
+public:
+	/**
+	 * 将 TID 解析为稠密的配置索引（一次哈希查找），结果可缓存后反复使用。
+	 * @param TID 物品的唯一 ID。
+	 * @return 配置索引，不存在时返回 `INDEX_NONE`。
+	 */
+	int32 FindCfgIdx(const int32 TID) const
+	{
+		const int32* CfgIdx = TIDToCfgIdx.Find(TID);
+		return CfgIdx ? *CfgIdx : INDEX_NONE;
+	}
+
+	/**
+	 * 解析配置索引；数据表中没有、但外部物品目录中有的物品，会在此时按需生成物品配置。
+	 * 添加物品时使用，热路径仍使用 `FindCfgIdx` / 缓存的 `CfgIdx`。
+	 * @param TID 物品的唯一 ID。
+	 * @return 配置索引，不存在时返回 `INDEX_NONE`。
+	 */
+	int32 ResolveCfgIdx(int32 TID);
+
+	/**
+	 * 查询单个物品的重量与体积，供只做校验的路径使用（容量检查、交易与制作的预检、服务端排队）。
+	 * 只读：外部物品目录中的物品直接读取目录行，不生成物品配置，也不广播 `OnItemCfgsChanged`。
+	 * @param TID 物品的唯一 ID。
+	 * @param OutWeight 单个物品的重量。
+	 * @param OutVolume 单个物品的体积。
+	 * @return 物品是否存在（数据表或物品目录中）。
+	 */
+	bool FindItemFootprint(int32 TID, float& OutWeight, float& OutVolume) const;
+
+	/**
+	 * 从外部 CSV 物品目录导入物品（流式导入到紧凑的 `ItemCatalog`，不预先创建物品配置）。
+	 * @param FilePath CSV 文件路径。
+	 * @return 是否导入成功。
+	 */
+	bool ImportItemCatalog(const FString& FilePath);
+
+	/**
+	 * 烘焙的二进制物品目录路径（`Content/Eve/ItemCatalog.evecat`，作为非 UFS 文件打包以便内存映射）。
+	 */
+	static FString GetCookedItemCatalogPath();
+
+	/**
+	 * 通过配置索引获取物品配置（一次数组访问）。
+	 * @param CfgIdx 由 `FindCfgIdx` 解析得到的配置索引。
+	 * @return 物品配置，索引无效时返回 nullptr。
+	 */
+	FORCEINLINE UEveItemCfg* GetCfgByIdx(const int32 CfgIdx) const
+	{
+		return ItemCfgs.IsValidIndex(CfgIdx) ? ItemCfgs[CfgIdx].Get() : nullptr;
+	}
+
+	/**
+	 * 获取某种物品的统计汇总（增量维护，一次哈希查找）。
+	 * @param TID 物品的唯一 ID。
+	 * @return 统计汇总，背包中没有该物品时数量为 0。
+	 */
+	const FEveItemAggregate& GetItemAggregate(const int32 TID) const
+	{
+		static const FEveItemAggregate Empty;
+		const FEveItemAggregate* Aggregate = ItemAggregates.Find(TID);
+		return Aggregate ? *Aggregate : Empty;
+	}
+
+	/**
+	 * 获取整个背包的统计汇总（总重量、总体积、总价值），随物品增减增量更新。
+	 */
+	const FEveItemAggregate& GetTotalAggregate() const { return TotalAggregate; }
+
+	/**
+	 * 编译标签查询条件（筛选页签等在条件或物品配置变化时调用，结果可缓存）。
+	 * @param AnyTags 至少包含其中一个标签。
+	 * @param AllTags 必须包含全部标签。
+	 * @param NoneTags 不能包含其中任何标签。
+	 */
+	FEveItemTagQuery MakeTagQuery(const FGameplayTagContainer& AnyTags, const FGameplayTagContainer& AllTags, const FGameplayTagContainer& NoneTags) const
+	{
+		return ItemTagIndex.MakeQuery(AnyTags, AllTags, NoneTags);
+	}
+
+	/**
+	 * 对所有格子执行标签查询（逐个格子对连续的掩码数组做位运算，不访问物品对象与配置；
+	 * 查询需要退回精确匹配时才读取物品配置的标签容器）。
+	 * @param Query 编译后的查询条件。
+	 * @param OutMatches 每个格子是否匹配（长度为 `SlotNum`，空格子不匹配）。
+	 * @return 匹配的格子数量。
+	 */
+	int32 QuerySlots(const FEveItemTagQuery& Query, TBitArray<>& OutMatches) const;
+
+	/**
+	 * 某种物品是否匹配标签查询。
+	 * @param TID 物品的唯一 ID。
+	 * @param Query 编译后的查询条件。
+	 */
+	bool ItemMatches(const int32 TID, const FEveItemTagQuery& Query) const
+	{
+		const UEveItemCfg* ItemCfg = GetCfgByIdx(FindCfgIdx(TID));
+		if (!ItemCfg) return false;
+		return Query.bNeedsTagFallback ? Query.MatchesTags(ItemCfg->ItemData.Tags) : Query.Matches(ItemCfg->TagBits | FEveItemTagIndex::OccupiedBit);
+	}
+
+	/**
+	 * 通过格子索引获取背包物品（一次数组访问）。
+	 * @param PosIdx 格子索引。
+	 * @return 背包物品，格子为空或越界时返回 nullptr。
+	 */
+	FORCEINLINE UEveInventoryItem* GetSlotItem(const int32 PosIdx) const
+	{
+		return SlotItems.IsValidIndex(PosIdx) ? SlotItems[PosIdx].Get() : nullptr;
+	}
+
+public:
+	/**
+	 * 设置操作记录器，之后每次最外层的修改操作都会写入该日志（不持有日志，为 nullptr 时停止记录）。
+	 */
+	void SetOpRecorder(FEveInventoryOpLog* InOpRecorder) { OpRecorder = InOpRecorder; }
+
+	/** 当前的操作记录器 */
+	FEveInventoryOpLog* GetOpRecorder() const { return OpRecorder; }
+
+	/**
+	 * 检查内部结构的一致性（物品、格子、位置映射、标签掩码与统计汇总互相对应）。
+	 * @param OutError 可选输出，第一个不一致之处。
+	 * @return 是否一致。
+	 */
+	bool CheckInvariants(FString* OutError = nullptr) const;
+
+	/**
+	 * 清空背包中的所有物品，只触发一次更新事件。
+	 */
+	void ResetItems();
+
+	/**
+	 * 不经过子系统集合初始化一个临时背包（回放 / 模糊测试用），共享来源背包的物品配置与物品目录，不监听热重载。
+	 * @param Source 提供物品配置、物品目录与容量上限的背包。
+	 */
+	void InitializeHeadless(const UEveInventoryMgr& Source);
+
+	/**
+	 * 将所有格子打包为紧凑记录（每个格子 8 字节，下标即格子索引）。
+	 * @param OutRecords 输出的记录，长度为 `SlotNum`。
+	 */
+	void PackSlots(TArray<FEveItemSlotRecord>& OutRecords) const;
+
+	/**
+	 * 用紧凑记录替换背包内容（预留标记不恢复），只触发一次更新事件。
+	 * 记录的格子被预留时，该物品在其他记录全部放回原格子之后再放入剩余的空位。
+	 * @param Records 由 `PackSlots` 得到的记录。
+	 * @return 是否成功，配置缺失、TID 重复、超出容量或任何一项添加失败时背包保持不变。
+	 */
+	bool UnpackSlots(TConstArrayView<FEveItemSlotRecord> Records);
+
+	/**
+	 * 输出背包的内存占用：每个格子、每个物品配置按结构拆分，并对比 10 万格子时 UObject 布局与紧凑记录的占用。
+	 */
+	void ReportMemory(FOutputDevice& Ar) const;
+
+public:
+	/**
+	 * 热重载物品配置：逐行对比，只原地更新发生变化的配置并追加新增的配置。
+	 * 配置对象与配置索引保持不变，已有的 `CfgIdx` / `ItemCfg` 引用继续有效；
+	 * 数据表中已删除的行保留原配置（背包中可能仍有该物品），只输出警告。
+	 * @param DataTable 行结构为 `FEveItemData` 的数据表。
+	 * @param bFullTable 是否为完整数据表（为 false 时视为部分覆盖，不检查删除的行）。
+	 * @return 发生变化或新增的配置数量。
+	 */
+	int32 ReloadItemCfgs(const UDataTable* DataTable, bool bFullTable = true);
+
+	/**
+	 * 从 CSV / JSON 覆盖文件热重载物品配置（只包含需要覆盖的行）。
+	 * 已有物品只合并行中提供的列，未提供的列保留当前配置；缺少 `TID` 列的行被拒绝。
+	 * JSON 的 `Name` 键只作为行名，不会覆盖物品名称。
+	 * @param FilePath 覆盖文件路径。
+	 * @return 是否成功读取并应用。
+	 */
+	bool ReloadItemCfgsFromFile(const FString& FilePath);
+
+	/**
+	 * 物品配置覆盖文件，非 Shipping 版本下定期检查修改时间，变化时自动热重载。
+	 */
+	FString ItemOverridePath = FPaths::ProjectSavedDir() / TEXT("Eve/ItemOverrides.json");
+
+	/**
+	 * 检查覆盖文件的间隔（秒）。
+	 */
+	float ItemOverridePollInterval = 1.f;
+
+public:
+	/**
+	 * 开始批量修改，期间的更新事件会被合并，直到最外层 `EndBatch` 时只广播一次。
+	 */
+	void BeginBatch();
+
+	/**
+	 * 结束批量修改，如有未广播的修改则触发一次更新事件。
+	 */
+	void EndBatch();
+
+protected:
+	/**
+	 * 通知背包已更新：批量修改期间只记录，否则立即广播。
+	 */
+	void NotifyInventoryUpdated();
+
+	/**
+	 * 记录发生变化的格子，随下一次更新事件一起广播。
+	 * @param PosIdx 格子索引。
+	 */
+	void MarkSlotDirty(int32 PosIdx);
+
+private:
+	/**
+	 * 广播格子增量与整体更新事件。
+	 */
+	void BroadcastInventoryUpdated();
+
+	/**
+	 * 按物品当前数量与配置重新计算该 TID 的统计汇总，并增量更新背包总计。
+	 * 物品数量或配置变化后调用。
+	 */
+	void RefreshItemAggregate(int32 TID);
+
+	/**
+	 * 将物品配置的标签编译为掩码，写入 `UEveItemCfg::TagBits`。
+	 */
+	void CompileItemTags(UEveItemCfg* ItemCfg);
+
+	/**
+	 * 在外部物品目录中查找物品（导入的目录优先于烘焙的目录，临时背包最后查来源背包的目录）。
+	 */
+	bool FindCatalogRow(int32 TID, FEveItemCatalogRow& OutRow) const;
+
+	/**
+	 * 格子中物品的标签掩码（含占用位），空格子为 0。
+	 */
+	uint64 GetSlotTagBits(const UEveInventoryItem* Item) const;
+
+	/**
+	 * 编辑器中数据表被修改或重新导入时热重载。
+	 */
+	void HandleDataTableChanged();
+
+	/**
+	 * 定期检查覆盖文件，修改时间变化时热重载。
+	 */
+	bool TickItemOverrideWatch(float DeltaTime);
+
 public:
 	/**
 	 * 物品数据表，存储所有物品的配置信息。
@@ -81,6 +495,27 @@ public:
 	UPROPERTY()
 	TMap<int32, TObjectPtr<UEveItemCfg>> AllItemsCfg;
 
+	/**
+	 * 稠密的物品配置数组，下标即配置索引（`CfgIdx`），热路径通过 `GetCfgByIdx` 访问。
+	 */
+	UPROPERTY()
+	TArray<TObjectPtr<UEveItemCfg>> ItemCfgs;
+
+	/**
+	 * TID 到配置索引的映射。
+	 */
+	TMap<int32, int32> TIDToCfgIdx;
+
+	/**
+	 * 外部导入的紧凑物品目录，物品第一次进入背包时才生成对应的物品配置。
+	 */
+	FEveItemCatalog ItemCatalog;
+
+	/**
+	 * 烘焙的二进制物品目录（内存映射，只读），由 `Eve.CookItemCatalog` 生成。
+	 */
+	FEveItemCatalogFile CookedItemCatalog;
+
 	/**
 	 * 当前背包中存储的物品，键为 TID，值为对应的物品对象。
 	 */
@@ -92,6 +527,12 @@ public:
 	 */
 	TMap<int32, int32> PosToTIDMap;
 
+	/**
+	 * 按格子索引存放的背包物品（空格子为 nullptr），与 `PosToTIDMap` 同步维护。
+	 */
+	UPROPERTY()
+	TArray<TObjectPtr<UEveInventoryItem>> SlotItems;
+
 	/**
 	 * 当前已被占用的格子索引集合。
 	 */
@@ -102,6 +543,18 @@ public:
 	 */
 	const int32 SlotNum = 6;
 
+	/**
+	 * 背包的负重上限（为 0 时不限制），可在 `DefaultGame.ini` 中配置，或通过 `SetCapacityLimits` 按背包修改。
+	 */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Inventory")
+	float MaxWeight = 0.f;
+
+	/**
+	 * 背包的体积上限（为 0 时不限制），可在 `DefaultGame.ini` 中配置，或通过 `SetCapacityLimits` 按背包修改。
+	 */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Inventory")
+	float MaxVolume = 0.f;
+
 	/**
 	 * 记录最近添加的物品 ID（用于支持撤销移除功能）。
 	 */
@@ -111,4 +564,79 @@ public:
 	 * 记录已添加的物品 ID，避免重复添加。
 	 */
 	TSet<int32> AddedItemsSet;
+
+private:
+	/** 被预留的格子（不参与自动寻找空位） */
+	TBitArray<> ReservedSlotBits;
+
+	/** 被预留的格子数量 */
+	int32 ReservedSlotNum = 0;
+
+	/** 被预留的负重与体积 */
+	float ReservedWeight = 0.f;
+	float ReservedVolume = 0.f;
+
+	/** 批量修改的嵌套深度 */
+	int32 BatchDepth = 0;
+
+	/** 操作记录器（不持有） */
+	FEveInventoryOpLog* OpRecorder = nullptr;
+
+	/** 操作的嵌套深度，只记录最外层操作 */
+	int32 OpRecordDepth = 0;
+
+	/** 批量修改期间是否有未广播的更新 */
+	bool bPendingUpdate = false;
+
+	/** 待广播的变化格子索引 */
+	TArray<int32> DirtyPosIdxes;
+
+	/** 变化格子的去重标记（按格子索引） */
+	TBitArray<> DirtySlotBits;
+
+	/** 物品标签位索引 */
+	FEveItemTagIndex ItemTagIndex;
+
+	/** 每个格子中物品的标签掩码（与 `SlotItems` 一一对应），标签查询只扫描该数组 */
+	TArray<uint64> SlotTagBits;
+
+	/** 每种物品的统计汇总 */
+	TMap<int32, FEveItemAggregate> ItemAggregates;
+
+	/** 整个背包的统计汇总 */
+	FEveItemAggregate TotalAggregate;
+
+	/** 当前使用的物品数据表（监听其修改事件） */
+	TWeakObjectPtr<UDataTable> ItemDataTable;
+
+	/** 临时背包共享其物品目录的来源背包（目录不可复制，直接转查） */
+	TWeakObjectPtr<const UEveInventoryMgr> CatalogSource;
+
+	/** 覆盖文件检查的 Ticker 句柄 */
+	FTSTicker::FDelegateHandle ItemOverrideWatchHandle;
+
+	/** 上次应用的覆盖文件修改时间 */
+	FDateTime ItemOverrideTimeStamp = FDateTime::MinValue();
+};
+
+/**
+ * 批量修改作用域（RAII），作用域内的所有修改只触发一次 `OnInventoryUpdated`。
+ */
+struct FEveInventoryBatchScope
+{
+	explicit FEveInventoryBatchScope(UEveInventoryMgr* InInventory)
+		: Inventory(InInventory)
+	{
+		if (Inventory) Inventory->BeginBatch();
+	}
+
+	~FEveInventoryBatchScope()
+	{
+		if (Inventory) Inventory->EndBatch();
+	}
+
+	UE_NONCOPYABLE(FEveInventoryBatchScope);
+
+private:
+	UEveInventoryMgr* Inventory;
 };
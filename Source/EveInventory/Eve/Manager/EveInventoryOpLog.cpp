@@ -0,0 +1,620 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#include "EveInventoryOpLog.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeExit.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "UObject/StrongObjectPtr.h"
+#include "UObject/UObjectGlobals.h"
+#include "EveInventory/EveInventory.h"
+#include "EveInventory/Eve/Manager/EveInventoryMgr.h"
+
+#if !UE_BUILD_SHIPPING
+namespace EveInventoryOpLog
+{
+    /** 控制台命令录制的日志 */
+    FEveInventoryOpLog RecordedLog;
+
+    /** 模糊测试每隔多少次操作回收一次垃圾（不计入耗时） */
+    constexpr int32 FuzzGCInterval = 200000;
+
+    UEveInventoryMgr* GetInventory(const UWorld* World)
+    {
+        const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+        return GameInstance ? GameInstance->GetSubsystem<UEveInventoryMgr>() : nullptr;
+    }
+
+    /** 创建共享配置、没有界面的临时背包 */
+    TStrongObjectPtr<UEveInventoryMgr> MakeHeadlessInventory(const UEveInventoryMgr& Source)
+    {
+        TStrongObjectPtr<UEveInventoryMgr> Inventory(NewObject<UEveInventoryMgr>(Source.GetGameInstance()));
+        Inventory->InitializeHeadless(Source);
+        return Inventory;
+    }
+
+    /** 模糊测试同时持有的预留数量上限 */
+    constexpr int32 FuzzMaxReservations = 4;
+
+    /**
+     * 随机执行一次操作。
+     * 会触发 `ensure` 的调用（格子已满、物品不存在等）先按界面的方式检查，其余操作允许无效参数：
+     * 批量移动与转移会使用越界（-1 与 `SlotNum`）和重复的格子，这两个接口不触发 `ensure`，必须拒绝并保持背包不变。
+     * @param Inventory 被录制的背包。
+     * @param Other 转移物品的另一个背包（不录制，物品双向转移）。
+     * @param Reservations 当前持有的预留。
+     */
+    void FuzzStep(UEveInventoryMgr& Inventory, UEveInventoryMgr& Other, TArray<FEveInventoryReservation>& Reservations, FRandomStream& Random, const TArray<int32>& TIDs)
+    {
+        auto RandomTID = [&Random, &TIDs]() { return TIDs[Random.RandHelper(TIDs.Num())]; };
+        auto RandomSlotItem = [&Random, &Inventory]() { return Inventory.GetSlotItem(Random.RandHelper(Inventory.SlotNum)); };
+        auto RandomPosIdx = [&Random](const UEveInventoryMgr& Target) { return Random.RandRange(-1, Target.SlotNum); };
+
+        switch (Random.RandHelper(11))
+        {
+        case 0:
+        case 1:
+        {
+            const int32 TID = RandomTID();
+            const int32 Amount = Random.RandRange(1, 10);
+            if (!Inventory.CanAddItem(TID, Amount)) return;
+
+            int32 PosIdx = Random.RandRange(-1, Inventory.SlotNum - 1);
+            if (PosIdx != -1 && !Inventory.InventoryItems.Contains(TID) && (Inventory.CurPosIdxes.Contains(PosIdx) || Inventory.IsSlotReserved(PosIdx)))
+            {
+                PosIdx = -1;
+            }
+            Inventory.AddItemByTID(TID, Amount, PosIdx);
+            break;
+        }
+        case 2:
+            if (const UEveInventoryItem* Item = RandomSlotItem())
+            {
+                Inventory.RemoveItem(Item->TID);
+            }
+            break;
+        case 3:
+            Inventory.RemoveItemByTID(RandomTID(), Random.RandRange(1, 10));
+            break;
+        case 4:
+        {
+            const UEveInventoryItem* ItemA = RandomSlotItem();
+            const UEveInventoryItem* ItemB = RandomSlotItem();
+            if (ItemA && ItemB && ItemA != ItemB)
+            {
+                Inventory.ExchangeItem(ItemA->PosIdx, ItemB->PosIdx);
+            }
+            break;
+        }
+        case 5:
+        case 6:
+        {
+            const int32 Num = Random.RandRange(1, 3);
+            TArray<int32> FromPosIdxes;
+            TArray<int32> ToPosIdxes;
+            for (int32 Idx = 0; Idx < Num; Idx++)
+            {
+                FromPosIdxes.Add(RandomPosIdx(Inventory));
+                ToPosIdxes.Add(RandomPosIdx(Inventory));
+            }
+            Inventory.MoveItems(FromPosIdxes, ToPosIdxes);
+            break;
+        }
+        case 7:
+        {
+            // 双向转移，避免另一个背包被填满；源格子可能重复或越界
+            const bool bToOther = Random.RandHelper(2) == 0;
+            UEveInventoryMgr& Source = bToOther ? Inventory : Other;
+            UEveInventoryMgr& Target = bToOther ? Other : Inventory;
+
+            const int32 Num = Random.RandRange(1, 3);
+            TArray<int32> FromPosIdxes;
+            TArray<int32> ToPosIdxes;
+            for (int32 Idx = 0; Idx < Num; Idx++)
+            {
+                FromPosIdxes.Add(Idx > 0 && Random.RandHelper(4) == 0 ? FromPosIdxes[0] : RandomPosIdx(Source));
+                ToPosIdxes.Add(RandomPosIdx(Target));
+            }
+            Source.TransferItemsTo(&Target, FromPosIdxes, ToPosIdxes);
+            break;
+        }
+        case 8:
+        {
+            if (Reservations.Num() >= FuzzMaxReservations) return;
+
+            FEveInventoryReservation Reservation;
+            if (Inventory.ReserveCapacity(Random.RandRange(0, 2), Random.RandRange(0, 5), Random.RandRange(0, 5), Reservation))
+            {
+                Reservations.Add(MoveTemp(Reservation));
+            }
+            break;
+        }
+        case 9:
+            if (Reservations.Num() > 0)
+            {
+                const int32 Idx = Random.RandHelper(Reservations.Num());
+                Inventory.ReleaseReservation(Reservations[Idx]);
+                Reservations.RemoveAtSwap(Idx);
+            }
+            break;
+        default:
+        {
+            TArray<FEveItemStack, TInlineAllocator<4>> Stacks;
+            for (int32 Idx = Random.RandRange(1, 4); Idx > 0; Idx--)
+            {
+                Stacks.Emplace(RandomTID(), Random.RandRange(0, 10));
+            }
+            Inventory.AddItemStacks(Stacks);
+            break;
+        }
+        }
+    }
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GEveRecordInventoryLogCmd(
+    TEXT("Eve.RecordInventoryLog"),
+    TEXT("Record every inventory operation into a binary log. Usage: Eve.RecordInventoryLog Start | Stop [File.evelog]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        UEveInventoryMgr* InventoryMgr = EveInventoryOpLog::GetInventory(World);
+        if (!InventoryMgr || Args.Num() < 1) return;
+
+        FEveInventoryOpLog& Log = EveInventoryOpLog::RecordedLog;
+        if (Args[0].Equals(TEXT("Start"), ESearchCase::IgnoreCase))
+        {
+            Log.Reset();
+            Log.RecordSnapshot(*InventoryMgr);
+            InventoryMgr->SetOpRecorder(&Log);
+            UE_LOG(LogEveInventory, Display, TEXT("Recording inventory operations"));
+            return;
+        }
+
+        InventoryMgr->SetOpRecorder(nullptr);
+        const FString FilePath = Args.Num() > 1 ? Args[1] : FPaths::ProjectSavedDir() / TEXT("Eve/Inventory.evelog");
+        if (Log.SaveToFile(FilePath))
+        {
+            UE_LOG(LogEveInventory, Display, TEXT("Saved %d operation(s), %d byte(s) to %s"), Log.Num(), Log.GetDataSize(), *FilePath);
+        }
+    }));
+
+static FAutoConsoleCommandWithWorldAndArgs GEveReplayInventoryLogCmd(
+    TEXT("Eve.ReplayInventoryLog"),
+    TEXT("Replay a binary inventory log with invariant checks on a headless inventory. Usage: Eve.ReplayInventoryLog <File.evelog> [Live=0]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        UEveInventoryMgr* InventoryMgr = EveInventoryOpLog::GetInventory(World);
+        if (!InventoryMgr || Args.Num() < 1) return;
+
+        FEveInventoryOpLog Log;
+        FString Error;
+        if (!Log.LoadFromFile(Args[0], &Error))
+        {
+            UE_LOG(LogEveInventory, Warning, TEXT("Failed to load %s: %s"), *Args[0], *Error);
+            return;
+        }
+
+        // 默认回放到临时背包，不影响玩家背包与界面
+        const bool bLive = Args.Num() > 1 && FCString::Atoi(*Args[1]) != 0;
+        TStrongObjectPtr<UEveInventoryMgr> Headless;
+        if (!bLive)
+        {
+            Headless = EveInventoryOpLog::MakeHeadlessInventory(*InventoryMgr);
+        }
+
+        const double StartTime = FPlatformTime::Seconds();
+        int32 OpNum = 0;
+        const bool bSucceeded = Log.Replay(bLive ? *InventoryMgr : *Headless, true, &OpNum, &Error);
+        const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+        if (bSucceeded)
+        {
+            UE_LOG(LogEveInventory, Display, TEXT("Replayed %d operation(s) in %.2f ms"), OpNum, Seconds * 1000.0);
+        }
+        else
+        {
+            UE_LOG(LogEveInventory, Error, TEXT("Replay failed at operation %d: %s"), OpNum, *Error);
+        }
+    }));
+
+static FAutoConsoleCommandWithWorldAndArgs GEveFuzzInventoryCmd(
+    TEXT("Eve.FuzzInventory"),
+    TEXT("Run random operations on a headless inventory with invariant checks. Usage: Eve.FuzzInventory [Ops=1000000] [Seed=0] [CheckInvariants=1] [MinOpsPerSec=0]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        const UEveInventoryMgr* InventoryMgr = EveInventoryOpLog::GetInventory(World);
+        if (!InventoryMgr) return;
+
+        const int32 OpNum = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000000;
+        const int32 Seed = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 0;
+        const bool bCheckInvariants = Args.Num() > 2 ? FCString::Atoi(*Args[2]) != 0 : true;
+        const double MinOpsPerSec = Args.Num() > 3 ? FCString::Atod(*Args[3]) : 0.0;
+
+        TArray<int32> TIDs;
+        InventoryMgr->TIDToCfgIdx.GetKeys(TIDs);
+        if (TIDs.Num() == 0) return;
+        TIDs.Sort();
+
+        // 同时录制日志，失败时保存以便回放复现
+        TStrongObjectPtr<UEveInventoryMgr> Inventory = EveInventoryOpLog::MakeHeadlessInventory(*InventoryMgr);
+        TStrongObjectPtr<UEveInventoryMgr> Other = EveInventoryOpLog::MakeHeadlessInventory(*InventoryMgr);
+        TArray<FEveInventoryReservation> Reservations;
+        FEveInventoryOpLog Log;
+        Log.RecordSnapshot(*Inventory);
+        Inventory->SetOpRecorder(&Log);
+        ON_SCOPE_EXIT { Inventory->SetOpRecorder(nullptr); };
+
+        FRandomStream Random(Seed);
+        FString Error;
+        int32 FailedOp = INDEX_NONE;
+        double Seconds = 0.0;
+        double StartTime = FPlatformTime::Seconds();
+        for (int32 OpIdx = 0; OpIdx < OpNum; OpIdx++)
+        {
+            EveInventoryOpLog::FuzzStep(*Inventory, *Other, Reservations, Random, TIDs);
+            if (bCheckInvariants && (!Inventory->CheckInvariants(&Error) || !Other->CheckInvariants(&Error)))
+            {
+                FailedOp = OpIdx;
+                break;
+            }
+
+            if ((OpIdx + 1) % EveInventoryOpLog::FuzzGCInterval == 0)
+            {
+                Seconds += FPlatformTime::Seconds() - StartTime;
+                CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+                StartTime = FPlatformTime::Seconds();
+            }
+        }
+        Seconds += FPlatformTime::Seconds() - StartTime;
+
+        if (FailedOp != INDEX_NONE)
+        {
+            const FString FilePath = FPaths::ProjectSavedDir() / FString::Printf(TEXT("Eve/FuzzFailure_%d.evelog"), Seed);
+            Log.SaveToFile(FilePath);
+            UE_LOG(LogEveInventory, Error, TEXT("Fuzz seed %d broke an invariant after operation %d: %s (log: %s)"), Seed, FailedOp, *Error, *FilePath);
+            return;
+        }
+
+        const double OpsPerSec = OpNum / FMath::Max(Seconds, UE_DOUBLE_SMALL_NUMBER);
+        UE_LOG(LogEveInventory, Display, TEXT("Fuzz seed %d: %d operation(s) in %.2f ms, %.2f M ops/s%s, log %d byte(s)"),
+            Seed, OpNum, Seconds * 1000.0, OpsPerSec / 1e6, bCheckInvariants ? TEXT(" with invariant checks") : TEXT(""), Log.GetDataSize());
+        if (OpsPerSec < MinOpsPerSec)
+        {
+            UE_LOG(LogEveInventory, Error, TEXT("Fuzz throughput regression: %.0f ops/s < %.0f ops/s"), OpsPerSec, MinOpsPerSec);
+        }
+    }));
+#endif
+
+/** 浮点数按位模式存为参数，回放时得到完全相同的值 */
+static int32 FloatToArg(const float Value)
+{
+    int32 Arg;
+    FMemory::Memcpy(&Arg, &Value, sizeof(Arg));
+    return Arg;
+}
+
+static float ArgToFloat(const int32 Arg)
+{
+    float Value;
+    FMemory::Memcpy(&Value, &Arg, sizeof(Value));
+    return Value;
+}
+
+/**
+ * 追加一条操作。
+ */
+void FEveInventoryOpLog::Record(const EEveInventoryOp Op, const TConstArrayView<int32> Args)
+{
+    Data.Add(static_cast<uint8>(Op));
+    WriteVarInt(Data, Args.Num());
+    for (const int32 Arg : Args)
+    {
+        WriteVarInt(Data, Arg);
+    }
+    OpNum++;
+}
+
+/**
+ * 以背包的当前内容开头。
+ */
+void FEveInventoryOpLog::RecordSnapshot(const UEveInventoryMgr& Inventory)
+{
+    Record(EEveInventoryOp::ResetItems, TConstArrayView<int32>());
+    for (int32 PosIdx = 0; PosIdx < Inventory.SlotNum; PosIdx++)
+    {
+        if (const UEveInventoryItem* Item = Inventory.GetSlotItem(PosIdx))
+        {
+            Record(EEveInventoryOp::AddItemByTID, { Item->TID, Item->Amount, PosIdx });
+        }
+    }
+
+    // 进行中的预留（如未完成的交易）合并为一条，回放时占用相同的格子，之后的自动寻位才与录制时一致
+    const FEveInventoryReservation Reserved = Inventory.GetReservedCapacity();
+    if (!Reserved.IsEmpty())
+    {
+        RecordReservation(EEveInventoryOp::ReserveCapacity, Reserved);
+    }
+}
+
+/**
+ * 追加一条预留或释放操作。
+ */
+void FEveInventoryOpLog::RecordReservation(const EEveInventoryOp Op, const FEveInventoryReservation& Reservation)
+{
+    TArray<int32, TInlineAllocator<16>> Args;
+    Args.Add(FloatToArg(Reservation.Weight));
+    Args.Add(FloatToArg(Reservation.Volume));
+    Args.Append(Reservation.PosIdxes);
+    Record(Op, Args);
+}
+
+/**
+ * 从参数中读取预留。
+ */
+bool FEveInventoryOpLog::ReadReservation(const TConstArrayView<int32> Args, FEveInventoryReservation& OutReservation)
+{
+    if (Args.Num() < 2) return false;
+
+    OutReservation.Weight = ArgToFloat(Args[0]);
+    OutReservation.Volume = ArgToFloat(Args[1]);
+    if (!(OutReservation.Weight >= 0.f) || !(OutReservation.Volume >= 0.f)) return false; // 负数或 NaN
+
+    OutReservation.PosIdxes.Append(Args.GetData() + 2, Args.Num() - 2);
+    return true;
+}
+
+/**
+ * 在背包上回放日志。
+ */
+bool FEveInventoryOpLog::Replay(UEveInventoryMgr& Inventory, const bool bCheckInvariants, int32* OutOpNum, FString* OutError) const
+{
+    // 回放的操作不写回任何日志
+    FEveInventoryOpLog* Recorder = Inventory.GetOpRecorder();
+    Inventory.SetOpRecorder(nullptr);
+    ON_SCOPE_EXIT { Inventory.SetOpRecorder(Recorder); };
+
+    FEveInventoryBatchScope Batch(&Inventory);
+
+    const uint8* Cursor = Data.GetData();
+    const uint8* End = Cursor + Data.Num();
+    TArray<int32, TInlineAllocator<16>> Args;
+    int32 OpIdx = 0;
+
+    auto Fail = [&OpIdx, OutOpNum, OutError](const FString& Error)
+    {
+        if (OutOpNum) *OutOpNum = OpIdx;
+        if (OutError) *OutError = Error;
+        return false;
+    };
+
+    for (; Cursor < End; OpIdx++)
+    {
+        const uint8 OpByte = *Cursor++;
+        int32 ArgNum;
+        if (OpByte >= static_cast<uint8>(EEveInventoryOp::Num) || !ReadVarInt(Cursor, End, ArgNum) || ArgNum < 0 || ArgNum > End - Cursor)
+        {
+            return Fail(TEXT("Corrupted log"));
+        }
+
+        Args.Reset();
+        for (int32 Idx = 0; Idx < ArgNum; Idx++)
+        {
+            if (!ReadVarInt(Cursor, End, Args.AddDefaulted_GetRef())) return Fail(TEXT("Corrupted log"));
+        }
+
+        const EEveInventoryOp Op = static_cast<EEveInventoryOp>(OpByte);
+        if (!ApplyOp(Inventory, Op, Args))
+        {
+            return Fail(FString::Printf(TEXT("Malformed operation %s"), *DescribeOp(Op, Args)));
+        }
+
+        FString Error;
+        if (bCheckInvariants && !Inventory.CheckInvariants(&Error))
+        {
+            return Fail(FString::Printf(TEXT("%s broke an invariant: %s"), *DescribeOp(Op, Args), *Error));
+        }
+    }
+
+    if (OutOpNum) *OutOpNum = OpIdx;
+    return true;
+}
+
+/**
+ * 执行一条操作。
+ * 录制时只有通过校验的调用才会写入日志，因此参数个数不符、参数在当前背包上会触发 `ensure`（格子越界、格子为空、
+ * 物品不存在、超出容量等）或操作本身失败时返回 false，这样的操作只可能来自损坏或手工修改的日志。
+ */
+bool FEveInventoryOpLog::ApplyOp(UEveInventoryMgr& Inventory, const EEveInventoryOp Op, const TConstArrayView<int32> Args)
+{
+    switch (Op)
+    {
+    case EEveInventoryOp::ResetItems:
+        if (Args.Num() != 0) return false;
+        Inventory.ResetItems();
+        return true;
+    case EEveInventoryOp::AddItemByTID:
+    {
+        if (Args.Num() != 3) return false;
+
+        // 与 `AddItemByTID` 中的 ensure 一一对应
+        const int32 TID = Args[0];
+        const int32 Amount = Args[1];
+        const int32 PosIdx = Args[2];
+        if (Amount <= 0 || PosIdx < -1 || PosIdx >= Inventory.SlotNum) return false;
+        if (!Inventory.CanAddItem(TID, Amount)) return false;
+        if (PosIdx != -1 && !Inventory.InventoryItems.Contains(TID) && (Inventory.CurPosIdxes.Contains(PosIdx) || Inventory.IsSlotReserved(PosIdx))) return false;
+
+        return Inventory.AddItemByTID(TID, Amount, PosIdx);
+    }
+    case EEveInventoryOp::RemoveItem:
+        if (Args.Num() != 1 || !Inventory.InventoryItems.Contains(Args[0])) return false;
+        Inventory.RemoveItem(Args[0]);
+        return true;
+    case EEveInventoryOp::RemoveItemByTID:
+        if (Args.Num() != 2 || Args[1] <= 0) return false;
+        return Inventory.RemoveItemByTID(Args[0], Args[1]);
+    case EEveInventoryOp::ExchangeItem:
+    {
+        if (Args.Num() != 2) return false;
+
+        // 两个格子都必须在范围内、有物品且未被预留
+        const int32 OldPosIdx = Args[0];
+        const int32 NewPosIdx = Args[1];
+        if (OldPosIdx < 0 || OldPosIdx >= Inventory.SlotNum || NewPosIdx < 0 || NewPosIdx >= Inventory.SlotNum) return false;
+        if (!Inventory.CurPosIdxes.Contains(OldPosIdx) || !Inventory.CurPosIdxes.Contains(NewPosIdx)) return false;
+        if (Inventory.IsSlotReserved(OldPosIdx) || Inventory.IsSlotReserved(NewPosIdx)) return false;
+
+        Inventory.ExchangeItem(OldPosIdx, NewPosIdx);
+        return true;
+    }
+    case EEveInventoryOp::MoveItems:
+    {
+        // 越界、重复等参数由 `MoveItems` 自己校验，不触发 `ensure`
+        if (Args.Num() % 2 != 0) return false;
+        const int32 Half = Args.Num() / 2;
+        return Inventory.MoveItems(TArray<int32>(Args.GetData(), Half), TArray<int32>(Args.GetData() + Half, Half));
+    }
+    case EEveInventoryOp::AddItemStacks:
+    {
+        if (Args.Num() % 2 != 0) return false;
+        TArray<FEveItemStack, TInlineAllocator<8>> Stacks;
+        for (int32 Idx = 0; Idx < Args.Num(); Idx += 2)
+        {
+            Stacks.Emplace(Args[Idx], Args[Idx + 1]);
+        }
+        Inventory.AddItemStacks(Stacks);
+        return true;
+    }
+    case EEveInventoryOp::ReserveCapacity:
+    {
+        // 录制的是预留成功后的结果，同样的状态下恢复不可能失败
+        FEveInventoryReservation Reservation;
+        return ReadReservation(Args, Reservation) && Inventory.RestoreReservation(Reservation);
+    }
+    case EEveInventoryOp::ReleaseReservation:
+    {
+        FEveInventoryReservation Reservation;
+        if (!ReadReservation(Args, Reservation)) return false;
+        for (const int32 PosIdx : Reservation.PosIdxes)
+        {
+            if (!Inventory.IsSlotReserved(PosIdx)) return false;
+        }
+
+        Inventory.ReleaseReservation(Reservation);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+/**
+ * 保存到文件。
+ */
+bool FEveInventoryOpLog::SaveToFile(const FString& FilePath) const
+{
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+
+    uint32 FileMagic = Magic;
+    uint32 FileVersion = Version;
+    int32 FileOpNum = OpNum;
+    Writer << FileMagic << FileVersion << FileOpNum;
+    Bytes.Append(Data);
+
+    return FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+}
+
+/**
+ * 从文件读取。
+ */
+bool FEveInventoryOpLog::LoadFromFile(const FString& FilePath, FString* OutError)
+{
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *FilePath))
+    {
+        if (OutError) *OutError = TEXT("Cannot read file");
+        return false;
+    }
+
+    FMemoryReader Reader(Bytes);
+    uint32 FileMagic = 0;
+    uint32 FileVersion = 0;
+    int32 FileOpNum = 0;
+    Reader << FileMagic << FileVersion << FileOpNum;
+    if (Reader.IsError() || FileMagic != Magic || FileVersion != Version)
+    {
+        if (OutError) *OutError = TEXT("Not an inventory log or unsupported version");
+        return false;
+    }
+
+    const int32 HeaderSize = Reader.Tell();
+    Data.Reset(Bytes.Num() - HeaderSize);
+    Data.Append(Bytes.GetData() + HeaderSize, Bytes.Num() - HeaderSize);
+    OpNum = FileOpNum;
+    return true;
+}
+
+/**
+ * 清空日志。
+ */
+void FEveInventoryOpLog::Reset()
+{
+    Data.Reset();
+    OpNum = 0;
+}
+
+/**
+ * 操作的可读描述。
+ */
+FString FEveInventoryOpLog::DescribeOp(const EEveInventoryOp Op, const TConstArrayView<int32> Args)
+{
+    static const TCHAR* OpNames[] = { TEXT("ResetItems"), TEXT("AddItemByTID"), TEXT("RemoveItem"), TEXT("RemoveItemByTID"), TEXT("ExchangeItem"), TEXT("MoveItems"), TEXT("AddItemStacks"), TEXT("ReserveCapacity"), TEXT("ReleaseReservation") };
+    static_assert(UE_ARRAY_COUNT(OpNames) == static_cast<int32>(EEveInventoryOp::Num), "OpNames must match EEveInventoryOp");
+
+    TStringBuilder<128> Builder;
+    Builder << (Op < EEveInventoryOp::Num ? OpNames[static_cast<uint8>(Op)] : TEXT("Unknown")) << TEXT("(");
+    for (int32 Idx = 0; Idx < Args.Num(); Idx++)
+    {
+        Builder << (Idx > 0 ? TEXT(", ") : TEXT("")) << Args[Idx];
+    }
+    Builder << TEXT(")");
+    return FString(Builder.ToString());
+}
+
+/**
+ * 写入 ZigZag 变长整数（小的正负数都只占 1 字节）。
+ */
+void FEveInventoryOpLog::WriteVarInt(TArray<uint8>& Out, const int32 Value)
+{
+    uint32 Encoded = (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+    while (Encoded >= 0x80)
+    {
+        Out.Add(static_cast<uint8>(Encoded | 0x80));
+        Encoded >>= 7;
+    }
+    Out.Add(static_cast<uint8>(Encoded));
+}
+
+/**
+ * 读取 ZigZag 变长整数。
+ */
+bool FEveInventoryOpLog::ReadVarInt(const uint8*& Cursor, const uint8* End, int32& OutValue)
+{
+    uint32 Encoded = 0;
+    for (int32 Shift = 0; Shift < 35; Shift += 7)
+    {
+        if (Cursor >= End) return false;
+
+        const uint8 Byte = *Cursor++;
+        Encoded |= static_cast<uint32>(Byte & 0x7F) << Shift;
+        if ((Byte & 0x80) == 0)
+        {
+            OutValue = static_cast<int32>(Encoded >> 1) ^ -static_cast<int32>(Encoded & 1);
+            return true;
+        }
+    }
+    return false;
+}
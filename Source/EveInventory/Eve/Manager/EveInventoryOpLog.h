@@ -0,0 +1,146 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UEveInventoryMgr;
+struct FEveInventoryReservation;
+
+/**
+ * 背包操作类型（写入日志，只能在末尾追加）。
+ */
+enum class EEveInventoryOp : uint8
+{
+	/** 清空背包 */
+	ResetItems,
+	/** [TID, Amount, PosIdx] */
+	AddItemByTID,
+	/** [TID] */
+	RemoveItem,
+	/** [TID, Amount] */
+	RemoveItemByTID,
+	/** [OldPosIdx, NewPosIdx] */
+	ExchangeItem,
+	/** [From..., To...]（前后两半） */
+	MoveItems,
+	/** [TID, Amount, TID, Amount, ...] */
+	AddItemStacks,
+	/** [Weight, Volume, PosIdx...]（预留成功后的结果，负重与体积按浮点位模式存储） */
+	ReserveCapacity,
+	/** [Weight, Volume, PosIdx...] */
+	ReleaseReservation,
+	Num,
+};
+
+/**
+ * 背包操作日志（紧凑二进制）。
+ * 
+ * 每条操作为 1 字节类型 + 变长参数个数 + ZigZag 变长整数参数，常见操作只占 4~5 字节。
+ * 日志以当前背包的快照开头，可以在任意背包（包括无界面的临时背包）上确定地回放。
+ */
+class FEveInventoryOpLog
+{
+public:
+	/** 文件头标识与版本 */
+	static constexpr uint32 Magic = 0x4C4F5645; // "EVOL"
+	static constexpr uint32 Version = 1;
+
+	/**
+	 * 追加一条操作。
+	 */
+	void Record(EEveInventoryOp Op, TConstArrayView<int32> Args);
+
+	/**
+	 * 追加一条预留或释放操作。
+	 * @param Op `ReserveCapacity` 或 `ReleaseReservation`。
+	 * @param Reservation 预留的格子、负重与体积。
+	 */
+	void RecordReservation(EEveInventoryOp Op, const FEveInventoryReservation& Reservation);
+
+	/**
+	 * 以背包的当前内容开头（清空 + 逐格添加 + 进行中的预留），使日志可以独立回放。
+	 */
+	void RecordSnapshot(const UEveInventoryMgr& Inventory);
+
+	/**
+	 * 在背包上回放日志，回放期间背包的记录器被暂时移除，更新事件合并为一次。
+	 * @param Inventory 回放的目标背包。
+	 * @param bCheckInvariants 是否在每条操作后检查背包一致性。
+	 * @param OutOpNum 可选输出，成功回放的操作数量（失败时为出错操作的序号）。
+	 * @param OutError 可选输出，失败原因。
+	 * @return 是否全部回放成功且一致性检查通过。
+	 */
+	bool Replay(UEveInventoryMgr& Inventory, bool bCheckInvariants, int32* OutOpNum = nullptr, FString* OutError = nullptr) const;
+
+	/** 保存到文件 */
+	bool SaveToFile(const FString& FilePath) const;
+
+	/** 从文件读取 */
+	bool LoadFromFile(const FString& FilePath, FString* OutError = nullptr);
+
+	/** 清空日志 */
+	void Reset();
+
+	/** 操作数量 */
+	int32 Num() const { return OpNum; }
+
+	/** 日志字节数 */
+	int32 GetDataSize() const { return Data.Num(); }
+
+	/** 操作的可读描述（用于报告出错的操作） */
+	static FString DescribeOp(EEveInventoryOp Op, TConstArrayView<int32> Args);
+
+private:
+	/** 写入 ZigZag 变长整数 */
+	static void WriteVarInt(TArray<uint8>& Out, int32 Value);
+
+	/** 读取 ZigZag 变长整数 */
+	static bool ReadVarInt(const uint8*& Cursor, const uint8* End, int32& OutValue);
+
+	/** 从参数中读取预留，负重或体积无效时返回 false */
+	static bool ReadReservation(TConstArrayView<int32> Args, FEveInventoryReservation& OutReservation);
+
+	/** 执行一条操作 */
+	static bool ApplyOp(UEveInventoryMgr& Inventory, EEveInventoryOp Op, TConstArrayView<int32> Args);
+
+private:
+	/** 编码后的操作 */
+	TArray<uint8> Data;
+
+	/** 操作数量 */
+	int32 OpNum = 0;
+};
+
+/**
+ * 记录作用域：只有最外层的操作被记录，嵌套调用（如 `AddItemStacks` 内部的 `AddItemByTID`）在回放时会被重新执行。
+ */
+class FEveInventoryOpRecordScope : public FNoncopyable
+{
+public:
+	FEveInventoryOpRecordScope(FEveInventoryOpLog* InLog, int32& InDepth)
+		: Log(InLog)
+		, Depth(InDepth)
+		, bOutermost(InDepth++ == 0)
+	{
+	}
+
+	~FEveInventoryOpRecordScope()
+	{
+		Depth--;
+	}
+
+	/** 是否需要记录本次操作 */
+	bool IsRecording() const { return Log && bOutermost; }
+
+	/** 记录本次操作 */
+	void Record(const EEveInventoryOp Op, const TConstArrayView<int32> Args) const
+	{
+		if (IsRecording()) Log->Record(Op, Args);
+	}
+
+private:
+	FEveInventoryOpLog* Log;
+	int32& Depth;
+	bool bOutermost;
+};
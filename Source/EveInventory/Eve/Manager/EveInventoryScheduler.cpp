@@ -0,0 +1,287 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#include "EveInventoryScheduler.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "EveInventory/EveInventory.h"
+#include "EveInventory/Eve/Manager/EveInventoryMgr.h"
+
+DECLARE_CYCLE_STAT(TEXT("Inventory Scheduler"), STAT_EveInventoryScheduler, STATGROUP_EveInventory);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Scheduled Units"), STAT_EveScheduledUnits, STATGROUP_EveInventory);
+
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommandWithWorldAndArgs GEveTestGrantCmd(
+    TEXT("Eve.TestGrant"),
+    TEXT("Grant a large random reward through the time-sliced scheduler. Usage: Eve.TestGrant [Stacks=10000] [MaxFrames=0]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+        UEveInventoryScheduler* Scheduler = GameInstance ? GameInstance->GetSubsystem<UEveInventoryScheduler>() : nullptr;
+        const UEveInventoryMgr* InventoryMgr = GameInstance ? GameInstance->GetSubsystem<UEveInventoryMgr>() : nullptr;
+        if (!Scheduler || !InventoryMgr) return;
+
+        TArray<int32> TIDs;
+        InventoryMgr->TIDToCfgIdx.GetKeys(TIDs);
+        if (TIDs.Num() == 0) return;
+
+        const int32 StackNum = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10000;
+        const int32 MaxFrames = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 0;
+
+        TArray<FEveItemStack> Stacks;
+        Stacks.Reserve(StackNum);
+        for (int32 Idx = 0; Idx < StackNum; Idx++)
+        {
+            Stacks.Emplace(TIDs[FMath::RandHelper(TIDs.Num())], 1);
+        }
+
+        const uint64 StartFrame = GFrameCounter;
+        const int32 JobId = Scheduler->GrantItems(Stacks, MaxFrames);
+
+        // 任务结束后移除本次添加的回调
+        const TSharedRef<FDelegateHandle> Handle = MakeShared<FDelegateHandle>();
+        TWeakObjectPtr<UEveInventoryScheduler> WeakScheduler(Scheduler);
+        *Handle = Scheduler->OnJobFinished.AddLambda([JobId, StartFrame, Handle, WeakScheduler](const int32 FinishedJobId, const bool bCancelled)
+        {
+            if (FinishedJobId != JobId) return;
+
+            UE_LOG(LogEveInventory, Display, TEXT("Grant job %d %s after %llu frame(s)"), JobId, bCancelled ? TEXT("cancelled") : TEXT("finished"), GFrameCounter - StartFrame);
+            if (UEveInventoryScheduler* This = WeakScheduler.Get())
+            {
+                This->OnJobFinished.Remove(*Handle);
+            }
+        });
+    }));
+#endif
+
+/**
+ * 初始化调度器。
+ */
+void UEveInventoryScheduler::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    InventoryMgr = Collection.InitializeDependency<UEveInventoryMgr>();
+    ensure(InventoryMgr);
+}
+
+/**
+ * 反初始化，取消所有任务。
+ */
+void UEveInventoryScheduler::Deinitialize()
+{
+    FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+    TickHandle.Reset();
+
+    const TArray<TSharedRef<FEveInventoryJob>> CancelledJobs = MoveTemp(Jobs);
+    for (const TSharedRef<FEveInventoryJob>& Job : CancelledJobs)
+    {
+        Job->bCancelled = true;
+        FinishJob(*Job);
+    }
+    InventoryMgr = nullptr;
+
+    Super::Deinitialize();
+}
+
+/**
+ * 添加一个分帧任务。
+ */
+int32 UEveInventoryScheduler::EnqueueJob(const int32 Total, TFunction<void(int32)> Step, const int32 MaxFrames, TFunction<void(const FEveInventoryJob&)> Finish)
+{
+    if (!ensure(InventoryMgr && Step)) return INDEX_NONE;
+
+    const TSharedRef<FEveInventoryJob> Job = MakeShared<FEveInventoryJob>();
+    Job->JobId = NextJobId++;
+    Job->Total = FMath::Max(Total, 0);
+    Job->MaxFrames = MaxFrames > 0 ? MaxFrames : DefaultMaxFrames;
+    Job->Step = MoveTemp(Step);
+    Job->Finish = MoveTemp(Finish);
+    Jobs.Add(Job);
+
+    // 只在有任务时 Tick
+    if (!TickHandle.IsValid())
+    {
+        TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::TickJobs));
+    }
+    return Job->JobId;
+}
+
+/**
+ * 分帧发放物品。
+ */
+int32 UEveInventoryScheduler::GrantItems(const TConstArrayView<FEveItemStack> Stacks, const int32 MaxFrames)
+{
+    // 同一 TID 只需要一次添加（一次哈希遍历，远快于逐件添加）
+    const TSharedRef<TArray<FEveItemStack>> Merged = MakeShared<TArray<FEveItemStack>>();
+    TMap<int32, int32> TIDToIdx;
+    for (const FEveItemStack& Stack : Stacks)
+    {
+        if (Stack.Amount <= 0) continue;
+
+        if (const int32* Idx = TIDToIdx.Find(Stack.TID))
+        {
+            (*Merged)[*Idx].Amount += Stack.Amount;
+        }
+        else
+        {
+            TIDToIdx.Add(Stack.TID, Merged->Add(Stack));
+        }
+    }
+
+    const TSharedRef<TArray<FEveItemStack>> NotGranted = MakeShared<TArray<FEveItemStack>>();
+    auto Step = [this, Merged, NotGranted](const int32 Idx)
+    {
+        const FEveItemStack& Stack = (*Merged)[Idx];
+        if (InventoryMgr->CanAddItem(Stack.TID, Stack.Amount) && InventoryMgr->AddItemByTID(Stack.TID, Stack.Amount))
+        {
+            return;
+        }
+        NotGranted->Add(Stack);
+    };
+    auto Finish = [this, Merged, NotGranted](const FEveInventoryJob& Job)
+    {
+        // 被取消时，未处理的物品也视为未发放
+        NotGranted->Append(Merged->GetData() + Job.Done, Merged->Num() - Job.Done);
+        if (NotGranted->Num() > 0)
+        {
+            OnItemsNotGranted.Broadcast(Job.JobId, *NotGranted);
+        }
+    };
+    return EnqueueJob(Merged->Num(), MoveTemp(Step), MaxFrames, MoveTemp(Finish));
+}
+
+/**
+ * 分帧按 TID 升序整理背包。
+ */
+int32 UEveInventoryScheduler::SortItems(const int32 MaxFrames)
+{
+    if (!ensure(InventoryMgr)) return INDEX_NONE;
+
+    // 目标顺序一次算好，每个单元只做一次哈希查找与一次移动
+    const TSharedRef<TArray<int32>> Order = MakeShared<TArray<int32>>();
+    InventoryMgr->InventoryItems.GetKeys(*Order);
+    Order->Sort();
+
+    const TSharedRef<int32> NextPosIdx = MakeShared<int32>(0);
+    return EnqueueJob(Order->Num(), [this, Order, NextPosIdx](const int32 Idx)
+    {
+        const TObjectPtr<UEveInventoryItem>* Item = InventoryMgr->InventoryItems.Find((*Order)[Idx]);
+        if (!Item || !*Item) return; // 整理期间已被移除
+
+        // 跳过预留的格子（预留可能在整理期间发生，因此每个单元重新检查）
+        while (*NextPosIdx < InventoryMgr->SlotNum && InventoryMgr->IsSlotReserved(*NextPosIdx))
+        {
+            (*NextPosIdx)++;
+        }
+        if (*NextPosIdx >= InventoryMgr->SlotNum) return;
+
+        const int32 TargetPosIdx = (*NextPosIdx)++;
+        if ((*Item)->PosIdx != TargetPosIdx)
+        {
+            // 目标格子上的物品被挤到空出的格子
+            InventoryMgr->MoveItems({ (*Item)->PosIdx }, { TargetPosIdx });
+        }
+    }, MaxFrames);
+}
+
+/**
+ * 取消任务。
+ */
+bool UEveInventoryScheduler::CancelJob(const int32 JobId)
+{
+    for (const TSharedRef<FEveInventoryJob>& Job : Jobs)
+    {
+        if (Job->JobId == JobId && !Job->bCancelled)
+        {
+            Job->bCancelled = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * 在预算内执行排队的任务。
+ */
+bool UEveInventoryScheduler::TickJobs(float DeltaTime)
+{
+    SCOPE_CYCLE_COUNTER(STAT_EveInventoryScheduler);
+
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+    const uint64 BudgetCycles = static_cast<uint64>(FrameBudgetMs / 1000.0 / FPlatformTime::GetSecondsPerCycle64());
+    int32 UnitNum = 0;
+
+    {
+        // 本帧的所有单元只触发一次背包更新
+        FEveInventoryBatchScope Batch(InventoryMgr);
+
+        for (int32 JobIdx = 0; JobIdx < Jobs.Num(); JobIdx++)
+        {
+            const TSharedRef<FEveInventoryJob> Job = Jobs[JobIdx];
+            if (Job->bCancelled) continue;
+
+            // 按剩余帧数平摊剩余单元，超出预算也要完成，保证在 `MaxFrames` 帧内结束；
+            // 队首任务每帧至少推进一个单元
+            const int32 FramesLeft = FMath::Max(Job->MaxFrames - Job->FramesRun, 1);
+            int32 MinSteps = FMath::DivideAndRoundUp(Job->Total - Job->Done, FramesLeft);
+            if (JobIdx == 0)
+            {
+                MinSteps = FMath::Max(MinSteps, 1);
+            }
+            Job->FramesRun++;
+
+            int32 Steps = 0;
+            while (Job->Done < Job->Total && !Job->bCancelled)
+            {
+                if (Steps >= MinSteps && FPlatformTime::Cycles64() - StartCycles >= BudgetCycles) break;
+
+                const int32 Idx = Job->Done++;
+                Job->Step(Idx);
+                Steps++;
+            }
+
+            UnitNum += Steps;
+            if (Steps > 0)
+            {
+                OnJobProgress.Broadcast(Job->JobId, Job->Done, Job->Total);
+            }
+        }
+    }
+
+    INC_DWORD_STAT_BY(STAT_EveScheduledUnits, UnitNum);
+
+    // 背包更新广播之后再结束任务，回调中看到的是最终状态
+    TArray<TSharedRef<FEveInventoryJob>, TInlineAllocator<4>> FinishedJobs;
+    for (int32 JobIdx = Jobs.Num() - 1; JobIdx >= 0; JobIdx--)
+    {
+        if (Jobs[JobIdx]->bCancelled || Jobs[JobIdx]->Done >= Jobs[JobIdx]->Total)
+        {
+            FinishedJobs.Insert(Jobs[JobIdx], 0);
+            Jobs.RemoveAt(JobIdx);
+        }
+    }
+    for (const TSharedRef<FEveInventoryJob>& Job : FinishedJobs)
+    {
+        FinishJob(*Job);
+    }
+
+    // 没有任务时移除 Ticker（结束回调中可能又添加了任务）
+    if (Jobs.Num() == 0)
+    {
+        TickHandle.Reset();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 结束任务并广播。
+ */
+void UEveInventoryScheduler::FinishJob(const FEveInventoryJob& Job)
+{
+    if (Job.Finish)
+    {
+        Job.Finish(Job);
+    }
+    OnJobFinished.Broadcast(Job.JobId, Job.bCancelled);
+}
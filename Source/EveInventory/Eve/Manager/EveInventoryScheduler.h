@@ -0,0 +1,152 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "EveInventory/Eve/Data/EveItemData.h"
+#include "EveInventoryScheduler.generated.h"
+
+class UEveInventoryMgr;
+
+/**
+ * 分帧任务：共 `Total` 个单元，每次 `Step` 处理一个单元（一个完整的背包操作）。
+ */
+struct FEveInventoryJob
+{
+	/** 任务 ID */
+	int32 JobId = INDEX_NONE;
+
+	/** 总单元数 */
+	int32 Total = 0;
+
+	/** 已处理的单元数 */
+	int32 Done = 0;
+
+	/** 最多用多少帧完成（为 0 时只受每帧预算限制，每帧至少处理一个单元） */
+	int32 MaxFrames = 0;
+
+	/** 已运行的帧数 */
+	int32 FramesRun = 0;
+
+	/** 是否已被取消 */
+	bool bCancelled = false;
+
+	/** 处理第 Idx 个单元 */
+	TFunction<void(int32 /* Idx */)> Step;
+
+	/** 任务结束（完成或被取消）时调用 */
+	TFunction<void(const FEveInventoryJob& /* Job */)> Finish;
+};
+
+/**
+ * 背包分帧调度器，继承自 UGameInstanceSubsystem。
+ * 
+ * 大批量操作（发放上万件奖励、整理大仓库、背包界面折叠时的全量同步）拆成单元，每帧在 `FrameBudgetMs` 预算内执行：
+ * - 每帧的所有单元包在一次批量修改中，背包与界面每帧只收到一次更新，每个中间状态都是完整操作之后的状态
+ * - 设置 `MaxFrames` 时按剩余帧数提高每帧的最少单元数，保证在有限帧内完成
+ * - 每帧广播一次进度，没有任务时不参与 Tick
+ */
+UCLASS(Config = Game)
+class UEveInventoryScheduler : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+public:
+	/**
+	 * 任务进度事件，每个运行中的任务每帧最多广播一次。
+	 */
+	DECLARE_MULTICAST_DELEGATE_ThreeParams(FEveOnJobProgress, int32 /* JobId */, int32 /* Done */, int32 /* Total */);
+	FEveOnJobProgress OnJobProgress;
+
+	/**
+	 * 任务结束事件（完成或被取消）。
+	 */
+	DECLARE_MULTICAST_DELEGATE_TwoParams(FEveOnJobFinished, int32 /* JobId */, bool /* bCancelled */);
+	FEveOnJobFinished OnJobFinished;
+
+	/**
+	 * 发放任务结束时未发放的物品（放不下或任务被取消），可转为邮件或掉落。
+	 */
+	DECLARE_MULTICAST_DELEGATE_TwoParams(FEveOnItemsNotGranted, int32 /* JobId */, const TArray<FEveItemStack>& /* Stacks */);
+	FEveOnItemsNotGranted OnItemsNotGranted;
+
+	/**
+	 * 添加一个通用的分帧任务（背包或界面的大批量工作）。
+	 * @param Total 总单元数。
+	 * @param Step 处理第 Idx 个单元，必须让背包保持一致的状态。
+	 * @param MaxFrames 最多用多少帧完成（为 0 时使用 `DefaultMaxFrames`）。
+	 * @param Finish 可选，任务结束时调用。
+	 * @return 任务 ID。
+	 */
+	int32 EnqueueJob(int32 Total, TFunction<void(int32)> Step, int32 MaxFrames = 0, TFunction<void(const FEveInventoryJob&)> Finish = nullptr);
+
+	/**
+	 * 分帧发放物品，同一 TID 先合并，每个单元添加一种物品。
+	 * @param Stacks 发放的物品。
+	 * @param MaxFrames 最多用多少帧完成（为 0 时使用 `DefaultMaxFrames`）。
+	 * @return 任务 ID。
+	 */
+	int32 GrantItems(TConstArrayView<FEveItemStack> Stacks, int32 MaxFrames = 0);
+
+	/**
+	 * 分帧按 TID 升序整理背包，每个单元把一个物品移动到最终位置。
+	 * 整理期间新增的物品会被挤到空出的格子，被移除的物品直接跳过，预留的格子（如进行中的交易）不会被放入物品。
+	 * @param MaxFrames 最多用多少帧完成（为 0 时使用 `DefaultMaxFrames`）。
+	 * @return 任务 ID。
+	 */
+	int32 SortItems(int32 MaxFrames = 0);
+
+	/**
+	 * 取消任务，已处理的单元保留。
+	 * @return 任务是否存在。
+	 */
+	bool CancelJob(int32 JobId);
+
+	/** 是否有未完成的任务 */
+	bool IsBusy() const { return Jobs.Num() > 0; }
+
+public:
+	/**
+	 * 每帧的时间预算（毫秒），可在 `DefaultGame.ini` 中配置。
+	 */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Inventory")
+	float FrameBudgetMs = 2.f;
+
+	/**
+	 * 未指定 `MaxFrames` 的任务最多用多少帧完成，可在 `DefaultGame.ini` 中配置。
+	 */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Inventory")
+	int32 DefaultMaxFrames = 120;
+
+private:
+	/**
+	 * 在预算内执行排队的任务。
+	 */
+	bool TickJobs(float DeltaTime);
+
+	/**
+	 * 结束任务并广播。
+	 */
+	void FinishJob(const FEveInventoryJob& Job);
+
+private:
+	/** 背包管理器 */
+	UPROPERTY()
+	TObjectPtr<UEveInventoryMgr> InventoryMgr;
+
+	/** 排队的任务，按先后顺序执行（单元中可以添加或取消任务，因此按引用持有） */
+	TArray<TSharedRef<FEveInventoryJob>> Jobs;
+
+	/** 下一个任务 ID */
+	int32 NextJobId = 0;
+
+	/** 有任务时的 Ticker 句柄 */
+	FTSTicker::FDelegateHandle TickHandle;
+};
@@ -0,0 +1,602 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#include "EveInventoryService.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Engine/GameInstance.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/ScopeLock.h"
+#include "EveInventory/EveInventory.h"
+#include "EveInventory/Eve/Manager/EveInventoryMgr.h"
+
+DECLARE_CYCLE_STAT(TEXT("Inventory Service Process"), STAT_EveInventoryServiceProcess, STATGROUP_EveInventory);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Service Mutations Applied"), STAT_EveServiceMutationsApplied, STATGROUP_EveInventory);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Service Players"), STAT_EveServicePlayers, STATGROUP_EveInventory);
+
+/**
+ * 分片数量：所有工作线程加上参与 `ParallelFor` 的调用线程。
+ */
+static int32 GetDefaultShardNum()
+{
+    return FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+}
+
+#if !UE_BUILD_SHIPPING
+/**
+ * 模拟客户端负载：每个模拟玩家随机添加 / 移除 / 移动物品，分别以单线程与分片并行处理同一组修改。
+ */
+static FAutoConsoleCommand GEveBenchInventoryServiceCmd(
+    TEXT("Eve.BenchInventoryService"),
+    TEXT("Measure inventory service mutation throughput. Usage: Eve.BenchInventoryService [Players=400] [MutationsPerPlayer=512] [Shards=auto]"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        const int32 PlayerNum = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 400;
+        const int32 MutationsPerPlayer = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 512;
+        const int32 ShardNum = Args.Num() > 2 ? FMath::Max(FCString::Atoi(*Args[2]), 1) : GetDefaultShardNum();
+        constexpr int32 SlotsPerPlayer = 32;
+        constexpr int32 ItemKinds = 48;
+
+        // 预先生成修改，计时不包含随机数生成；客户端交错发送，与真实到达顺序相近
+        FRandomStream Random(0x5EED);
+        TArray<FEveInventoryMutation> Mutations;
+        Mutations.Reserve(PlayerNum * MutationsPerPlayer);
+        for (int32 Round = 0; Round < MutationsPerPlayer; Round++)
+        {
+            for (int32 PlayerId = 0; PlayerId < PlayerNum; PlayerId++)
+            {
+                FEveInventoryMutation& Mutation = Mutations.AddDefaulted_GetRef();
+                Mutation.PlayerId = PlayerId;
+
+                const int32 Roll = Random.RandHelper(10);
+                if (Roll < 6)
+                {
+                    Mutation.Op = FEveInventoryMutation::EOp::Add;
+                    Mutation.TID = Random.RandHelper(ItemKinds) + 1;
+                    Mutation.Amount = Random.RandRange(1, 5);
+                }
+                else if (Roll < 9)
+                {
+                    Mutation.Op = FEveInventoryMutation::EOp::Remove;
+                    Mutation.TID = Random.RandHelper(ItemKinds) + 1;
+                    Mutation.Amount = Random.RandRange(1, 5);
+                }
+                else
+                {
+                    Mutation.Op = FEveInventoryMutation::EOp::Move;
+                    Mutation.FromPosIdx = Random.RandHelper(SlotsPerPlayer);
+                    Mutation.ToPosIdx = Random.RandHelper(SlotsPerPlayer);
+                }
+            }
+        }
+
+        auto Run = [&](const int32 InShardNum, const bool bForceSingleThread, uint32& OutChecksum, int32& OutApplied)
+        {
+            FEveInventoryShardSet ShardSet(InShardNum, SlotsPerPlayer);
+            for (int32 PlayerId = 0; PlayerId < PlayerNum; PlayerId++)
+            {
+                ShardSet.AddPlayer(PlayerId);
+            }
+            for (const FEveInventoryMutation& Mutation : Mutations)
+            {
+                ShardSet.Enqueue(Mutation);
+            }
+
+            const double StartTime = FPlatformTime::Seconds();
+            OutApplied = ShardSet.ProcessPending(bForceSingleThread);
+            const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+            // 校验和用于确认并行结果与单线程一致
+            OutChecksum = 0;
+            for (int32 PlayerId = 0; PlayerId < PlayerNum; PlayerId++)
+            {
+                for (int32 PosIdx = 0; PosIdx < SlotsPerPlayer; PosIdx++)
+                {
+                    FEveItemStack Stack;
+                    ShardSet.GetSlot(PlayerId, PosIdx, Stack);
+                    OutChecksum = HashCombineFast(OutChecksum, HashCombineFast(GetTypeHash(Stack.TID), GetTypeHash(Stack.Amount)));
+                }
+            }
+            return Seconds;
+        };
+
+        uint32 SerialChecksum;
+        uint32 ParallelChecksum;
+        int32 SerialApplied;
+        int32 ParallelApplied;
+        const double SerialSeconds = Run(1, true, SerialChecksum, SerialApplied);
+        const double ParallelSeconds = Run(ShardNum, false, ParallelChecksum, ParallelApplied);
+
+        const double MutationNum = Mutations.Num();
+        UE_LOG(LogEveInventory, Display, TEXT("Inventory service: %d players, %d mutations (%d applied)"), PlayerNum, Mutations.Num(), ParallelApplied);
+        UE_LOG(LogEveInventory, Display, TEXT("  1 shard,  single thread: %.2f ms, %.2f M mutations/s"), SerialSeconds * 1000.0, MutationNum / SerialSeconds / 1e6);
+        UE_LOG(LogEveInventory, Display, TEXT("  %d shards, parallel:     %.2f ms, %.2f M mutations/s (x%.2f on %d cores)"),
+            ShardNum, ParallelSeconds * 1000.0, MutationNum / ParallelSeconds / 1e6, SerialSeconds / ParallelSeconds, FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+        if (SerialChecksum != ParallelChecksum || SerialApplied != ParallelApplied)
+        {
+            UE_LOG(LogEveInventory, Error, TEXT("  Parallel result differs from single thread result"));
+        }
+    }));
+#endif
+
+FEveInventoryShardSet::FEveInventoryShardSet(const int32 NumShards, const int32 InSlotsPerPlayer, const float InMaxWeight)
+    : SlotsPerPlayer(InSlotsPerPlayer)
+    , MaxWeight(InMaxWeight)
+{
+    check(NumShards > 0 && SlotsPerPlayer > 0);
+
+    Shards.Reserve(NumShards);
+    for (int32 Idx = 0; Idx < NumShards; Idx++)
+    {
+        Shards.Add(MakeUnique<FEveInventoryShard>());
+    }
+}
+
+/**
+ * 添加玩家，格子追加到分片数组末尾。
+ */
+bool FEveInventoryShardSet::AddPlayer(const int32 PlayerId)
+{
+    FEveInventoryShard& Shard = GetShard(PlayerId);
+    if (Shard.PlayerToLocal.Contains(PlayerId)) return false;
+
+    Shard.PlayerToLocal.Add(PlayerId, Shard.PlayerIds.Add(PlayerId));
+    Shard.PlayerWeights.Add(0.f);
+    Shard.DirtyPlayers.Add(false);
+    Shard.SlotTIDs.Add(EmptyTID, SlotsPerPlayer);
+    Shard.SlotAmounts.AddZeroed(SlotsPerPlayer);
+    return true;
+}
+
+/**
+ * 移除玩家：最后一个玩家的数据移动到被移除的位置，保持数组紧凑。
+ */
+bool FEveInventoryShardSet::RemovePlayer(const int32 PlayerId)
+{
+    FEveInventoryShard& Shard = GetShard(PlayerId);
+
+    int32 LocalIdx;
+    if (!Shard.PlayerToLocal.RemoveAndCopyValue(PlayerId, LocalIdx)) return false;
+
+    const int32 LastIdx = Shard.PlayerIds.Num() - 1;
+    if (LocalIdx != LastIdx)
+    {
+        Shard.PlayerToLocal[Shard.PlayerIds[LastIdx]] = LocalIdx;
+        FMemory::Memcpy(&Shard.SlotTIDs[LocalIdx * SlotsPerPlayer], &Shard.SlotTIDs[LastIdx * SlotsPerPlayer], SlotsPerPlayer * sizeof(int32));
+        FMemory::Memcpy(&Shard.SlotAmounts[LocalIdx * SlotsPerPlayer], &Shard.SlotAmounts[LastIdx * SlotsPerPlayer], SlotsPerPlayer * sizeof(int32));
+    }
+
+    Shard.PlayerIds.RemoveAtSwap(LocalIdx, 1, EveNoShrink);
+    Shard.PlayerWeights.RemoveAtSwap(LocalIdx, 1, EveNoShrink);
+    Shard.DirtyPlayers.RemoveAtSwap(LocalIdx);
+    Shard.SlotTIDs.SetNum(LastIdx * SlotsPerPlayer, EveNoShrink);
+    Shard.SlotAmounts.SetNum(LastIdx * SlotsPerPlayer, EveNoShrink);
+    return true;
+}
+
+/**
+ * 排队一次修改。
+ */
+void FEveInventoryShardSet::Enqueue(const FEveInventoryMutation& Mutation)
+{
+    FEveInventoryShard& Shard = GetShard(Mutation.PlayerId);
+
+    {
+        FScopeLock Lock(&Shard.PendingLock);
+        Shard.Pending.Add(Mutation);
+    }
+    PendingNum.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * 并行处理所有分片中排队的修改。
+ */
+int32 FEveInventoryShardSet::ProcessPending(const bool bForceSingleThread, TArray<int32>* OutDirtyPlayerIds)
+{
+    // 计数在加入队列之后才增加：这里清零后再到达的修改一定会让下一次处理继续执行
+    if (PendingNum.exchange(0, std::memory_order_acquire) == 0) return 0;
+
+    SCOPE_CYCLE_COUNTER(STAT_EveInventoryServiceProcess);
+
+    ParallelFor(Shards.Num(), [this](const int32 ShardIdx)
+    {
+        ProcessShard(*Shards[ShardIdx]);
+    }, bForceSingleThread ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+    // 汇总在调用线程上进行，工作线程只写自己的分片
+    int32 NumApplied = 0;
+    for (const TUniquePtr<FEveInventoryShard>& Shard : Shards)
+    {
+        NumApplied += Shard->NumApplied;
+        if (OutDirtyPlayerIds)
+        {
+            for (TConstSetBitIterator<> It(Shard->DirtyPlayers); It; ++It)
+            {
+                OutDirtyPlayerIds->Add(Shard->PlayerIds[It.GetIndex()]);
+            }
+        }
+        Shard->DirtyPlayers.SetRange(0, Shard->DirtyPlayers.Num(), false);
+    }
+
+    INC_DWORD_STAT_BY(STAT_EveServiceMutationsApplied, NumApplied);
+    return NumApplied;
+}
+
+/**
+ * 处理一个分片的排队修改。
+ */
+void FEveInventoryShardSet::ProcessShard(FEveInventoryShard& Shard) const
+{
+    {
+        FScopeLock Lock(&Shard.PendingLock);
+        Swap(Shard.Pending, Shard.Processing);
+    }
+
+    Shard.NumApplied = 0;
+    Shard.NumRejected = 0;
+    for (const FEveInventoryMutation& Mutation : Shard.Processing)
+    {
+        if (Apply(Shard, Mutation))
+        {
+            Shard.NumApplied++;
+        }
+        else
+        {
+            Shard.NumRejected++;
+        }
+    }
+    Shard.Processing.Reset();
+}
+
+/**
+ * 应用一次修改，只访问该玩家连续的一段格子。
+ */
+bool FEveInventoryShardSet::Apply(FEveInventoryShard& Shard, const FEveInventoryMutation& Mutation) const
+{
+    const int32* LocalIdx = Shard.PlayerToLocal.Find(Mutation.PlayerId);
+    if (!LocalIdx) return false;
+
+    int32* TIDs = Shard.SlotTIDs.GetData() + *LocalIdx * SlotsPerPlayer;
+    int32* Amounts = Shard.SlotAmounts.GetData() + *LocalIdx * SlotsPerPlayer;
+    float& PlayerWeight = Shard.PlayerWeights[*LocalIdx];
+
+    switch (Mutation.Op)
+    {
+    case FEveInventoryMutation::EOp::Add:
+    {
+        if (Mutation.Amount <= 0 || Mutation.TID == EmptyTID) return false;
+
+        float UnitWeight = 0.f;
+        if (ItemWeights.Num() > 0)
+        {
+            const float* Weight = ItemWeights.Find(Mutation.TID);
+            if (!Weight) return false;
+            UnitWeight = *Weight;
+        }
+        const float AddWeight = UnitWeight * Mutation.Amount;
+        if (MaxWeight > 0.f && PlayerWeight + AddWeight > MaxWeight + KINDA_SMALL_NUMBER) return false;
+
+        // 每种物品一个堆叠：优先合并，否则放入第一个空格子
+        int32 PosIdx = INDEX_NONE;
+        int32 EmptyPosIdx = INDEX_NONE;
+        for (int32 Idx = 0; Idx < SlotsPerPlayer; Idx++)
+        {
+            if (TIDs[Idx] == Mutation.TID)
+            {
+                PosIdx = Idx;
+                break;
+            }
+            if (EmptyPosIdx == INDEX_NONE && TIDs[Idx] == EmptyTID)
+            {
+                EmptyPosIdx = Idx;
+            }
+        }
+        if (PosIdx == INDEX_NONE)
+        {
+            if (EmptyPosIdx == INDEX_NONE) return false;
+
+            PosIdx = EmptyPosIdx;
+            TIDs[PosIdx] = Mutation.TID;
+            Amounts[PosIdx] = 0;
+        }
+
+        Amounts[PosIdx] += Mutation.Amount;
+        PlayerWeight += AddWeight;
+        break;
+    }
+    case FEveInventoryMutation::EOp::Remove:
+    {
+        if (Mutation.Amount <= 0 || Mutation.TID == EmptyTID) return false;
+
+        int32 PosIdx = 0;
+        while (PosIdx < SlotsPerPlayer && TIDs[PosIdx] != Mutation.TID)
+        {
+            PosIdx++;
+        }
+        if (PosIdx == SlotsPerPlayer || Amounts[PosIdx] < Mutation.Amount) return false;
+
+        Amounts[PosIdx] -= Mutation.Amount;
+        if (Amounts[PosIdx] == 0)
+        {
+            TIDs[PosIdx] = EmptyTID;
+        }
+
+        const float* Weight = ItemWeights.Find(Mutation.TID);
+        PlayerWeight = FMath::Max(PlayerWeight - (Weight ? *Weight : 0.f) * Mutation.Amount, 0.f);
+        break;
+    }
+    case FEveInventoryMutation::EOp::Move:
+    {
+        if (Mutation.FromPosIdx < 0 || Mutation.FromPosIdx >= SlotsPerPlayer) return false;
+        if (Mutation.ToPosIdx < 0 || Mutation.ToPosIdx >= SlotsPerPlayer) return false;
+        if (TIDs[Mutation.FromPosIdx] == EmptyTID) return false;
+
+        Swap(TIDs[Mutation.FromPosIdx], TIDs[Mutation.ToPosIdx]);
+        Swap(Amounts[Mutation.FromPosIdx], Amounts[Mutation.ToPosIdx]);
+        break;
+    }
+    default:
+        return false;
+    }
+
+    Shard.DirtyPlayers[*LocalIdx] = true;
+    return true;
+}
+
+/**
+ * 按当前负重表重新计算所有玩家的负重。
+ */
+void FEveInventoryShardSet::RecomputePlayerWeights()
+{
+    for (const TUniquePtr<FEveInventoryShard>& Shard : Shards)
+    {
+        for (int32 LocalIdx = 0; LocalIdx < Shard->PlayerIds.Num(); LocalIdx++)
+        {
+            float Weight = 0.f;
+            const int32 Begin = LocalIdx * SlotsPerPlayer;
+            for (int32 SlotIdx = Begin; SlotIdx < Begin + SlotsPerPlayer; SlotIdx++)
+            {
+                if (Shard->SlotTIDs[SlotIdx] == EmptyTID) continue;
+
+                const float* UnitWeight = ItemWeights.Find(Shard->SlotTIDs[SlotIdx]);
+                Weight += (UnitWeight ? *UnitWeight : 0.f) * Shard->SlotAmounts[SlotIdx];
+            }
+            Shard->PlayerWeights[LocalIdx] = Weight;
+        }
+    }
+}
+
+/**
+ * 获取玩家某个格子中的物品。
+ */
+bool FEveInventoryShardSet::GetSlot(const int32 PlayerId, const int32 PosIdx, FEveItemStack& OutStack) const
+{
+    const FEveInventoryShard& Shard = GetShard(PlayerId);
+    const int32* LocalIdx = Shard.PlayerToLocal.Find(PlayerId);
+    if (!LocalIdx || PosIdx < 0 || PosIdx >= SlotsPerPlayer) return false;
+
+    const int32 SlotIdx = *LocalIdx * SlotsPerPlayer + PosIdx;
+    OutStack = FEveItemStack(Shard.SlotTIDs[SlotIdx], Shard.SlotAmounts[SlotIdx]);
+    return true;
+}
+
+/**
+ * 玩家某种物品的数量。
+ */
+int32 FEveInventoryShardSet::GetAmount(const int32 PlayerId, const int32 TID) const
+{
+    const FEveInventoryShard& Shard = GetShard(PlayerId);
+    const int32* LocalIdx = Shard.PlayerToLocal.Find(PlayerId);
+    if (!LocalIdx) return 0;
+
+    const int32 Begin = *LocalIdx * SlotsPerPlayer;
+    for (int32 SlotIdx = Begin; SlotIdx < Begin + SlotsPerPlayer; SlotIdx++)
+    {
+        if (Shard.SlotTIDs[SlotIdx] == TID) return Shard.SlotAmounts[SlotIdx];
+    }
+    return 0;
+}
+
+/**
+ * 玩家的当前负重。
+ */
+float FEveInventoryShardSet::GetWeight(const int32 PlayerId) const
+{
+    const FEveInventoryShard& Shard = GetShard(PlayerId);
+    const int32* LocalIdx = Shard.PlayerToLocal.Find(PlayerId);
+    return LocalIdx ? Shard.PlayerWeights[*LocalIdx] : 0.f;
+}
+
+/**
+ * 玩家数量。
+ */
+int32 FEveInventoryShardSet::GetNumPlayers() const
+{
+    int32 NumPlayers = 0;
+    for (const TUniquePtr<FEveInventoryShard>& Shard : Shards)
+    {
+        NumPlayers += Shard->PlayerIds.Num();
+    }
+    return NumPlayers;
+}
+
+/**
+ * 只在专用服务器上创建。
+ */
+bool UEveInventoryService::ShouldCreateSubsystem(UObject* Outer) const
+{
+    const UGameInstance* GameInstance = Cast<UGameInstance>(Outer);
+    return GameInstance && GameInstance->IsDedicatedServerInstance() && Super::ShouldCreateSubsystem(Outer);
+}
+
+/**
+ * 初始化分片，读取物品负重并开始每帧处理。
+ */
+void UEveInventoryService::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    // 每个玩家的背包与客户端背包使用相同的格子数量与负重上限
+    InventoryMgr = Collection.InitializeDependency<UEveInventoryMgr>();
+    if (!ensure(InventoryMgr)) return;
+
+    Shards = MakeUnique<FEveInventoryShardSet>(GetDefaultShardNum(), InventoryMgr->SlotNum, InventoryMgr->MaxWeight);
+    RebuildItemWeights();
+    InventoryMgr->OnItemCfgsChanged.AddUObject(this, &ThisClass::HandleItemCfgsChanged);
+
+    TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::TickService));
+
+    PostLoginHandle = FGameModeEvents::GameModePostLoginEvent.AddUObject(this, &ThisClass::HandlePostLogin);
+    LogoutHandle = FGameModeEvents::GameModeLogoutEvent.AddUObject(this, &ThisClass::HandleLogout);
+}
+
+/**
+ * 反初始化，停止处理并清理数据。
+ */
+void UEveInventoryService::Deinitialize()
+{
+    FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+    FGameModeEvents::GameModePostLoginEvent.Remove(PostLoginHandle);
+    FGameModeEvents::GameModeLogoutEvent.Remove(LogoutHandle);
+    if (InventoryMgr)
+    {
+        InventoryMgr->OnItemCfgsChanged.RemoveAll(this);
+        InventoryMgr = nullptr;
+    }
+
+    Shards.Reset();
+    DirtyPlayerIds.Empty();
+
+    Super::Deinitialize();
+}
+
+/**
+ * 玩家连接时添加背包。
+ */
+bool UEveInventoryService::AddPlayer(const int32 PlayerId)
+{
+    check(IsInGameThread());
+    if (!Shards || !Shards->AddPlayer(PlayerId)) return false;
+
+    SET_DWORD_STAT(STAT_EveServicePlayers, Shards->GetNumPlayers());
+    return true;
+}
+
+/**
+ * 玩家断开时移除背包。
+ */
+bool UEveInventoryService::RemovePlayer(const int32 PlayerId)
+{
+    check(IsInGameThread());
+    if (!Shards || !Shards->RemovePlayer(PlayerId)) return false;
+
+    SET_DWORD_STAT(STAT_EveServicePlayers, Shards->GetNumPlayers());
+    return true;
+}
+
+/**
+ * 本游戏实例的玩家登录时添加背包，以 `PlayerState` 的玩家 ID 作为背包 ID。
+ */
+void UEveInventoryService::HandlePostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer)
+{
+    if (!GameMode || GameMode->GetGameInstance() != GetGameInstance()) return;
+    if (!NewPlayer || !NewPlayer->PlayerState) return;
+
+    AddPlayer(NewPlayer->PlayerState->GetPlayerId());
+}
+
+/**
+ * 本游戏实例的玩家登出时移除背包。
+ */
+void UEveInventoryService::HandleLogout(AGameModeBase* GameMode, AController* Exiting)
+{
+    if (!GameMode || GameMode->GetGameInstance() != GetGameInstance()) return;
+    if (!Exiting || !Exiting->PlayerState) return;
+
+    RemovePlayer(Exiting->PlayerState->GetPlayerId());
+}
+
+/**
+ * 在游戏线程上排队一次修改。
+ */
+void UEveInventoryService::EnqueueMutation(const FEveInventoryMutation& Mutation)
+{
+    check(IsInGameThread());
+    if (!Shards) return;
+
+    // 物品第一次出现时记录重量（目录物品只读取目录行，不生成配置），负重表在处理前更新（处理期间负重表只读）
+    if (Mutation.Op == FEveInventoryMutation::EOp::Add && !Shards->HasItemWeight(Mutation.TID))
+    {
+        float Weight = 0.f;
+        float Volume = 0.f;
+        if (InventoryMgr->FindItemFootprint(Mutation.TID, Weight, Volume))
+        {
+            Shards->AddItemWeight(Mutation.TID, Weight);
+        }
+    }
+    Shards->Enqueue(Mutation);
+}
+
+/**
+ * 每帧处理排队的修改，并广播被修改过的玩家。
+ */
+bool UEveInventoryService::TickService(float DeltaTime)
+{
+    if (Shards)
+    {
+        DirtyPlayerIds.Reset();
+        Shards->ProcessPending(false, &DirtyPlayerIds);
+        if (DirtyPlayerIds.Num() > 0)
+        {
+            OnPlayerInventoriesChanged.Broadcast(DirtyPlayerIds);
+        }
+    }
+    return true;
+}
+
+/**
+ * 从背包管理器的物品配置重建负重表。
+ */
+void UEveInventoryService::RebuildItemWeights()
+{
+    TMap<int32, float> ItemWeights;
+    ItemWeights.Reserve(InventoryMgr->ItemCfgs.Num());
+    for (const UEveItemCfg* ItemCfg : InventoryMgr->ItemCfgs)
+    {
+        if (ItemCfg)
+        {
+            ItemWeights.Add(ItemCfg->ItemData.TID, ItemCfg->ItemData.Weight);
+        }
+    }
+    Shards->SetItemWeights(MoveTemp(ItemWeights));
+}
+
+/**
+ * 物品配置热重载时更新负重表；已有物品的负重变化时重新计算所有玩家的负重。
+ * 事件在游戏线程上广播，此时不在处理期间，负重表与玩家负重都可以修改。
+ */
+void UEveInventoryService::HandleItemCfgsChanged(const TArray<int32>& ChangedTIDs)
+{
+    if (!Shards) return;
+
+    bool bWeightChanged = false;
+    for (const int32 TID : ChangedTIDs)
+    {
+        const UEveItemCfg* ItemCfg = InventoryMgr->GetCfgByIdx(InventoryMgr->FindCfgIdx(TID));
+        if (!ItemCfg) continue;
+
+        // 新生成的目录物品还没有玩家持有，不需要重算
+        float OldWeight = 0.f;
+        const bool bKnown = Shards->FindItemWeight(TID, OldWeight);
+        Shards->AddItemWeight(TID, ItemCfg->ItemData.Weight);
+        bWeightChanged |= bKnown && OldWeight != ItemCfg->ItemData.Weight;
+    }
+
+    if (bWeightChanged)
+    {
+        Shards->RecomputePlayerWeights();
+    }
+}
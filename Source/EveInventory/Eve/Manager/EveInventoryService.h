@@ -0,0 +1,309 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "HAL/CriticalSection.h"
+#include <atomic>
+#include "EveInventory/Eve/Data/EveItemData.h"
+#include "EveInventoryService.generated.h"
+
+class AController;
+class AGameModeBase;
+class APlayerController;
+class UEveInventoryMgr;
+
+/**
+ * 一次排队的玩家背包修改。
+ */
+struct FEveInventoryMutation
+{
+	/** 修改类型 */
+	enum class EOp : uint8
+	{
+		/** 添加 `Amount` 个 `TID`（合并到已有堆叠，否则放入第一个空格子） */
+		Add,
+		/** 移除 `Amount` 个 `TID` */
+		Remove,
+		/** 交换 `FromPosIdx` 与 `ToPosIdx` 两个格子 */
+		Move,
+	};
+
+	/** 玩家 ID */
+	int32 PlayerId = INDEX_NONE;
+
+	/** 修改类型 */
+	EOp Op = EOp::Add;
+
+	/** 物品 TID（Add / Remove） */
+	int32 TID = -1;
+
+	/** 物品数量（Add / Remove） */
+	int32 Amount = 0;
+
+	/** 来源格子（Move） */
+	int32 FromPosIdx = INDEX_NONE;
+
+	/** 目标格子（Move） */
+	int32 ToPosIdx = INDEX_NONE;
+};
+
+/**
+ * 背包分片，按玩家切分，数据以结构数组（SoA）存放。
+ * 玩家 i 的格子为 `[i * SlotsPerPlayer, (i + 1) * SlotsPerPlayer)`，同一玩家的格子连续存放。
+ */
+struct FEveInventoryShard
+{
+	/** 分片内玩家索引到玩家 ID */
+	TArray<int32> PlayerIds;
+
+	/** 每个玩家的当前负重 */
+	TArray<float> PlayerWeights;
+
+	/** 玩家 ID 到分片内玩家索引 */
+	TMap<int32, int32> PlayerToLocal;
+
+	/** 每个格子的 TID（空格子为 -1） */
+	TArray<int32> SlotTIDs;
+
+	/** 每个格子的数量 */
+	TArray<int32> SlotAmounts;
+
+	/** 本轮被修改过的玩家（分片内玩家索引） */
+	TBitArray<> DirtyPlayers;
+
+	/** 保护 `Pending`，允许任意线程排队 */
+	FCriticalSection PendingLock;
+
+	/** 等待处理的修改 */
+	TArray<FEveInventoryMutation> Pending;
+
+	/** 正在处理的修改（与 `Pending` 交换，避免处理期间持锁） */
+	TArray<FEveInventoryMutation> Processing;
+
+	/** 本轮应用 / 拒绝的修改数量 */
+	int32 NumApplied = 0;
+	int32 NumRejected = 0;
+};
+
+/**
+ * 分片的玩家背包集合。
+ * 
+ * - 玩家按 ID 哈希到固定的分片，同一玩家的修改总在同一分片内按排队顺序应用
+ * - `ProcessPending` 用 `ParallelFor` 让每个分片在一个工作线程上处理，分片之间不共享可写数据，无需加锁
+ * - 结果与单线程按分片顺序处理完全一致
+ */
+class FEveInventoryShardSet : public FNoncopyable
+{
+public:
+	/** 空格子的 TID */
+	static constexpr int32 EmptyTID = -1;
+
+	/**
+	 * @param NumShards 分片数量。
+	 * @param InSlotsPerPlayer 每个玩家的格子数量。
+	 * @param InMaxWeight 每个玩家的负重上限（为 0 时不限制）。
+	 */
+	FEveInventoryShardSet(int32 NumShards, int32 InSlotsPerPlayer, float InMaxWeight = 0.f);
+
+	/**
+	 * 添加玩家（只能在游戏线程、不在处理期间调用）。
+	 * @return 是否添加成功，已存在时返回 false。
+	 */
+	bool AddPlayer(int32 PlayerId);
+
+	/**
+	 * 移除玩家（只能在游戏线程、不在处理期间调用），该玩家尚未处理的修改会被拒绝。
+	 * @return 是否移除成功。
+	 */
+	bool RemovePlayer(int32 PlayerId);
+
+	/**
+	 * 排队一次修改（线程安全），在下一次 `ProcessPending` 时应用。
+	 */
+	void Enqueue(const FEveInventoryMutation& Mutation);
+
+	/**
+	 * 并行处理所有分片中排队的修改；没有排队的修改时直接返回，不启动 `ParallelFor`。
+	 * @param bForceSingleThread 是否在调用线程上按顺序处理（用于对比）。
+	 * @param OutDirtyPlayerIds 可选输出，本轮被修改过的玩家 ID。
+	 * @return 应用成功的修改数量。
+	 */
+	int32 ProcessPending(bool bForceSingleThread = false, TArray<int32>* OutDirtyPlayerIds = nullptr);
+
+	/**
+	 * 设置物品单位负重（只能在游戏线程、不在处理期间调用）。
+	 * 为空时接受任意 TID 且不计负重，否则拒绝不在表中的 TID。
+	 */
+	void SetItemWeights(TMap<int32, float>&& InItemWeights) { ItemWeights = MoveTemp(InItemWeights); }
+
+	/** 物品是否有单位负重记录 */
+	bool HasItemWeight(const int32 TID) const { return ItemWeights.Contains(TID); }
+
+	/** 查询物品的单位负重，没有记录时返回 false */
+	bool FindItemWeight(const int32 TID, float& OutWeight) const
+	{
+		const float* Weight = ItemWeights.Find(TID);
+		if (Weight) OutWeight = *Weight;
+		return Weight != nullptr;
+	}
+
+	/** 添加单个物品的单位负重 */
+	void AddItemWeight(const int32 TID, const float Weight) { ItemWeights.Add(TID, Weight); }
+
+	/**
+	 * 按当前负重表重新计算所有玩家的负重（物品负重热重载后调用，只能在游戏线程、不在处理期间调用）。
+	 */
+	void RecomputePlayerWeights();
+
+	/**
+	 * 获取玩家某个格子中的物品。
+	 * @return 玩家或格子不存在时返回 false。
+	 */
+	bool GetSlot(int32 PlayerId, int32 PosIdx, FEveItemStack& OutStack) const;
+
+	/** 玩家某种物品的数量 */
+	int32 GetAmount(int32 PlayerId, int32 TID) const;
+
+	/** 玩家的当前负重 */
+	float GetWeight(int32 PlayerId) const;
+
+	/** 分片数量 */
+	int32 GetNumShards() const { return Shards.Num(); }
+
+	/** 玩家数量 */
+	int32 GetNumPlayers() const;
+
+	/** 每个玩家的格子数量 */
+	int32 GetSlotsPerPlayer() const { return SlotsPerPlayer; }
+
+private:
+	/** 玩家所在的分片 */
+	FEveInventoryShard& GetShard(const int32 PlayerId) const
+	{
+		return *Shards[GetTypeHash(PlayerId) % static_cast<uint32>(Shards.Num())];
+	}
+
+	/** 处理一个分片的排队修改（在工作线程上执行） */
+	void ProcessShard(FEveInventoryShard& Shard) const;
+
+	/** 应用一次修改 */
+	bool Apply(FEveInventoryShard& Shard, const FEveInventoryMutation& Mutation) const;
+
+private:
+	/** 所有分片（独立分配，避免不同线程写入同一缓存行） */
+	TArray<TUniquePtr<FEveInventoryShard>> Shards;
+
+	/** 物品单位负重（处理期间只读） */
+	TMap<int32, float> ItemWeights;
+
+	/** 每个玩家的格子数量 */
+	int32 SlotsPerPlayer = 0;
+
+	/** 每个玩家的负重上限（为 0 时不限制） */
+	float MaxWeight = 0.f;
+
+	/** 排队但尚未处理的修改数量（近似值，只用于空闲时跳过处理） */
+	std::atomic<int32> PendingNum{ 0 };
+};
+
+/**
+ * 专用服务器上的玩家背包服务，继承自 UGameInstanceSubsystem。
+ * 
+ * `UEveInventoryMgr` 每个游戏实例只有一个背包，所有修改都在游戏线程上串行执行；
+ * 该服务在服务器上以分片的结构数组持有所有连接玩家的背包，修改从任意线程排队，
+ * 每帧在工作线程上并行应用一次，再在游戏线程上广播被修改过的玩家。
+ */
+UCLASS()
+class UEveInventoryService : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * 只在专用服务器上创建。
+	 */
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	/**
+	 * 初始化分片，读取物品负重并开始每帧处理。
+	 */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/**
+	 * 反初始化，停止处理并清理数据。
+	 */
+	virtual void Deinitialize() override;
+
+public:
+	/**
+	 * 玩家背包变化事件，参数为本帧被修改过的玩家 ID，每帧最多广播一次。
+	 */
+	DECLARE_MULTICAST_DELEGATE_OneParam(FEveOnPlayerInventoriesChanged, const TArray<int32>& /* PlayerIds */);
+	FEveOnPlayerInventoriesChanged OnPlayerInventoriesChanged;
+
+	/**
+	 * 玩家连接时添加背包（由 GameMode 的登录事件自动调用）。
+	 */
+	bool AddPlayer(int32 PlayerId);
+
+	/**
+	 * 玩家断开时移除背包（由 GameMode 的登出事件自动调用）。
+	 */
+	bool RemovePlayer(int32 PlayerId);
+
+	/**
+	 * 在游戏线程上排队一次修改；添加尚未生成配置的目录物品时在此解析其负重。
+	 * 其他线程可直接调用 `GetShards().Enqueue`（只接受已有配置的物品）。
+	 */
+	void EnqueueMutation(const FEveInventoryMutation& Mutation);
+
+	/** 分片的玩家背包 */
+	FEveInventoryShardSet& GetShards() { return *Shards; }
+
+private:
+	/**
+	 * 每帧处理排队的修改。
+	 */
+	bool TickService(float DeltaTime);
+
+	/**
+	 * 从背包管理器的物品配置重建负重表。
+	 */
+	void RebuildItemWeights();
+
+	/**
+	 * 物品配置热重载时更新负重表，负重变化时重新计算所有玩家的负重。
+	 */
+	void HandleItemCfgsChanged(const TArray<int32>& ChangedTIDs);
+
+	/**
+	 * 本游戏实例的 GameMode 中有玩家登录时添加背包。
+	 */
+	void HandlePostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer);
+
+	/**
+	 * 本游戏实例的 GameMode 中有玩家登出时移除背包。
+	 */
+	void HandleLogout(AGameModeBase* GameMode, AController* Exiting);
+
+private:
+	/** 分片的玩家背包 */
+	TUniquePtr<FEveInventoryShardSet> Shards;
+
+	/** 物品配置来源 */
+	UPROPERTY()
+	TObjectPtr<UEveInventoryMgr> InventoryMgr;
+
+	/** 每帧处理的 Ticker */
+	FTSTicker::FDelegateHandle TickHandle;
+
+	/** GameMode 登录 / 登出事件 */
+	FDelegateHandle PostLoginHandle;
+	FDelegateHandle LogoutHandle;
+
+	/** 本帧被修改过的玩家（复用） */
+	TArray<int32> DirtyPlayerIds;
+};
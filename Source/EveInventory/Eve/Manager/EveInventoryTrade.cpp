@@ -0,0 +1,428 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#include "EveInventoryTrade.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "UObject/StrongObjectPtr.h"
+#include "EveInventory/EveInventory.h"
+
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommand GEveTestTradeCmd(
+    TEXT("Eve.TestTrade"),
+    TEXT("Trade items between the inventories of the first two PIE instances. Usage: Eve.TestTrade <TIDA> <AmountA> <TIDB> <AmountB>"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        if (Args.Num() < 4 || !GEngine) return;
+
+        // 每个 PIE 实例有独立的 GameInstance 与背包
+        TArray<UEveInventoryMgr*, TInlineAllocator<2>> Inventories;
+        for (const FWorldContext& Context : GEngine->GetWorldContexts())
+        {
+            const UGameInstance* GameInstance = Context.OwningGameInstance;
+            if (Context.WorldType != EWorldType::PIE || !GameInstance) continue;
+
+            if (UEveInventoryMgr* InventoryMgr = GameInstance->GetSubsystem<UEveInventoryMgr>())
+            {
+                Inventories.Add(InventoryMgr);
+            }
+            if (Inventories.Num() == 2) break;
+        }
+        if (Inventories.Num() < 2)
+        {
+            UE_LOG(LogEveInventory, Warning, TEXT("Eve.TestTrade needs at least two PIE instances"));
+            return;
+        }
+
+        FEveInventoryTrade Trade(Inventories[0], Inventories[1]);
+        Trade.SetOffer(0, { FEveItemStack(FCString::Atoi(*Args[0]), FCString::Atoi(*Args[1])) });
+        Trade.SetOffer(1, { FEveItemStack(FCString::Atoi(*Args[2]), FCString::Atoi(*Args[3])) });
+
+        FString Error;
+        if (Trade.Prepare(&Error) && Trade.Commit(&Error))
+        {
+            UE_LOG(LogEveInventory, Display, TEXT("Trade committed"));
+        }
+        else
+        {
+            UE_LOG(LogEveInventory, Display, TEXT("Trade aborted: %s"), *Error);
+        }
+    }));
+
+/**
+ * 不依赖 PIE 的双背包交易检查：两个共享配置的临时背包完成一次交易，
+ * 预留期间向预留格子移动物品必须失败，提交后双方的数量与内部结构必须正确。
+ */
+static FAutoConsoleCommandWithWorldAndArgs GEveTestTradeHeadlessCmd(
+    TEXT("Eve.TestTradeHeadless"),
+    TEXT("Run a two-inventory trade on headless inventories and check the result. Usage: Eve.TestTradeHeadless [TIDA] [TIDB]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+        const UEveInventoryMgr* Source = GameInstance ? GameInstance->GetSubsystem<UEveInventoryMgr>() : nullptr;
+        if (!Source) return;
+
+        // 默认取前两个物品配置
+        int32 TIDs[2] = { INDEX_NONE, INDEX_NONE };
+        for (int32 Side = 0; Side < 2; Side++)
+        {
+            const UEveItemCfg* ItemCfg = Source->GetCfgByIdx(Side);
+            TIDs[Side] = Args.IsValidIndex(Side) ? FCString::Atoi(*Args[Side]) : ItemCfg ? ItemCfg->ItemData.TID : INDEX_NONE;
+        }
+        if (TIDs[0] == TIDs[1] || Source->FindCfgIdx(TIDs[0]) == INDEX_NONE || Source->FindCfgIdx(TIDs[1]) == INDEX_NONE)
+        {
+            UE_LOG(LogEveInventory, Warning, TEXT("Eve.TestTradeHeadless needs two different configured TIDs"));
+            return;
+        }
+
+        TStrongObjectPtr<UEveInventoryMgr> Inventories[2];
+        for (int32 Side = 0; Side < 2; Side++)
+        {
+            Inventories[Side].Reset(NewObject<UEveInventoryMgr>(Source->GetGameInstance()));
+            Inventories[Side]->InitializeHeadless(*Source);
+            Inventories[Side]->SetCapacityLimits(0.f, 0.f); // 只检查格子与预留，不受负重限制
+            Inventories[Side]->AddItemByTID(TIDs[Side], 3);
+        }
+        UEveInventoryMgr& InventoryA = *Inventories[0];
+        UEveInventoryMgr& InventoryB = *Inventories[1];
+
+        TArray<FString> Failures;
+        auto Check = [&Failures](const bool bCondition, const TCHAR* What)
+        {
+            if (!bCondition) Failures.Add(What);
+        };
+
+        FEveInventoryTrade Trade(&InventoryA, &InventoryB);
+        Trade.SetOffer(0, { FEveItemStack(TIDs[0], 2) });
+        Trade.SetOffer(1, { FEveItemStack(TIDs[1], 3) });
+
+        FString Error;
+        Check(Trade.Prepare(&Error), TEXT("Prepare"));
+
+        // A 保留一部分物品又收到新物品，需要预留一个格子；预留期间拖动物品到该格子必须被拒绝，已用格子数不变
+        int32 ReservedPosIdx = INDEX_NONE;
+        for (int32 PosIdx = 0; PosIdx < InventoryA.SlotNum && ReservedPosIdx == INDEX_NONE; PosIdx++)
+        {
+            ReservedPosIdx = InventoryA.IsSlotReserved(PosIdx) ? PosIdx : INDEX_NONE;
+        }
+        Check(ReservedPosIdx != INDEX_NONE, TEXT("Receiving side reserved a slot"));
+        if (ReservedPosIdx != INDEX_NONE)
+        {
+            const int32 UsedSlotNum = InventoryA.GetUsedSlotNum();
+            const int32 FromPosIdx = InventoryA.InventoryItems.FindChecked(TIDs[0])->PosIdx;
+            Check(!InventoryA.MoveItems({ FromPosIdx }, { ReservedPosIdx }), TEXT("MoveItems into a reserved slot is rejected"));
+            Check(InventoryA.GetUsedSlotNum() == UsedSlotNum, TEXT("Used slot count unchanged after rejected move"));
+        }
+
+        Check(Trade.Commit(&Error), TEXT("Commit"));
+        Check(InventoryA.GetItemAggregate(TIDs[0]).Amount == 1 && InventoryA.GetItemAggregate(TIDs[1]).Amount == 3, TEXT("Inventory A amounts"));
+        Check(InventoryB.GetItemAggregate(TIDs[0]).Amount == 2 && InventoryB.GetItemAggregate(TIDs[1]).Amount == 0, TEXT("Inventory B amounts"));
+
+        for (int32 Side = 0; Side < 2; Side++)
+        {
+            FString InvariantError;
+            if (!Inventories[Side]->CheckInvariants(&InvariantError))
+            {
+                Failures.Add(FString::Printf(TEXT("Inventory %c invariants: %s"), TEXT('A') + Side, *InvariantError));
+            }
+            for (int32 PosIdx = 0; PosIdx < Inventories[Side]->SlotNum; PosIdx++)
+            {
+                Check(!Inventories[Side]->IsSlotReserved(PosIdx), TEXT("Reservations released after commit"));
+            }
+        }
+
+        if (Failures.Num() > 0)
+        {
+            UE_LOG(LogEveInventory, Error, TEXT("Headless trade check failed (%s):\n  %s"), *Error, *FString::Join(Failures, TEXT("\n  ")));
+        }
+        else
+        {
+            UE_LOG(LogEveInventory, Display, TEXT("Headless trade check passed (items %d <-> %d)"), TIDs[0], TIDs[1]);
+        }
+    }));
+#endif
+
+FEveInventoryTrade::FEveInventoryTrade(UEveInventoryMgr* InventoryA, UEveInventoryMgr* InventoryB)
+{
+    Sides[0].Inventory = InventoryA;
+    Sides[1].Inventory = InventoryB;
+}
+
+FEveInventoryTrade::~FEveInventoryTrade()
+{
+    if (State == EState::Prepared)
+    {
+        Cancel();
+    }
+}
+
+/**
+ * 设置一方给出的物品。
+ */
+bool FEveInventoryTrade::SetOffer(const int32 Side, const TConstArrayView<FEveItemStack> Items)
+{
+    if (!ensure(Side == 0 || Side == 1)) return false;
+    if (State != EState::Open && State != EState::Prepared) return false;
+
+    TArray<FEveItemStack> Offer;
+    for (const FEveItemStack& Item : Items)
+    {
+        if (Item.Amount <= 0) return false;
+
+        // 合并同一 TID，校验时每个 TID 只计算一次
+        if (FEveItemStack* Existing = Offer.FindByPredicate([&Item](const FEveItemStack& Stack) { return Stack.TID == Item.TID; }))
+        {
+            Existing->Amount += Item.Amount;
+        }
+        else
+        {
+            Offer.Add(Item);
+        }
+    }
+
+    // 物品变化后之前的预留不再准确
+    ReleaseReservations();
+    State = EState::Open;
+
+    Sides[Side].Offer = MoveTemp(Offer);
+    return true;
+}
+
+/**
+ * 第一阶段：校验并预留容量。
+ */
+bool FEveInventoryTrade::Prepare(FString* OutError)
+{
+    if (State != EState::Open)
+    {
+        if (OutError) *OutError = TEXT("Trade is not open");
+        return false;
+    }
+
+    UEveInventoryMgr* InventoryA = Sides[0].Inventory.Get();
+    UEveInventoryMgr* InventoryB = Sides[1].Inventory.Get();
+    if (!InventoryA || !InventoryB || InventoryA == InventoryB)
+    {
+        if (OutError) *OutError = TEXT("Trade needs two different inventories");
+        return false;
+    }
+
+    int32 SlotCounts[2];
+    float Weights[2];
+    float Volumes[2];
+    for (int32 Side = 0; Side < 2; Side++)
+    {
+        if (!ValidateSide(Sides[Side], Sides[1 - Side], SlotCounts[Side], Weights[Side], Volumes[Side], OutError)) return false;
+    }
+
+    // 预留双方的容量，任一方失败时释放已预留的一方
+    for (int32 Side = 0; Side < 2; Side++)
+    {
+        if (!Sides[Side].Inventory->ReserveCapacity(SlotCounts[Side], Weights[Side], Volumes[Side], Sides[Side].Reservation))
+        {
+            ReleaseReservations();
+            if (OutError) *OutError = FString::Printf(TEXT("Inventory %c cannot reserve capacity"), TEXT('A') + Side);
+            return false;
+        }
+    }
+
+    State = EState::Prepared;
+    return true;
+}
+
+/**
+ * 第二阶段：提交交易。
+ */
+bool FEveInventoryTrade::Commit(FString* OutError)
+{
+    if (State != EState::Prepared)
+    {
+        if (OutError) *OutError = TEXT("Trade is not prepared");
+        return false;
+    }
+
+    UEveInventoryMgr* InventoryA = Sides[0].Inventory.Get();
+    UEveInventoryMgr* InventoryB = Sides[1].Inventory.Get();
+    if (!InventoryA || !InventoryB)
+    {
+        Cancel();
+        if (OutError) *OutError = TEXT("Inventory was destroyed");
+        return false;
+    }
+
+    // 释放预留后按当前状态重新校验：预留期间给出的物品可能已被移动或使用
+    ReleaseReservations();
+    for (int32 Side = 0; Side < 2; Side++)
+    {
+        int32 SlotCount;
+        float Weight;
+        float Volume;
+        if (!ValidateSide(Sides[Side], Sides[1 - Side], SlotCount, Weight, Volume, OutError))
+        {
+            State = EState::Aborted;
+            return false;
+        }
+    }
+
+    // 双方各只广播一次（包括回滚）
+    FEveInventoryBatchScope BatchA(InventoryA);
+    FEveInventoryBatchScope BatchB(InventoryB);
+
+    struct FJournalEntry
+    {
+        UEveInventoryMgr* Inventory;
+        int32 TID;
+        int32 Amount;
+        bool bAdded;
+    };
+    TArray<FJournalEntry, TInlineAllocator<16>> Journal;
+
+    // 先扣除双方给出的物品（空出格子与负重），再添加收到的物品
+    bool bSucceeded = true;
+    for (int32 Side = 0; Side < 2 && bSucceeded; Side++)
+    {
+        for (const FEveItemStack& Item : Sides[Side].Offer)
+        {
+            if (!Sides[Side].Inventory->RemoveItemByTID(Item.TID, Item.Amount))
+            {
+                bSucceeded = false;
+                break;
+            }
+            Journal.Add({ Sides[Side].Inventory.Get(), Item.TID, Item.Amount, false });
+        }
+    }
+    for (int32 Side = 0; Side < 2 && bSucceeded; Side++)
+    {
+        UEveInventoryMgr* Receiver = Sides[1 - Side].Inventory.Get();
+        for (const FEveItemStack& Item : Sides[Side].Offer)
+        {
+            if (!Receiver->AddItemByTID(Item.TID, Item.Amount))
+            {
+                bSucceeded = false;
+                break;
+            }
+            Journal.Add({ Receiver, Item.TID, Item.Amount, true });
+        }
+    }
+
+    if (!bSucceeded)
+    {
+        // 按日志逆序回滚（物品数量与总计还原，格子位置可能不同）
+        for (int32 Idx = Journal.Num() - 1; Idx >= 0; Idx--)
+        {
+            const FJournalEntry& Entry = Journal[Idx];
+            if (Entry.bAdded)
+            {
+                ensure(Entry.Inventory->RemoveItemByTID(Entry.TID, Entry.Amount));
+            }
+            else
+            {
+                ensure(Entry.Inventory->AddItemByTID(Entry.TID, Entry.Amount));
+            }
+        }
+
+        UE_LOG(LogEveInventory, Warning, TEXT("Trade rolled back after %d step(s)"), Journal.Num());
+        if (OutError) *OutError = TEXT("Trade failed during commit and was rolled back");
+        State = EState::Aborted;
+        return false;
+    }
+
+    State = EState::Committed;
+    return true;
+}
+
+/**
+ * 取消交易并释放预留。
+ */
+void FEveInventoryTrade::Cancel()
+{
+    ReleaseReservations();
+    if (State != EState::Committed)
+    {
+        State = EState::Aborted;
+    }
+}
+
+/**
+ * 校验一方的物品与容量。
+ * 
+ * 格子按净需求计算：全部给出的物品会空出格子，收到的物品在已有堆叠（且不会被全部给出）时不占用新格子。
+ */
+bool FEveInventoryTrade::ValidateSide(const FSide& Self, const FSide& Other, int32& OutSlotCount, float& OutWeight, float& OutVolume, FString* OutError)
+{
+    UEveInventoryMgr* Inventory = Self.Inventory.Get();
+    if (!Inventory)
+    {
+        if (OutError) *OutError = TEXT("Inventory was destroyed");
+        return false;
+    }
+
+    OutWeight = 0.f;
+    OutVolume = 0.f;
+
+    auto GivesAll = [&Self, Inventory](const int32 TID)
+    {
+        const FEveItemStack* Given = Self.Offer.FindByPredicate([TID](const FEveItemStack& Stack) { return Stack.TID == TID; });
+        return Given && Inventory->GetItemAggregate(TID).Amount == Given->Amount;
+    };
+
+    int32 FreedSlots = 0;
+    for (const FEveItemStack& Item : Self.Offer)
+    {
+        const FEveItemAggregate& Aggregate = Inventory->GetItemAggregate(Item.TID);
+        if (Aggregate.Amount < Item.Amount)
+        {
+            if (OutError) *OutError = FString::Printf(TEXT("Not enough of item %d to give (%d < %d)"), Item.TID, Aggregate.Amount, Item.Amount);
+            return false;
+        }
+
+        const UEveItemCfg* ItemCfg = Inventory->GetCfgByIdx(Inventory->FindCfgIdx(Item.TID));
+        if (!ensure(ItemCfg)) return false;
+
+        OutWeight -= Item.Amount * ItemCfg->ItemData.Weight;
+        OutVolume -= Item.Amount * ItemCfg->ItemData.Volume;
+        FreedSlots += Aggregate.Amount == Item.Amount ? 1 : 0;
+    }
+
+    int32 NeededSlots = 0;
+    for (const FEveItemStack& Item : Other.Offer)
+    {
+        float Weight = 0.f;
+        float Volume = 0.f;
+        if (!Inventory->FindItemFootprint(Item.TID, Weight, Volume))
+        {
+            if (OutError) *OutError = FString::Printf(TEXT("Item %d has no config"), Item.TID);
+            return false;
+        }
+
+        OutWeight += Item.Amount * Weight;
+        OutVolume += Item.Amount * Volume;
+        if (!Inventory->InventoryItems.Contains(Item.TID) || GivesAll(Item.TID))
+        {
+            NeededSlots++;
+        }
+    }
+
+    OutSlotCount = FMath::Max(NeededSlots - FreedSlots, 0);
+    if (Inventory->GetUsedSlotNum() - FreedSlots + NeededSlots > Inventory->SlotNum || !Inventory->FitsCapacity(OutWeight, OutVolume))
+    {
+        if (OutError) *OutError = TEXT("Receiving inventory is full");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 释放双方的预留。
+ */
+void FEveInventoryTrade::ReleaseReservations()
+{
+    for (FSide& Side : Sides)
+    {
+        if (UEveInventoryMgr* Inventory = Side.Inventory.Get(); Inventory && !Side.Reservation.IsEmpty())
+        {
+            Inventory->ReleaseReservation(Side.Reservation);
+        }
+        Side.Reservation = FEveInventoryReservation();
+    }
+}
@@ -0,0 +1,101 @@
+﻿// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EveInventoryMgr.h"
+
+/**
+ * 两个背包之间的交易（两阶段提交）。
+ * 
+ * - `SetOffer`：双方各自设置给出的物品（同一 TID 合并）
+ * - `Prepare`：校验双方的物品与容量（按净流入计算格子、负重、体积），并在双方背包中预留容量
+ * - `Commit`：释放预留后重新校验，在双方的批量修改中扣除与添加，任何一步失败都按日志逆序回滚
+ * - `Cancel` / 析构：释放预留，双方背包保持不变
+ * 
+ * 交易只持有两个背包的弱引用，不依赖全局状态，多个 PIE 客户端各自的背包之间也可以交易；
+ * 无论成功还是回滚，每个背包只广播一次更新。
+ */
+class FEveInventoryTrade : public FNoncopyable
+{
+public:
+	/** 交易状态 */
+	enum class EState : uint8
+	{
+		/** 正在设置双方的物品 */
+		Open,
+		/** 已校验并预留容量，等待提交 */
+		Prepared,
+		/** 已提交 */
+		Committed,
+		/** 已取消或提交失败（已回滚） */
+		Aborted,
+	};
+
+	FEveInventoryTrade(UEveInventoryMgr* InventoryA, UEveInventoryMgr* InventoryB);
+
+	~FEveInventoryTrade();
+
+	/**
+	 * 设置一方给出的物品，已预留的容量会被释放，需要重新 `Prepare`。
+	 * @param Side 0 表示背包 A，1 表示背包 B。
+	 * @param Items 给出的物品堆叠（数量必须大于 0）。
+	 * @return 是否设置成功。
+	 */
+	bool SetOffer(int32 Side, TConstArrayView<FEveItemStack> Items);
+
+	/**
+	 * 第一阶段：校验双方的物品与容量，并预留容量。
+	 * @param OutError 可选输出，失败原因。
+	 * @return 是否可以提交。
+	 */
+	bool Prepare(FString* OutError = nullptr);
+
+	/**
+	 * 第二阶段：提交交易，双方一起成功或一起回滚。
+	 * @param OutError 可选输出，失败原因。
+	 * @return 是否提交成功。
+	 */
+	bool Commit(FString* OutError = nullptr);
+
+	/**
+	 * 取消交易并释放预留。
+	 */
+	void Cancel();
+
+	/** 当前状态 */
+	EState GetState() const { return State; }
+
+private:
+	/** 交易的一方 */
+	struct FSide
+	{
+		/** 该方的背包 */
+		TWeakObjectPtr<UEveInventoryMgr> Inventory;
+
+		/** 该方给出的物品（TID 不重复） */
+		TArray<FEveItemStack> Offer;
+
+		/** 在该方背包中预留的容量 */
+		FEveInventoryReservation Reservation;
+	};
+
+	/**
+	 * 校验一方：给出的物品足够，收到对方的物品后容量不超限。
+	 * @param Self 被校验的一方。
+	 * @param Other 对方（提供收到的物品）。
+	 * @param OutSlotCount 需要额外占用的格子数量。
+	 * @param OutWeight 净增加的负重。
+	 * @param OutVolume 净增加的体积。
+	 * @param OutError 可选输出，失败原因。
+	 */
+	static bool ValidateSide(const FSide& Self, const FSide& Other, int32& OutSlotCount, float& OutWeight, float& OutVolume, FString* OutError);
+
+	/** 释放双方的预留 */
+	void ReleaseReservations();
+
+private:
+	FSide Sides[2];
+
+	EState State = EState::Open;
+};
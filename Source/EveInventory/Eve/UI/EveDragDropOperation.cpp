@@ -0,0 +1,110 @@
+// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#include "EveDragDropOperation.h"
+
+#include "Components/Image.h"
+#include "EveInventory/EveInventory.h"
+
+/**
+ * @brief 拖拽成功放下
+ *
+ * 先执行父类逻辑（广播 `OnDrop`），再归还到对象池。
+ */
+void UEveDragDropOperation::Drop_Implementation(const FPointerEvent& PointerEvent)
+{
+	Super::Drop_Implementation(PointerEvent);
+
+	if (OwnerPool.IsValid())
+	{
+		OwnerPool->Release(this);
+	}
+}
+
+/**
+ * @brief 拖拽取消
+ *
+ * `UUserWidget::NativeOnDragCancelled` 在此之前已被调用，此时负载已使用完毕，可以安全归还。
+ */
+void UEveDragDropOperation::DragCancelled_Implementation(const FPointerEvent& PointerEvent)
+{
+	Super::DragCancelled_Implementation(PointerEvent);
+
+	if (OwnerPool.IsValid())
+	{
+		OwnerPool->Release(this);
+	}
+}
+
+/**
+ * @brief 预先创建拖拽操作
+ */
+void UEveDragDropPool::Prewarm(const int32 Num)
+{
+	FreeOperations.Reserve(Num);
+	AllOperations.Reserve(Num);
+
+	while (AllOperations.Num() < Num)
+	{
+		FreeOperations.Add(CreateOperation());
+	}
+}
+
+/**
+ * @brief 取出一个拖拽操作并填充负载
+ */
+UEveDragDropOperation* UEveDragDropPool::Acquire(const FEveDragPayload& Payload, const FSlateBrush& IconBrush)
+{
+	UEveDragDropOperation* Operation = FreeOperations.Num() > 0 ? FreeOperations.Pop(EveNoShrink) : CreateOperation();
+	if (!ensure(Operation)) return nullptr;
+
+	Operation->bInUse = true;
+
+	// 逐项写入负载，`PosIdxes` 复用已有容量
+	FEveDragPayload& OprPayload = Operation->EvePayload;
+	OprPayload.TID = Payload.TID;
+	OprPayload.PosIdx = Payload.PosIdx;
+	OprPayload.PosIdxes.Reset();
+	OprPayload.PosIdxes.Append(Payload.PosIdxes);
+	OprPayload.SourceWidget = Payload.SourceWidget;
+
+	// 图标未变化时无需重新设置画刷；同一 TID 的图标可能被热重载或资源包替换，因此比较画刷本身
+	if (Operation->BrushTID != Payload.TID || !(Operation->DragImage->GetBrush() == IconBrush))
+	{
+		Operation->DragImage->SetBrush(IconBrush);
+		Operation->BrushTID = Payload.TID;
+	}
+
+	return Operation;
+}
+
+/**
+ * @brief 归还拖拽操作
+ */
+void UEveDragDropPool::Release(UEveDragDropOperation* Operation)
+{
+	if (!ensure(Operation)) return;
+	if (!Operation->bInUse) return; // 已归还过
+
+	Operation->bInUse = false;
+	Operation->EvePayload.Reset();
+	FreeOperations.Add(Operation);
+}
+
+/**
+ * @brief 创建一个新的拖拽操作（含拖拽图片）
+ */
+UEveDragDropOperation* UEveDragDropPool::CreateOperation()
+{
+	UEveDragDropOperation* Operation = NewObject<UEveDragDropOperation>(this);
+
+	// 拖拽图片作为操作的子对象，随操作一起复用
+	Operation->DragImage = NewObject<UImage>(Operation);
+	Operation->DragImage->SetRenderScale(FVector2D(DragVisualScale));
+
+	Operation->DefaultDragVisual = Operation->DragImage;
+	Operation->Pivot = EDragPivot::CenterCenter;
+	Operation->OwnerPool = this;
+
+	AllOperations.Add(Operation);
+	return Operation;
+}
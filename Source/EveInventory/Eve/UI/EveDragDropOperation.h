@@ -0,0 +1,138 @@
+// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/DragDropOperation.h"
+#include "EveDragDropOperation.generated.h"
+
+class UImage;
+class UEveItemWidget;
+class UEveDragDropPool;
+
+/**
+ * @brief 拖拽负载数据
+ *
+ * 替代 `Payload = this` 的强类型负载，拖拽目标无需再 `Cast` 回 `UEveItemWidget`。
+ */
+USTRUCT(BlueprintType)
+struct FEveDragPayload
+{
+	GENERATED_BODY()
+
+public:
+	/** 被拖拽物品的 TID */
+	UPROPERTY(BlueprintReadOnly, Category = "Drag")
+	int32 TID = -1;
+
+	/** 被拖拽物品的原格子索引 */
+	UPROPERTY(BlueprintReadOnly, Category = "Drag")
+	int32 PosIdx = -1;
+
+	/** 一起被拖拽的所有格子索引（包含 `PosIdx`，多选整体拖拽时有多个） */
+	UPROPERTY(BlueprintReadOnly, Category = "Drag")
+	TArray<int32> PosIdxes;
+
+	/** 发起拖拽的物品 UI（弱引用，避免延长其生命周期） */
+	UPROPERTY(BlueprintReadOnly, Category = "Drag")
+	TWeakObjectPtr<UEveItemWidget> SourceWidget;
+
+	/** 重置为无效负载 */
+	void Reset()
+	{
+		TID = -1;
+		PosIdx = -1;
+		PosIdxes.Reset(); // 保留容量，复用时不再分配
+		SourceWidget.Reset();
+	}
+};
+
+/**
+ * @brief 可复用的拖拽操作
+ *
+ * 拖拽结束（放下或取消）后自动归还给所属的 `UEveDragDropPool`，
+ * 拖拽图片 `DragImage` 随操作一起复用，不会在每次拖拽时重新创建。
+ */
+UCLASS()
+class UEveDragDropOperation : public UDragDropOperation
+{
+	GENERATED_BODY()
+
+public:
+	/** 拖拽成功放下时调用，归还到对象池 */
+	virtual void Drop_Implementation(const FPointerEvent& PointerEvent) override;
+
+	/** 拖拽取消时调用，归还到对象池 */
+	virtual void DragCancelled_Implementation(const FPointerEvent& PointerEvent) override;
+
+public:
+	/** 强类型拖拽负载 */
+	UPROPERTY(BlueprintReadOnly, Category = "Drag")
+	FEveDragPayload EvePayload;
+
+	/** 复用的拖拽图片 */
+	UPROPERTY()
+	TObjectPtr<UImage> DragImage;
+
+	/** 当前 `DragImage` 显示的 TID，TID 与画刷都相同时跳过画刷设置 */
+	int32 BrushTID = -1;
+
+	/** 所属对象池 */
+	TWeakObjectPtr<UEveDragDropPool> OwnerPool;
+
+	/** 是否正在被使用（防止重复归还） */
+	bool bInUse = false;
+};
+
+/**
+ * @brief 拖拽操作对象池
+ *
+ * 由 `UEveInventoryUI` 持有，预先创建少量 `UEveDragDropOperation` 及其拖拽图片。
+ * 每次拖拽开始时从空闲列表取出，结束时归还，拖拽过程不产生新的 UObject。
+ */
+UCLASS()
+class UEveDragDropPool : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * @brief 预先创建拖拽操作
+	 *
+	 * @param Num 需要预创建的数量
+	 */
+	void Prewarm(int32 Num);
+
+	/**
+	 * @brief 取出一个拖拽操作并填充负载
+	 *
+	 * 空闲列表为空时才会新建（例如多点触控同时拖拽）。
+	 *
+	 * @param Payload 拖拽负载
+	 * @param IconBrush 拖拽时显示的图标画刷（图集画刷）
+	 * @return 可直接作为 `OutOperation` 返回的拖拽操作
+	 */
+	UEveDragDropOperation* Acquire(const FEveDragPayload& Payload, const FSlateBrush& IconBrush);
+
+	/**
+	 * @brief 归还拖拽操作
+	 *
+	 * @param Operation 已结束的拖拽操作
+	 */
+	void Release(UEveDragDropOperation* Operation);
+
+	/** 拖拽图片的缩放比例 */
+	float DragVisualScale = 2.0f;
+
+private:
+	/** 创建一个新的拖拽操作（含拖拽图片） */
+	UEveDragDropOperation* CreateOperation();
+
+	/** 空闲的拖拽操作 */
+	UPROPERTY()
+	TArray<TObjectPtr<UEveDragDropOperation>> FreeOperations;
+
+	/** 池中所有拖拽操作（保持引用，防止被 GC） */
+	UPROPERTY()
+	TArray<TObjectPtr<UEveDragDropOperation>> AllOperations;
+};
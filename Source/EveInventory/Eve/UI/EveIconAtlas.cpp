@@ -0,0 +1,221 @@
+// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#include "EveIconAtlas.h"
+
+#include "CanvasItem.h"
+#include "CanvasTypes.h"
+#include "Engine/Texture2D.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "EveInventory/EveInventory.h"
+#include "EveInventory/Eve/Data/EveItemData.h"
+#include "TextureResource.h"
+
+/**
+ * @brief 构建图集
+ * 
+ * 所有格子在同一次 `FCanvas` 提交中绘制，每页只刷新一次渲染目标。
+ */
+void UEveIconAtlas::Build(const TArray<TObjectPtr<UEveItemCfg>>& ItemCfgs)
+{
+	Pages.Reset();
+	TIDToTile.Reset();
+	TileNum = 0;
+
+	// 统计图标已加载的物品，计算所需页数；未加载的图标不在启动时加载
+	TArray<UEveItemCfg*> IconCfgs;
+	TArray<UTexture2D*> Icons;
+	IconCfgs.Reserve(ItemCfgs.Num());
+	for (UEveItemCfg* ItemCfg : ItemCfgs)
+	{
+		if (UTexture2D* Icon = ItemCfg ? ItemCfg->GetDisplayIcon().Get() : nullptr)
+		{
+			IconCfgs.Add(ItemCfg);
+			Icons.Add(Icon);
+		}
+	}
+	if (IconCfgs.Num() == 0) return;
+
+	const int32 TilesPerRow = GetTilesPerRow();
+	const int32 TilesPerPage = TilesPerRow * TilesPerRow;
+	const int32 PageNum = FMath::DivideAndRoundUp(IconCfgs.Num(), TilesPerPage);
+
+	for (int32 PageIdx = 0; PageIdx < PageNum; PageIdx++)
+	{
+		// 最后一页按实际占用的行列缩小尺寸（保持为 2 的幂）
+		const int32 PageTiles = FMath::Min(TilesPerPage, IconCfgs.Num() - PageIdx * TilesPerPage);
+		const int32 UsedCols = FMath::Min(PageTiles, TilesPerRow);
+		const int32 UsedRows = FMath::DivideAndRoundUp(PageTiles, TilesPerRow);
+		const int32 PageSize = FMath::Min<int32>(FMath::RoundUpToPowerOfTwo(FMath::Max(UsedCols, UsedRows) * TileSize), MaxPageSize);
+
+		UTextureRenderTarget2D* Page = CreatePage(PageSize);
+		if (!ensure(Page)) return;
+
+		FCanvas Canvas(Page->GameThread_GetRenderTargetResource(), nullptr, FGameTime(), GMaxRHIFeatureLevel);
+		Canvas.Clear(FLinearColor::Transparent);
+
+		for (int32 Local = 0; Local < PageTiles; Local++)
+		{
+			const int32 TileIdx = PageIdx * TilesPerPage + Local;
+			UEveItemCfg* ItemCfg = IconCfgs[TileIdx];
+
+			const FVector2D TilePos((Local % TilesPerRow) * TileSize, (Local / TilesPerRow) * TileSize);
+			FCanvasTileItem TileItem(TilePos, Icons[TileIdx]->GetResource(), FVector2D(TileSize), FLinearColor::White);
+			TileItem.BlendMode = SE_BLEND_Translucent;
+			Canvas.DrawItem(TileItem);
+
+			TIDToTile.Add(ItemCfg->ItemData.TID, TileIdx);
+		}
+
+		Canvas.Flush_GameThread(true);
+	}
+	TileNum = IconCfgs.Num();
+
+	// 生成画刷；没有图标或图标未加载的物品使用回退画刷
+	for (UEveItemCfg* ItemCfg : ItemCfgs)
+	{
+		if (!ItemCfg) continue;
+
+		if (const int32* TileIdx = TIDToTile.Find(ItemCfg->ItemData.TID))
+		{
+			ApplyBrush(*TileIdx, ItemCfg);
+		}
+		else
+		{
+			ApplyFallbackBrush(ItemCfg);
+		}
+	}
+
+	UE_LOG(LogEveInventory, Log, TEXT("Icon atlas built: %d icons in %d page(s)"), TileNum, Pages.Num());
+}
+
+/**
+ * @brief 添加或重绘单个物品图标
+ */
+void UEveIconAtlas::AddOrUpdateIcon(UEveItemCfg* ItemCfg)
+{
+	if (!ensure(ItemCfg)) return;
+	if (ItemCfg->GetDisplayIcon().IsNull())
+	{
+		ApplyFallbackBrush(ItemCfg);
+		return;
+	}
+
+	UTexture2D* Icon = ItemCfg->GetDisplayIcon().Get();
+	if (!Icon) return;
+
+	int32 TileIdx;
+	if (const int32* ExistingTile = TIDToTile.Find(ItemCfg->ItemData.TID))
+	{
+		TileIdx = *ExistingTile;
+	}
+	else
+	{
+		const int32 TilesPerRow = GetTilesPerRow();
+		const int32 TilesPerPage = TilesPerRow * TilesPerRow;
+		TileIdx = TileNum;
+
+		// `Build` 会按实际占用缩小最后一页，放不下新格子时跳到下一整页的第一个格子（缩小页剩余的格子不再使用），
+		// 格子索引与页的对应关系保持不变
+		if (const int32 PageIdx = TileIdx / TilesPerPage; Pages.IsValidIndex(PageIdx))
+		{
+			const UTextureRenderTarget2D* Page = Pages[PageIdx];
+			const int32 Local = TileIdx % TilesPerPage;
+			if (((Local / TilesPerRow) + 1) * TileSize > Page->SizeY || ((Local % TilesPerRow) + 1) * TileSize > Page->SizeX)
+			{
+				TileIdx = (PageIdx + 1) * TilesPerPage;
+			}
+		}
+
+		// 需要的页数超出时追加一整页
+		if (TileIdx / TilesPerPage >= Pages.Num() && !ensure(CreatePage(MaxPageSize)))
+		{
+			ApplyFallbackBrush(ItemCfg);
+			return;
+		}
+
+		TileNum = TileIdx + 1;
+		TIDToTile.Add(ItemCfg->ItemData.TID, TileIdx);
+	}
+
+	DrawTile(TileIdx, Icon);
+	ApplyBrush(TileIdx, ItemCfg);
+}
+
+/**
+ * @brief 创建一个新的图集页
+ */
+UTextureRenderTarget2D* UEveIconAtlas::CreatePage(const int32 PageSize)
+{
+	UTextureRenderTarget2D* Page = NewObject<UTextureRenderTarget2D>(this);
+	Page->ClearColor = FLinearColor::Transparent;
+	Page->InitCustomFormat(PageSize, PageSize, PF_B8G8R8A8, false);
+	Page->UpdateResourceImmediate(true);
+
+	Pages.Add(Page);
+	return Page;
+}
+
+/**
+ * @brief 将图标绘制到指定格子（只刷新该格子）
+ */
+void UEveIconAtlas::DrawTile(const int32 TileIdx, UTexture2D* Icon) const
+{
+	const int32 TilesPerRow = GetTilesPerRow();
+	const int32 TilesPerPage = TilesPerRow * TilesPerRow;
+	UTextureRenderTarget2D* Page = Pages[TileIdx / TilesPerPage];
+	const int32 Local = TileIdx % TilesPerPage;
+
+	const FVector2D TilePos((Local % TilesPerRow) * TileSize, (Local / TilesPerRow) * TileSize);
+
+	FCanvas Canvas(Page->GameThread_GetRenderTargetResource(), nullptr, FGameTime(), GMaxRHIFeatureLevel);
+
+	// 先清空该格子，再绘制新图标
+	FCanvasTileItem ClearItem(TilePos, FVector2D(TileSize), FLinearColor::Transparent);
+	ClearItem.BlendMode = SE_BLEND_Opaque;
+	Canvas.DrawItem(ClearItem);
+
+	FCanvasTileItem TileItem(TilePos, Icon->GetResource(), FVector2D(TileSize), FLinearColor::White);
+	TileItem.BlendMode = SE_BLEND_Translucent;
+	Canvas.DrawItem(TileItem);
+
+	Canvas.Flush_GameThread(true);
+}
+
+/**
+ * @brief 为指定格子生成画刷并写入物品配置
+ */
+void UEveIconAtlas::ApplyBrush(const int32 TileIdx, UEveItemCfg* ItemCfg) const
+{
+	const int32 TilesPerRow = GetTilesPerRow();
+	const int32 TilesPerPage = TilesPerRow * TilesPerRow;
+	UTextureRenderTarget2D* Page = Pages[TileIdx / TilesPerPage];
+	const int32 Local = TileIdx % TilesPerPage;
+
+	const float U0 = static_cast<float>((Local % TilesPerRow) * TileSize) / Page->SizeX;
+	const float V0 = static_cast<float>((Local / TilesPerRow) * TileSize) / Page->SizeY;
+	const float U1 = U0 + static_cast<float>(TileSize) / Page->SizeX;
+	const float V1 = V0 + static_cast<float>(TileSize) / Page->SizeY;
+
+	FSlateBrush& Brush = ItemCfg->ItemData.IconBrush;
+	Brush = FSlateBrush();
+	Brush.DrawAs = ESlateBrushDrawType::Image;
+	Brush.SetResourceObject(Page);
+	Brush.ImageSize = FVector2D(TileSize);
+	Brush.SetUVRegion(FBox2f(FVector2f(U0, V0), FVector2f(U1, V1)));
+}
+
+/**
+ * @brief 回退方案：直接使用图标纹理作为画刷
+ */
+void UEveIconAtlas::ApplyFallbackBrush(UEveItemCfg* ItemCfg)
+{
+	FSlateBrush& Brush = ItemCfg->ItemData.IconBrush;
+	Brush = FSlateBrush();
+	Brush.DrawAs = ESlateBrushDrawType::Image;
+
+	if (UTexture2D* Icon = ItemCfg->GetDisplayIcon().Get())
+	{
+		Brush.SetResourceObject(Icon);
+		Brush.ImageSize = FVector2D(Icon->GetSizeX(), Icon->GetSizeY());
+	}
+}
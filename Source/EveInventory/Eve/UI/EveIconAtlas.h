@@ -0,0 +1,87 @@
+// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "EveIconAtlas.generated.h"
+
+class UEveItemCfg;
+class UTexture2D;
+class UTextureRenderTarget2D;
+
+/**
+ * @brief 物品图标图集
+ * 
+ * 启动时将已加载的物品图标绘制到少量渲染目标（图集页）上，
+ * 并为每个 `FEveItemData` 生成指向图集 UV 区域的 `IconBrush`；
+ * 其余图标在物品进入背包、异步加载完成后通过 `AddOrUpdateIcon` 追加。
+ * 同一页上的图标共享同一个纹理资源，Slate 可以将整格图标合并为少数几个绘制批次。
+ */
+UCLASS()
+class UEveIconAtlas : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * @brief 构建图集
+	 * 
+	 * - 按 `TileSize` 划分图集页，每页最多 `MaxPageSize` x `MaxPageSize`
+	 * - 将每个图标已加载的物品绘制到对应格子（不触发加载）
+	 * - 写入每个物品配置的 `IconBrush`
+	 * 
+	 * @param ItemCfgs 所有物品配置
+	 */
+	void Build(const TArray<TObjectPtr<UEveItemCfg>>& ItemCfgs);
+
+	/**
+	 * @brief 添加或重绘单个物品图标
+	 * 
+	 * 已有格子的物品只重绘该格子，新物品追加到图集末尾（最后一页已满或被缩小而放不下时新建一整页）。
+	 * 图标尚未加载时不做处理，由调用方先异步加载图标。
+	 * 
+	 * @param ItemCfg 物品配置
+	 */
+	void AddOrUpdateIcon(UEveItemCfg* ItemCfg);
+
+	/** @brief 物品图标是否已绘制到图集 */
+	bool HasIcon(const int32 TID) const { return TIDToTile.Contains(TID); }
+
+	/** @brief 图集页数量（即整格图标所需的绘制批次数） */
+	int32 GetPageNum() const { return Pages.Num(); }
+
+public:
+	/** 每个图标在图集中的像素尺寸 */
+	int32 TileSize = 128;
+
+	/** 单个图集页的最大像素尺寸 */
+	int32 MaxPageSize = 2048;
+
+private:
+	/** 每页的行列格子数 */
+	int32 GetTilesPerRow() const { return FMath::Max(1, MaxPageSize / TileSize); }
+
+	/** 创建一个新的图集页 */
+	UTextureRenderTarget2D* CreatePage(int32 PageSize);
+
+	/** 将图标绘制到指定格子 */
+	void DrawTile(int32 TileIdx, UTexture2D* Icon) const;
+
+	/** 为指定格子生成画刷并写入物品配置 */
+	void ApplyBrush(int32 TileIdx, UEveItemCfg* ItemCfg) const;
+
+	/** 回退方案：直接使用图标纹理作为画刷 */
+	static void ApplyFallbackBrush(UEveItemCfg* ItemCfg);
+
+private:
+	/** 图集页 */
+	UPROPERTY()
+	TArray<TObjectPtr<UTextureRenderTarget2D>> Pages;
+
+	/** 物品 TID 到格子索引的映射 */
+	TMap<int32, int32> TIDToTile;
+
+	/** 已分配的格子数量（含缩小页上跳过的格子，即下一个新格子的索引） */
+	int32 TileNum = 0;
+};
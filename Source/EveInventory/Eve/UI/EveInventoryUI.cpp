@@ -2,12 +2,79 @@
 
 #include "EveInventoryUI.h"
 
+#include "EveDragDropOperation.h"
+#include "EveIconAtlas.h"
 #include "EveInventoryWidget.h"
+#include "EveItemTextCache.h"
+#include "EveItemTooltipWidget.h"
 #include "EveItemWidget.h"
+#include "Blueprint/WidgetTree.h"
 #include "Components/Image.h"
 #include "Components/UniformGridPanel.h"
+#include "Engine/Texture2D.h"
+#include "EveInventory/EveInventory.h"
 #include "EveInventory/Eve/Asset/EveAssetMgr.h"
+#include "EveInventory/Eve/Data/EveItemDefinition.h"
 #include "EveInventory/Eve/Manager/EveInventoryMgr.h"
+#include "EveInventory/Eve/Manager/EveInventoryScheduler.h"
+#include "Widgets/SToolTip.h"
+#include "UObject/UObjectArray.h"
+
+DECLARE_CYCLE_STAT(TEXT("Inventory UI Construction"), STAT_EveInventoryUIConstruction, STATGROUP_EveInventory);
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GEveInventoryMemReportCmd(
+	TEXT("Eve.InventoryMemReport"),
+	TEXT("Report inventory memory per slot, per item config and per item widget, broken down by structure."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		if (!GameInstance) return;
+
+		if (const UEveInventoryMgr* InventoryMgr = GameInstance->GetSubsystem<UEveInventoryMgr>())
+		{
+			InventoryMgr->ReportMemory(Ar);
+		}
+		if (const UEveInventoryUI* InventoryUI = GameInstance->GetSubsystem<UEveInventoryUI>())
+		{
+			InventoryUI->ReportMemory(Ar);
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GEveItemAssetMemReportCmd(
+	TEXT("Eve.ItemAssetMemReport"),
+	TEXT("Report resident item icons and world assets. 'all' also loads every item asset synchronously to measure the all-in DataTable cost. Usage: Eve.ItemAssetMemReport [all]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		const UEveInventoryMgr* InventoryMgr = GameInstance ? GameInstance->GetSubsystem<UEveInventoryMgr>() : nullptr;
+		if (!InventoryMgr) return;
+
+		// 数据表中的图标（整表加载时这些图标随数据表常驻）
+		TArray<FSoftObjectPath> IconPaths;
+		IconPaths.Reserve(InventoryMgr->ItemCfgs.Num());
+		for (const UEveItemCfg* ItemCfg : InventoryMgr->ItemCfgs)
+		{
+			if (ItemCfg && !ItemCfg->ItemData.Icon.IsNull())
+			{
+				IconPaths.Add(ItemCfg->ItemData.Icon.ToSoftObjectPath());
+			}
+		}
+
+		const bool bLoadAll = Args.Num() > 0 && Args[0].Equals(TEXT("all"), ESearchCase::IgnoreCase);
+		UEveAssetMgr::Get().ReportItemAssetMemory(Ar, IconPaths, bLoadAll);
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs GEveToggleInventoryCmd(
+	TEXT("Eve.ToggleInventory"),
+	TEXT("Open or close the inventory. The first open logs its latency."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		if (UEveInventoryUI* InventoryUI = GameInstance ? GameInstance->GetSubsystem<UEveInventoryUI>() : nullptr)
+		{
+			InventoryUI->ToggleInventory();
+		}
+	}));
 
 /**
  * @brief 初始化背包 UI 子系统
@@ -18,11 +85,28 @@ void UEveInventoryUI::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
 
+	// 缓存背包管理子系统，热路径不再反复 `GetSubsystem`
+	InventoryMgr = Collection.InitializeDependency<UEveInventoryMgr>();
+	TextCache = Collection.InitializeDependency<UEveItemTextCache>();
+	Scheduler = Collection.InitializeDependency<UEveInventoryScheduler>();
+
 	// 在下一帧创建 UI，确保有效
 	GetWorld()->GetTimerManager().SetTimerForNextTick([this]()
 	{
+		if (bStagedConstruction)
+		{
+			BeginStagedConstruction();
+			return;
+		}
+
 		CreateUI();
 		BindUIEvent();
+		Stage = EEveInventoryUIStage::Ready;
+		bInventoryOpen = InventoryUI != nullptr;
+		if (!bOpenOnStart)
+		{
+			CloseInventory();
+		}
 	});
 }
 
@@ -33,89 +117,761 @@ void UEveInventoryUI::Initialize(FSubsystemCollectionBase& Collection)
  */
 void UEveInventoryUI::CreateUI()
 {
-	// 从资产管理器 `UEveAssetMgr` 中获取 `InventoryClass` 并创建 UI
+	CreateRootWidget();
+	if (!InventoryUI) return;
+
+	// 创建常驻的格子 UI，并完整同步一次
+	CreateSlotWidgets();
+	UpdateInventory();
+
+	// 预创建拖拽操作，避免首次拖拽时分配
+	GetDragDropPool();
+}
+
+/**
+ * @brief 构建物品图标图集并创建背包 UI 根组件
+ */
+void UEveInventoryUI::CreateRootWidget()
+{
+	// 构建物品图标图集，为每个物品配置生成图集画刷
+	IconAtlas = NewObject<UEveIconAtlas>(this);
+	IconAtlas->Build(InventoryMgr->ItemCfgs);
+
+	// 从资产管理器 `UEveAssetMgr` 中获取背包 UI 类并创建 UI
 	InventoryUI = Cast<UEveInventoryWidget>(
-		UUserWidget::CreateWidgetInstance(*GetGameInstance(), UEveAssetMgr::Get().InventoryClass, TEXT("Inventory"))
+		UUserWidget::CreateWidgetInstance(*GetGameInstance(), UEveAssetMgr::Get().GetInventoryWidgetClass(), TEXT("Inventory"))
 	);
 	
 	// 确保 UI 创建成功
 	if (!ensure(InventoryUI)) return;
 
+	// 绑定玩家背包
+	InventoryUI->Inventory = InventoryMgr;
+	OpenVisibility = InventoryUI->GetVisibility();
+
 	// 将 UI 添加到屏幕上
 	InventoryUI->AddToViewport();
 }
 
+/**
+ * @brief 开始分帧构建
+ * 
+ * 背包 UI 根组件在控件类加载完成后立即加入视口但保持折叠，之后每个格子 UI 加入网格时
+ * 随即构建其 Slate 控件，折叠状态下不参与布局与绘制；首次打开时只剩一次布局。
+ */
+void UEveInventoryUI::BeginStagedConstruction()
+{
+	Stage = EEveInventoryUIStage::LoadingClasses;
+	ConstructionStartTime = FPlatformTime::Seconds();
+	ConstructionFrames = 0;
+
+	UEveAssetMgr::Get().LoadWidgetClassesAsync(FStreamableDelegate::CreateUObject(this, &ThisClass::OnWidgetClassesLoaded));
+}
+
+/**
+ * @brief 控件类加载完成，创建根组件并开始分帧创建格子 UI
+ */
+void UEveInventoryUI::OnWidgetClassesLoaded()
+{
+	// 首次打开时可能已经同步完成了构建
+	if (Stage != EEveInventoryUIStage::LoadingClasses) return;
+
+	CreateRootWidget();
+	if (!InventoryUI)
+	{
+		// 构建失败时不再保留打开请求，否则构建完成后打开的请求永远不会被执行或清除
+		UE_LOG(LogEveInventory, Warning, TEXT("Failed to load the inventory widget class, staged construction aborted"));
+		Stage = EEveInventoryUIStage::None;
+		bOpenRequested = false;
+		return;
+	}
+	InventoryUI->SetVisibility(ESlateVisibility::Collapsed);
+
+	ItemUIPool.SetNum(InventoryMgr->SlotNum);
+	NextSlotIdx = 0;
+	Stage = EEveInventoryUIStage::CreatingSlots;
+
+	ConstructionTickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::TickConstruction));
+}
+
+/**
+ * @brief 在预算内创建一批格子 UI
+ */
+bool UEveInventoryUI::TickConstruction(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EveInventoryUIConstruction);
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	const uint64 BudgetCycles = static_cast<uint64>(ConstructionBudgetMs / 1000.0 / FPlatformTime::GetSecondsPerCycle64());
+	const TSubclassOf<UUserWidget> ItemClass = UEveAssetMgr::Get().GetItemWidgetClass();
+
+	// 每帧至少推进一个格子，保证构建总能完成
+	int32 Steps = 0;
+	while (NextSlotIdx < ItemUIPool.Num())
+	{
+		if (Steps > 0 && FPlatformTime::Cycles64() - StartCycles >= BudgetCycles) break;
+
+		CreateSlotWidget(NextSlotIdx++, ItemClass);
+		Steps++;
+	}
+
+	ConstructionFrames++;
+	if (NextSlotIdx < ItemUIPool.Num()) return true;
+
+	ConstructionTickHandle.Reset();
+	FinishConstruction();
+
+	if (bOpenOnStart || bOpenRequested)
+	{
+		OpenInventory();
+	}
+	return false;
+}
+
+/**
+ * @brief 在本帧同步完成剩余的构建
+ */
+int32 UEveInventoryUI::CompleteConstruction()
+{
+	SCOPE_CYCLE_COUNTER(STAT_EveInventoryUIConstruction);
+
+	if (Stage == EEveInventoryUIStage::LoadingClasses)
+	{
+		// 控件类未加载完成时同步加载（`OnWidgetClassesLoaded` 之后到达时会被忽略）
+		OnWidgetClassesLoaded();
+	}
+	if (Stage != EEveInventoryUIStage::CreatingSlots) return 0;
+
+	FTSTicker::GetCoreTicker().RemoveTicker(ConstructionTickHandle);
+	ConstructionTickHandle.Reset();
+
+	const int32 FirstSlotIdx = NextSlotIdx;
+	const TSubclassOf<UUserWidget> ItemClass = UEveAssetMgr::Get().GetItemWidgetClass();
+	while (NextSlotIdx < ItemUIPool.Num())
+	{
+		CreateSlotWidget(NextSlotIdx++, ItemClass);
+	}
+
+	FinishConstruction();
+	return NextSlotIdx - FirstSlotIdx;
+}
+
+/**
+ * @brief 格子 UI 全部创建完成：完整同步一次并绑定事件
+ */
+void UEveInventoryUI::FinishConstruction()
+{
+	UpdateInventory();
+
+	// 预创建拖拽操作，避免首次拖拽时分配
+	GetDragDropPool();
+
+	BindUIEvent();
+	Stage = EEveInventoryUIStage::Ready;
+
+	UE_LOG(LogEveInventory, Log, TEXT("Built inventory UI (%d slot(s)) over %d frame(s) in %.2f ms"),
+		ItemUIPool.Num(), ConstructionFrames, (FPlatformTime::Seconds() - ConstructionStartTime) * 1000.0);
+}
+
+/**
+ * @brief 打开背包
+ * 
+ * 首次打开的耗时包含本帧同步完成的构建，以及到下一帧为止的布局与绘制。
+ */
+void UEveInventoryUI::OpenInventory()
+{
+	if (bInventoryOpen) return;
+
+	const double StartTime = FPlatformTime::Seconds();
+	const bool bFirstOpen = FirstOpenLatencyMs < 0.0;
+
+	// 初始化的下一帧才开始构建，此前的打开请求在构建完成后执行
+	if (Stage == EEveInventoryUIStage::None)
+	{
+		bOpenRequested = true;
+		return;
+	}
+
+	const int32 BuiltOnOpen = CompleteConstruction();
+	if (!InventoryUI) return;
+
+	// 预热时尚未分帧同步完的格子在显示前同步完成
+	FlushInventorySync();
+
+	InventoryUI->SetVisibility(OpenVisibility);
+	bInventoryOpen = true;
+	bOpenRequested = false;
+
+	if (!bFirstOpen) return;
+
+	const double SyncMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	FirstOpenLatencyMs = SyncMs;
+
+	// 打开后的第一次布局与绘制发生在本帧的 Slate Tick 中，到下一帧再统计总耗时
+	TWeakObjectPtr<UEveInventoryUI> WeakThis(this);
+	FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis, StartTime, SyncMs, BuiltOnOpen](float)
+	{
+		if (UEveInventoryUI* This = WeakThis.Get())
+		{
+			This->FirstOpenLatencyMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+			UE_LOG(LogEveInventory, Log, TEXT("First inventory open: %.2f ms until next frame (%.2f ms synchronous, %d item widget(s) built on open)"),
+				This->FirstOpenLatencyMs, SyncMs, BuiltOnOpen);
+		}
+		return false;
+	}));
+}
+
+/**
+ * @brief 关闭背包
+ */
+void UEveInventoryUI::CloseInventory()
+{
+	bOpenRequested = false;
+	if (!bInventoryOpen || !InventoryUI) return;
+
+	InventoryUI->SetVisibility(ESlateVisibility::Collapsed);
+	bInventoryOpen = false;
+}
+
+void UEveInventoryUI::ToggleInventory()
+{
+	if (bInventoryOpen)
+	{
+		CloseInventory();
+	}
+	else
+	{
+		OpenInventory();
+	}
+}
+
 /**
  * @brief 绑定背包 UI 相关的事件
  * 
- * 该方法会监听 `UEveInventoryMgr` 的 `OnInventoryUpdated` 事件，以便在背包数据更新时刷新 UI。
+ * 该方法会监听 `UEveInventoryMgr` 的 `OnInventorySlotsChanged` 事件，以便在背包数据更新时只刷新变化的格子。
  */
 void UEveInventoryUI::BindUIEvent()
 {
-	// 获取背包管理子系统
-	UEveInventoryMgr* InventorySubsystem = GetGameInstance()->GetSubsystem<UEveInventoryMgr>();
+	// 绑定 `OnInventorySlotsChanged` 事件，使 `UpdateSlots` 在背包更新时被调用
+	InventoryMgr->OnInventorySlotsChanged.AddUObject(this, &ThisClass::UpdateSlots);
+
+	// 物品配置热重载后只刷新显示这些物品的格子
+	InventoryMgr->OnItemCfgsChanged.AddUObject(this, &ThisClass::HandleItemCfgsChanged);
 
-	// 绑定 `OnInventoryUpdated` 事件，使 `UpdateInventory` 在背包更新时被调用
-	InventorySubsystem->OnInventoryUpdated.AddDynamic(this, &ThisClass::UpdateInventory);
+	// 物品离开背包后释放其 UI 资源包
+	InventoryMgr->OnItemAmountChanged.AddUObject(this, &ThisClass::HandleItemAmountChanged);
+
+	// 切换文化后只刷新正在显示的名称标签
+	TextCache->OnItemTextsChanged.AddUObject(this, &ThisClass::RefreshLabels);
 }
 
 /**
- * @brief 更新背包 UI
+ * @brief 创建所有格子的 `ItemWidget`
  * 
- * 该方法会清空 `UniformGridPanel`，并根据 `InventoryItems` 重新生成 `ItemWidget`。
+ * 每个格子创建一个常驻的 `ItemWidget` 并一次性加入 `UniformGrid`，
+ * 之后的更新只修改对应格子的内容，不再增删网格子控件，避免整个网格重新布局。
  */
-void UEveInventoryUI::UpdateInventory()
+void UEveInventoryUI::CreateSlotWidgets()
 {
 	// 确保 UI 和网格组件有效
 	if (!ensure(InventoryUI)) return;
 	if (!ensure(InventoryUI->Grid)) return;
 
-	// 清理 UI 网格中的 `ItemWidget`
-	for (const auto& ItemWidget : ItemUIPool)
+	ItemUIPool.SetNum(InventoryMgr->SlotNum);
+	const TSubclassOf<UUserWidget> ItemClass = UEveAssetMgr::Get().GetItemWidgetClass();
+	for (int32 SlotIdx = 0; SlotIdx < InventoryMgr->SlotNum; SlotIdx++)
 	{
-		InventoryUI->Grid->RemoveChild(ItemWidget.Get());
+		CreateSlotWidget(SlotIdx, ItemClass);
 	}
+}
+
+/**
+ * @brief 创建单个格子的 `ItemWidget` 并加入网格
+ */
+void UEveInventoryUI::CreateSlotWidget(const int32 SlotIdx, const TSubclassOf<UUserWidget> ItemClass)
+{
+	if (!ensure(InventoryUI && InventoryUI->Grid)) return;
+
+	// 创建 `ItemWidget`（单个格子 UI）
+	UEveItemWidget* ItemWidget = Cast<UEveItemWidget>(
+		UUserWidget::CreateWidgetInstance(*GetGameInstance(), ItemClass, 
+		FName(*FString::Printf(TEXT("Item_%d"), SlotIdx)))
+	);
 
-	// 清空 `ItemUIPool`
-	ItemUIPool.Empty();
+	// 确保 `ItemWidget` 创建成功
+	if (!ensure(ItemWidget)) return;
 
-	// 获取背包管理子系统
-	UEveInventoryMgr* InventorySubsystem = GetGameInstance()->GetSubsystem<UEveInventoryMgr>();
+	// 赋值 `ItemWidget` 的 UI 组件数据，初始为空格子
+	ItemWidget->OwnerWidget = InventoryUI;
+	ItemWidget->OwnerGrid = InventoryUI->Grid;
+	ItemWidget->PosIdx = SlotIdx;
+	ItemWidget->DragDropPool = GetDragDropPool();
+	ItemWidget->InventoryUI = this;
+	ItemWidget->ClearSlot();
 
-	// 遍历 `InventoryItems`，创建对应的 UI 组件
-	for (const auto& [ItemTID, InventoryItem] : InventorySubsystem->InventoryItems)
+	// 标签宽度按格子名称标签的实际字体测量（所有格子使用同一个控件类）
+	FSlateFontInfo LabelFont;
+	if (SlotIdx == 0 && ItemWidget->GetLabelFont(LabelFont))
 	{
-		// 确保物品数据有效
-		if (!ensure(InventoryItem)) continue;
-		if (!ensure(InventorySubsystem->AllItemsCfg.Contains(InventoryItem->TID))) continue;
-		if (!ensure(InventorySubsystem->AllItemsCfg[InventoryItem->TID]->ItemData.Icon)) continue;
+		TextCache->SetLabelFont(LabelFont);
+	}
 
-		// 创建 `ItemWidget`（单个物品 UI）
-		UEveItemWidget* ItemWidget = Cast<UEveItemWidget>(
-			UUserWidget::CreateWidgetInstance(*GetGameInstance(), UEveAssetMgr::Get().ItemClass, 
-			FName(*FString::Printf(TEXT("Item_%d"), ItemTID)))
-		);
+	// 按格子索引存入 `ItemUIPool`
+	ItemUIPool[SlotIdx] = ItemWidget;
 
-		// 确保 `ItemWidget` 创建成功
-		if (!ensure(ItemWidget)) continue;
+	// 计算格子在网格中的位置
+	const int32 Row = SlotIdx / InventoryUI->KNumColumns;
+	const int32 Col = SlotIdx % InventoryUI->KNumColumns;
 
-		// 赋值 `ItemWidget` 的 UI 组件数据
-		ItemWidget->OwnerWidget = InventoryUI;
-		ItemWidget->OwnerGrid = InventoryUI->Grid;
-		ItemWidget->PosIdx = InventoryItem->PosIdx;
-		ItemWidget->ItemTID = InventoryItem->TID;
-		ItemWidget->Img->SetBrushFromTexture(InventorySubsystem->AllItemsCfg[InventoryItem->TID]->ItemData.Icon);
+	// 将 `ItemWidget` 添加到 `UniformGrid`（根组件已在视口中时随即构建其 Slate 控件）
+	InventoryUI->Grid->AddChildToUniformGrid(ItemWidget, Row, Col);
+}
 
-		// 存入 `ItemUIPool`
-		ItemUIPool.Add(ItemWidget);
+/**
+ * @brief 更新背包 UI（全部格子）
+ * 
+ * 用于首次显示等需要完整同步的场景，日常更新走 `UpdateSlots` 增量路径。
+ * 背包 UI 折叠时中间状态不可见，按调度器的每帧预算分批同步；已同步的格子之后由增量路径保持最新。
+ */
+void UEveInventoryUI::UpdateInventory()
+{
+	if (Scheduler && SyncJobId != INDEX_NONE)
+	{
+		Scheduler->CancelJob(SyncJobId);
+		SyncJobId = INDEX_NONE;
+	}
 
-		// 计算物品在网格中的位置
-		const int32 Row = InventoryItem->PosIdx / 3; // 3 列布局
-		const int32 Col = InventoryItem->PosIdx % 3;
+	if (!Scheduler || !InventoryUI || InventoryUI->GetVisibility() != ESlateVisibility::Collapsed)
+	{
+		SyncSlotRange(0, ItemUIPool.Num());
+		return;
+	}
+
+	SyncedSlotNum = 0;
+	TWeakObjectPtr<UEveInventoryUI> WeakThis(this);
+	SyncJobId = Scheduler->EnqueueJob(FMath::DivideAndRoundUp(ItemUIPool.Num(), SyncSlotsPerUnit), [WeakThis](const int32 Idx)
+	{
+		if (UEveInventoryUI* This = WeakThis.Get())
+		{
+			const int32 FirstSlotIdx = Idx * This->SyncSlotsPerUnit;
+			This->SyncSlotRange(FirstSlotIdx, FMath::Min(This->SyncSlotsPerUnit, This->ItemUIPool.Num() - FirstSlotIdx));
+		}
+	}, 0, [WeakThis](const FEveInventoryJob& Job)
+	{
+		UEveInventoryUI* This = WeakThis.Get();
+		if (This && This->SyncJobId == Job.JobId)
+		{
+			This->SyncJobId = INDEX_NONE;
+		}
+	});
+}
+
+/**
+ * @brief 同步一段连续的格子 UI
+ */
+void UEveInventoryUI::SyncSlotRange(const int32 FirstSlotIdx, const int32 Num)
+{
+	if (Num <= 0) return;
 
-		// 将 `ItemWidget` 添加到 `UniformGrid`
-		InventoryUI->Grid->AddChildToUniformGrid(ItemWidget, Row, Col);
+	TArray<int32> PosIdxes;
+	PosIdxes.Reserve(Num);
+	for (int32 SlotIdx = FirstSlotIdx; SlotIdx < FirstSlotIdx + Num; SlotIdx++)
+	{
+		PosIdxes.Add(SlotIdx);
 	}
+
+	UpdateSlots(PosIdxes);
+	SyncedSlotNum = FirstSlotIdx + Num;
+}
+
+/**
+ * @brief 取消分帧同步，并在本帧同步完成剩余的格子
+ */
+void UEveInventoryUI::FlushInventorySync()
+{
+	if (SyncJobId == INDEX_NONE) return;
+
+	Scheduler->CancelJob(SyncJobId);
+	SyncJobId = INDEX_NONE;
+	SyncSlotRange(SyncedSlotNum, ItemUIPool.Num() - SyncedSlotNum);
+}
+
+/**
+ * @brief 只更新发生变化的格子
+ * 
+ * 由 `UEveInventoryMgr::OnInventorySlotsChanged` 触发，未变化的格子 UI 不会被触碰，
+ * 因此也不会失效重绘。
+ */
+void UEveInventoryUI::UpdateSlots(const TArray<int32>& ChangedPosIdxes)
+{
+	// 确保 UI 组件有效
+	if (!ensure(InventoryUI)) return;
+
+	for (const int32 PosIdx : ChangedPosIdxes)
+	{
+		if (!ItemUIPool.IsValidIndex(PosIdx)) continue;
+
+		UEveItemWidget* ItemWidget = ItemUIPool[PosIdx];
+		if (!ItemWidget) continue;
+
+		// 格子已空（按格子索引直接取，无哈希查找）
+		const UEveInventoryItem* SlotItem = InventoryMgr->GetSlotItem(PosIdx);
+		if (!SlotItem)
+		{
+			ItemWidget->ClearSlot();
+			ItemWidget->SetSelected(false);
+			continue;
+		}
+
+		// 确保物品数据有效（缓存的配置索引，直接数组访问）
+		const UEveItemCfg* ItemCfg = InventoryMgr->GetCfgByIdx(SlotItem->CfgIdx);
+		if (!ensure(ItemCfg)) continue;
+
+		// 更新格子内容（物品未变化时不会失效）
+		ItemWidget->SetSlotItem(SlotItem->TID, SlotItem->CfgIdx, ItemCfg->ItemData.IconBrush);
+		ItemWidget->SetSlotLabel(TextCache->GetName(SlotItem->CfgIdx), TextCache->GetLabelWidth(SlotItem->CfgIdx));
+		ItemWidget->SetSelected(InventoryUI->IsSelected(PosIdx));
+	}
+
+	InventoryUI->NotifySlotsChanged();
+	RefreshItemToolTip();
+
+	ReleaseItemUIBundles();
+	RequestItemUIBundles(ChangedPosIdxes);
+}
+
+/**
+ * @brief 强制刷新显示指定物品的格子
+ */
+void UEveInventoryUI::RefreshItems(const TArray<int32>& TIDs)
+{
+	if (!ensure(InventoryUI)) return;
+
+	for (int32 PosIdx = 0; PosIdx < ItemUIPool.Num(); PosIdx++)
+	{
+		const UEveInventoryItem* SlotItem = InventoryMgr->GetSlotItem(PosIdx);
+		if (!SlotItem || !TIDs.Contains(SlotItem->TID)) continue;
+
+		const UEveItemCfg* ItemCfg = InventoryMgr->GetCfgByIdx(SlotItem->CfgIdx);
+		if (!ensure(ItemCfg) || !ItemUIPool[PosIdx]) continue;
+
+		ItemUIPool[PosIdx]->SetSlotItem(SlotItem->TID, SlotItem->CfgIdx, ItemCfg->ItemData.IconBrush, true);
+		ItemUIPool[PosIdx]->SetSlotLabel(TextCache->GetName(SlotItem->CfgIdx), TextCache->GetLabelWidth(SlotItem->CfgIdx));
+	}
+
+	InventoryUI->NotifySlotsChanged();
+}
+
+/**
+ * @brief 刷新所有有物品的格子的名称标签
+ * 
+ * 文本缓存只为这些物品重建条目，其他物品在下次显示时才重建。
+ */
+void UEveInventoryUI::RefreshLabels()
+{
+	if (!ensure(InventoryUI)) return;
+
+	for (int32 PosIdx = 0; PosIdx < ItemUIPool.Num(); PosIdx++)
+	{
+		const UEveInventoryItem* SlotItem = InventoryMgr->GetSlotItem(PosIdx);
+		if (!SlotItem || !ItemUIPool[PosIdx]) continue;
+
+		ItemUIPool[PosIdx]->SetSlotLabel(TextCache->GetName(SlotItem->CfgIdx), TextCache->GetLabelWidth(SlotItem->CfgIdx));
+	}
+
+	InventoryUI->NotifySlotsChanged();
+}
+
+/**
+ * @brief 物品配置热重载
+ * 
+ * 重绘变化物品的图集格子（新增物品追加到图集），然后只刷新显示这些物品的格子。
+ * 背包中的物品若图标需要重新加载（有物品定义，或新图标尚未加载），重新请求图标。
+ */
+void UEveInventoryUI::HandleItemCfgsChanged(const TArray<int32>& ChangedTIDs)
+{
+	const UEveAssetMgr& AssetMgr = UEveAssetMgr::Get();
+	TArray<int32> ReloadTIDs;
+	for (const int32 TID : ChangedTIDs)
+	{
+		UEveItemCfg* ItemCfg = InventoryMgr->GetCfgByIdx(InventoryMgr->FindCfgIdx(TID));
+		if (!ItemCfg) continue;
+
+		RequestedUIBundleTIDs.Remove(TID);
+		const TSoftObjectPtr<UTexture2D>& Icon = ItemCfg->GetDisplayIcon();
+		const bool bNeedsLoad = AssetMgr.FindItemDefinitionId(TID).IsValid() || (!Icon.IsNull() && !Icon.Get());
+		if (bNeedsLoad && InventoryMgr->InventoryItems.Contains(TID))
+		{
+			ReloadTIDs.Add(TID);
+		}
+		else if (IconAtlas)
+		{
+			IconAtlas->AddOrUpdateIcon(ItemCfg);
+		}
+	}
+
+	RefreshItems(ChangedTIDs);
+	RefreshItemToolTip();
+	RequestItemIcons(ReloadTIDs);
+}
+
+/**
+ * @brief 为格子中尚未请求过的物品异步加载图标
+ * 
+ * 只加载背包中实际持有的物品的图标，未持有的物品定义与图标不会被加载。
+ */
+void UEveInventoryUI::RequestItemUIBundles(const TArray<int32>& PosIdxes)
+{
+	TArray<int32> TIDs;
+	for (const int32 PosIdx : PosIdxes)
+	{
+		const UEveInventoryItem* SlotItem = InventoryMgr->GetSlotItem(PosIdx);
+		if (SlotItem && !RequestedUIBundleTIDs.Contains(SlotItem->TID))
+		{
+			TIDs.AddUnique(SlotItem->TID);
+		}
+	}
+
+	RequestItemIcons(TIDs);
+}
+
+/**
+ * @brief 为尚未请求过的物品异步加载图标
+ */
+void UEveInventoryUI::RequestItemIcons(const TArray<int32>& TIDs)
+{
+	UEveAssetMgr& AssetMgr = UEveAssetMgr::Get();
+
+	TArray<int32> BundleTIDs;
+	TArray<int32> IconTIDs;
+	TArray<FSoftObjectPath> IconPaths;
+	for (const int32 TID : TIDs)
+	{
+		bool bAlreadyRequested = false;
+		RequestedUIBundleTIDs.Add(TID, &bAlreadyRequested);
+		if (bAlreadyRequested) continue;
+
+		if (AssetMgr.FindItemDefinitionId(TID).IsValid())
+		{
+			BundleTIDs.Add(TID);
+			continue;
+		}
+
+		// 没有物品定义：图标已绘制到图集或没有图标时无需加载
+		UEveItemCfg* ItemCfg = InventoryMgr->GetCfgByIdx(InventoryMgr->FindCfgIdx(TID));
+		if (!ItemCfg || ItemCfg->GetDisplayIcon().IsNull() || (IconAtlas && IconAtlas->HasIcon(TID))) continue;
+
+		IconTIDs.Add(TID);
+		IconPaths.Add(ItemCfg->GetDisplayIcon().ToSoftObjectPath());
+	}
+
+	if (BundleTIDs.Num() > 0)
+	{
+		AssetMgr.LoadItemBundles(BundleTIDs, UEveAssetMgr::UIBundle, FStreamableDelegate::CreateUObject(this, &ThisClass::OnItemUIBundlesLoaded, BundleTIDs));
+	}
+	if (IconTIDs.Num() > 0)
+	{
+		const FStreamableDelegate OnIconsLoaded = FStreamableDelegate::CreateUObject(this, &ThisClass::OnItemIconsLoaded, IconTIDs);
+		const TSharedPtr<FStreamableHandle> Handle = AssetMgr.GetStreamableManager().RequestAsyncLoad(IconPaths, OnIconsLoaded);
+		if (!Handle.IsValid() || Handle->HasLoadCompleted())
+		{
+			OnIconsLoaded.ExecuteIfBound();
+		}
+	}
+}
+
+/**
+ * @brief 物品配置中的图标加载完成
+ * 
+ * 图标绘制到图集后即可释放，软引用不会让纹理常驻。
+ */
+void UEveInventoryUI::OnItemIconsLoaded(TArray<int32> TIDs)
+{
+	if (IconAtlas)
+	{
+		for (const int32 TID : TIDs)
+		{
+			if (UEveItemCfg* ItemCfg = InventoryMgr->GetCfgByIdx(InventoryMgr->FindCfgIdx(TID)))
+			{
+				IconAtlas->AddOrUpdateIcon(ItemCfg);
+			}
+		}
+	}
+
+	RefreshItems(TIDs);
+}
+
+/**
+ * @brief 物品数量变化
+ */
+void UEveInventoryUI::HandleItemAmountChanged(const int32 TID, const int32 OldAmount, const int32 NewAmount)
+{
+	if (NewAmount == 0)
+	{
+		// 物品离开背包：下次格子更新时释放，之后重新获得时再加载
+		if (RequestedUIBundleTIDs.Remove(TID) > 0)
+		{
+			ReleasedUIBundleTIDs.AddUnique(TID);
+		}
+	}
+	else if (OldAmount == 0)
+	{
+		// 同一批次中离开后又重新获得，取消释放（仍会重新请求，资源包已加载时不产生加载）
+		ReleasedUIBundleTIDs.RemoveSingleSwap(TID, EveNoShrink);
+	}
+}
+
+/**
+ * @brief 释放已离开背包的物品的 UI 资源包
+ */
+void UEveInventoryUI::ReleaseItemUIBundles()
+{
+	if (ReleasedUIBundleTIDs.Num() == 0) return;
+
+	UEveAssetMgr::Get().ReleaseItemBundles(ReleasedUIBundleTIDs, UEveAssetMgr::UIBundle);
+	ReleasedUIBundleTIDs.Reset();
+}
+
+/**
+ * @brief 物品定义的 UI 资源包加载完成
+ */
+void UEveInventoryUI::OnItemUIBundlesLoaded(TArray<int32> TIDs)
+{
+	const UEveAssetMgr& AssetMgr = UEveAssetMgr::Get();
+	TArray<int32> RenamedTIDs;
+	for (const int32 TID : TIDs)
+	{
+		const UEveItemDefinition* ItemDefinition = AssetMgr.GetItemDefinition(TID);
+		UEveItemCfg* ItemCfg = InventoryMgr->GetCfgByIdx(InventoryMgr->FindCfgIdx(TID));
+		if (!ItemDefinition || !ItemCfg) continue;
+
+		// 写入配置的定义字段而不是 `ItemData`，数据表热重载仍与原始配置比较
+		if (!ItemDefinition->Name.IsEmpty() && ItemCfg->DefinitionName != ItemDefinition->Name)
+		{
+			ItemCfg->DefinitionName = ItemDefinition->Name;
+			RenamedTIDs.Add(TID);
+		}
+
+		if (UTexture2D* Icon = ItemDefinition->Icon.Get())
+		{
+			ItemCfg->DefinitionIcon = Icon;
+			if (IconAtlas)
+			{
+				IconAtlas->AddOrUpdateIcon(ItemCfg);
+			}
+		}
+	}
+
+	if (RenamedTIDs.Num() > 0)
+	{
+		TextCache->Invalidate(RenamedTIDs);
+	}
+	RefreshItems(TIDs);
+}
+
+/**
+ * @brief 输出格子 UI 的内存占用
+ */
+void UEveInventoryUI::ReportMemory(FOutputDevice& Ar) const
+{
+	auto ObjectSize = [](const UObject* Object) -> SIZE_T
+	{
+		return Object ? Object->GetClass()->GetStructureSize() + sizeof(FUObjectItem) : 0;
+	};
+
+	SIZE_T ItemWidgetSize = 0;
+	SIZE_T WidgetTreeSize = 0;
+	SIZE_T ChildWidgetSize = 0;
+	int32 ChildWidgetNum = 0;
+	int32 WidgetNum = 0;
+	for (const UEveItemWidget* ItemWidget : ItemUIPool)
+	{
+		if (!ItemWidget) continue;
+
+		WidgetNum++;
+		ItemWidgetSize += ObjectSize(ItemWidget);
+		if (const UWidgetTree* Tree = ItemWidget->WidgetTree)
+		{
+			WidgetTreeSize += ObjectSize(Tree);
+			Tree->ForEachWidget([&](const UWidget* Widget)
+			{
+				ChildWidgetSize += ObjectSize(Widget);
+				ChildWidgetNum++;
+			});
+		}
+	}
+
+	auto Line = [&Ar, WidgetNum](const TCHAR* Name, const SIZE_T Bytes)
+	{
+		Ar.Logf(TEXT("  %-32s %10llu B  %8.1f B each"), Name, static_cast<uint64>(Bytes), WidgetNum > 0 ? static_cast<double>(Bytes) / WidgetNum : 0.0);
+	};
+
+	Ar.Logf(TEXT("Item widgets: %d widget(s), %d child widget(s)"), WidgetNum, ChildWidgetNum);
+	Line(TEXT("UEveItemWidget objects"), ItemWidgetSize);
+	Line(TEXT("UWidgetTree"), WidgetTreeSize);
+	Line(TEXT("Child UWidget objects"), ChildWidgetSize);
+	Line(TEXT("ItemUIPool (TArray)"), ItemUIPool.GetAllocatedSize());
+}
+
+/**
+ * @brief 获取拖拽操作对象池
+ * 
+ * 对象池在首次访问时创建并预热。
+ */
+UEveDragDropPool* UEveInventoryUI::GetDragDropPool()
+{
+	if (!DragDropPool)
+	{
+		DragDropPool = NewObject<UEveDragDropPool>(this);
+		DragDropPool->Prewarm(DragDropPoolSize);
+	}
+
+	return DragDropPool;
+}
+
+/**
+ * @brief 将共享提示框填充为指定物品的信息
+ * 
+ * 提示框在首次悬停时才创建，未悬停过物品时没有任何开销。
+ */
+TSharedPtr<IToolTip> UEveInventoryUI::ShowItemToolTip(const int32 TID, const int32 CfgIdx)
+{
+	if (!TooltipWidget)
+	{
+		TSubclassOf<UUserWidget> TooltipClass = UEveAssetMgr::Get().TooltipClass;
+		if (!TooltipClass || !TooltipClass->IsChildOf<UEveItemTooltipWidget>())
+		{
+			TooltipClass = UEveItemTooltipWidget::StaticClass();
+		}
+
+		TooltipWidget = Cast<UEveItemTooltipWidget>(
+			UUserWidget::CreateWidgetInstance(*GetGameInstance(), TooltipClass, TEXT("ItemTooltip"))
+		);
+		if (!ensure(TooltipWidget)) return nullptr;
+
+		SharedToolTip = SNew(SToolTip)
+			.TextMargin(FMargin(0.f))
+			.BorderImage(nullptr)
+			[
+				TooltipWidget->TakeWidget()
+			];
+	}
+
+	TooltipWidget->SetItem(TID, TextCache->GetName(CfgIdx), InventoryMgr->GetItemAggregate(TID), InventoryMgr->GetTotalAggregate());
+	return SharedToolTip;
+}
+
+/**
+ * @brief 刷新提示框内容
+ * 
+ * 提示框未创建或内容未变化时直接返回（`SetItem` 内部比较统计汇总）。
+ */
+void UEveInventoryUI::RefreshItemToolTip()
+{
+	if (!TooltipWidget || TooltipWidget->GetItemTID() < 0) return;
+
+	const int32 TID = TooltipWidget->GetItemTID();
+	TooltipWidget->SetItem(TID, TextCache->GetNameByTID(TID), InventoryMgr->GetItemAggregate(TID), InventoryMgr->GetTotalAggregate());
 }
 
 /**
@@ -127,9 +883,28 @@ void UEveInventoryUI::Deinitialize()
 {
 	Super::Deinitialize();
 
-	// 获取背包管理子系统
-	UEveInventoryMgr* InventorySubsystem = GetGameInstance()->GetSubsystem<UEveInventoryMgr>();
+	FTSTicker::GetCoreTicker().RemoveTicker(ConstructionTickHandle);
+	ConstructionTickHandle.Reset();
+
+	if (Scheduler && SyncJobId != INDEX_NONE)
+	{
+		Scheduler->CancelJob(SyncJobId);
+		SyncJobId = INDEX_NONE;
+	}
+
+	// 取消事件绑定
+	if (InventoryMgr)
+	{
+		InventoryMgr->OnInventoryUpdated.RemoveAll(this);
+		InventoryMgr->OnInventorySlotsChanged.RemoveAll(this);
+		InventoryMgr->OnItemCfgsChanged.RemoveAll(this);
+		InventoryMgr->OnItemAmountChanged.RemoveAll(this);
+	}
+	if (TextCache)
+	{
+		TextCache->OnItemTextsChanged.RemoveAll(this);
+	}
 
-	// 取消 `OnInventoryUpdated` 事件绑定
-	InventorySubsystem->OnInventoryUpdated.RemoveAll(this);
+	SharedToolTip.Reset();
+	TooltipWidget = nullptr;
 }
@@ -3,9 +3,28 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Components/SlateWrapperTypes.h"
+#include "Containers/Ticker.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "EveInventoryUI.generated.h"
 
+class IToolTip;
+
+/**
+ * @brief 背包 UI 分帧构建的阶段
+ */
+enum class EEveInventoryUIStage : uint8
+{
+	/** 尚未开始构建 */
+	None,
+	/** 正在异步加载控件类 */
+	LoadingClasses,
+	/** 正在分帧创建格子 UI */
+	CreatingSlots,
+	/** 构建完成，可以打开 */
+	Ready,
+};
+
 /**
  * @brief 背包 UI 子系统（UEveInventoryUI）
  * 
@@ -16,8 +35,9 @@
  * - 释放资源
  * 
  * @note 该子系统在 `GameInstance` 生命周期内保持有效，无需手动创建。
+ * @note 分帧构建与打开时机可在 `DefaultGame.ini` 的 `[/Script/EveInventory.EveInventoryUI]` 中配置。
  */
-UCLASS()
+UCLASS(Config = Game)
 class UEveInventoryUI : public UGameInstanceSubsystem
 {
 	GENERATED_BODY()
@@ -46,36 +66,314 @@ public:
 	/**
 	 * @brief 创建背包 UI
 	 * 
+	 * - 根据 `DTItem` 构建物品图标图集
 	 * - 通过 `UEveAssetMgr` 生成 `InventoryWidget`
 	 * - 将 `InventoryWidget` 添加到视口
+	 * - 一次性创建所有格子 UI（未启用分帧构建时使用）
 	 */
 	virtual void CreateUI();
 
 	/**
 	 * @brief 绑定背包 UI 事件
 	 * 
-	 * - 监听 `UEveInventoryMgr::OnInventoryUpdated`
-	 * - 在背包数据变更时，调用 `UpdateInventory`
+	 * - 监听 `UEveInventoryMgr::OnInventorySlotsChanged`
+	 * - 在背包数据变更时，调用 `UpdateSlots` 只刷新变化的格子
+	 * - 监听 `UEveInventoryMgr::OnItemCfgsChanged`，物品配置热重载后刷新受影响的格子
 	 */
 	virtual void BindUIEvent();
 
 public:
 	/**
-	 * @brief 更新背包 UI
+	 * @brief 更新背包 UI（全部格子）
 	 * 
-	 * - 清空 `UniformGridPanel`
-	 * - 遍历 `InventoryItems`，创建 `ItemWidget`
-	 * - 计算 `Row/Col` 位置，添加到 `Grid`
+	 * - 遍历所有格子，按 `PosToTIDMap` 同步 `ItemWidget` 内容
+	 * - 背包 UI 折叠时（预热构建）交给 `UEveInventoryScheduler` 分帧同步，打开时同步完成剩余的格子
 	 */
 	UFUNCTION()
 	void UpdateInventory();
 
+	/**
+	 * @brief 只更新发生变化的格子
+	 * 
+	 * - 只触碰 `ChangedPosIdxes` 对应的 `ItemWidget`
+	 * - 其余格子保持缓存，不会失效重绘
+	 * 
+	 * @param ChangedPosIdxes 发生变化的格子索引
+	 */
+	void UpdateSlots(const TArray<int32>& ChangedPosIdxes);
+
+	/**
+	 * @brief 强制刷新显示指定物品的格子
+	 * 
+	 * 物品图标或配置在运行时更新后调用（例如物品定义的 UI 资源包加载完成）。
+	 * 
+	 * @param TIDs 需要刷新的物品 TID
+	 */
+	void RefreshItems(const TArray<int32>& TIDs);
+
+	/**
+	 * @brief 刷新所有有物品的格子的名称标签（切换文化后调用）
+	 */
+	void RefreshLabels();
+
+	/**
+	 * @brief 创建所有格子的 `ItemWidget`
+	 * 
+	 * - 每个格子一个常驻的 `ItemWidget`
+	 * - 计算 `Row/Col` 位置，一次性添加到 `Grid`
+	 */
+	void CreateSlotWidgets();
+
+	/**
+	 * @brief 打开背包
+	 * 
+	 * 分帧构建尚未完成时，剩余的构建在本帧同步完成（即首次打开的卡顿），
+	 * 首次打开时输出从调用到下一帧的耗时。
+	 */
+	void OpenInventory();
+
+	/**
+	 * @brief 关闭背包
+	 * 
+	 * 只折叠背包 UI，控件与 Slate 控件树保留，再次打开时不需要重建。
+	 */
+	void CloseInventory();
+
+	/** @brief 切换背包的打开状态 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	void ToggleInventory();
+
+	/** @brief 背包是否已打开 */
+	bool IsInventoryOpen() const { return bInventoryOpen; }
+
+	/** @brief 首次打开背包的耗时（毫秒），尚未打开时为负数 */
+	double GetFirstOpenLatencyMs() const { return FirstOpenLatencyMs; }
+
+	/**
+	 * @brief 获取拖拽操作对象池
+	 * 
+	 * 对象池在首次访问时创建，物品 UI 开始拖拽时从中取出复用的拖拽操作。
+	 * 
+	 * @return 拖拽操作对象池
+	 */
+	class UEveDragDropPool* GetDragDropPool();
+
+	/**
+	 * @brief 将共享提示框填充为指定物品的信息
+	 * 
+	 * 提示框在首次调用时创建，之后所有格子复用同一个实例；
+	 * 内容取自文本缓存与 `UEveInventoryMgr` 增量维护的统计汇总，不遍历背包。
+	 * 
+	 * @param TID 物品 TID
+	 * @param CfgIdx 物品配置索引
+	 * @return 共享的 Slate 提示框
+	 */
+	TSharedPtr<IToolTip> ShowItemToolTip(int32 TID, int32 CfgIdx);
+
+	/**
+	 * @brief 输出格子 UI 的内存占用（按结构拆分）
+	 * 
+	 * 统计 `ItemWidget` 及其控件树中的 UObject，Slate 控件不在反射系统中，不计入。
+	 * 
+	 * @param Ar 输出设备
+	 */
+	void ReportMemory(FOutputDevice& Ar) const;
+
+private:
+	/**
+	 * @brief 构建物品图标图集并创建背包 UI 根组件，添加到视口
+	 */
+	void CreateRootWidget();
+
+	/**
+	 * @brief 创建单个格子的 `ItemWidget` 并加入网格
+	 * 
+	 * @param SlotIdx 格子索引
+	 * @param ItemClass 物品 UI 类
+	 */
+	void CreateSlotWidget(int32 SlotIdx, TSubclassOf<class UUserWidget> ItemClass);
+
+	/**
+	 * @brief 开始分帧构建：异步加载控件类，加载完成后逐帧创建格子 UI
+	 */
+	void BeginStagedConstruction();
+
+	/** @brief 控件类加载完成，创建根组件并开始分帧创建格子 UI */
+	void OnWidgetClassesLoaded();
+
+	/**
+	 * @brief 在 `ConstructionBudgetMs` 预算内创建一批格子 UI
+	 * 
+	 * @return 是否还有未创建的格子
+	 */
+	bool TickConstruction(float DeltaTime);
+
+	/**
+	 * @brief 在本帧同步完成剩余的构建
+	 * 
+	 * @return 同步创建的格子 UI 数量
+	 */
+	int32 CompleteConstruction();
+
+	/** @brief 格子 UI 全部创建完成：完整同步一次并绑定事件 */
+	void FinishConstruction();
+
+	/**
+	 * @brief 同步一段连续的格子 UI
+	 * 
+	 * @param FirstSlotIdx 第一个格子索引
+	 * @param Num 格子数量
+	 */
+	void SyncSlotRange(int32 FirstSlotIdx, int32 Num);
+
+	/**
+	 * @brief 取消分帧同步，并在本帧同步完成剩余的格子
+	 */
+	void FlushInventorySync();
+
+	/**
+	 * @brief 为格子中尚未请求过的物品异步加载图标
+	 * 
+	 * @param PosIdxes 格子索引
+	 */
+	void RequestItemUIBundles(const TArray<int32>& PosIdxes);
+
+	/**
+	 * @brief 为尚未请求过的物品异步加载图标
+	 * 
+	 * 有物品定义的物品加载其 UI 资源包，否则加载物品配置中的软引用图标。
+	 * 
+	 * @param TIDs 物品 TID
+	 */
+	void RequestItemIcons(const TArray<int32>& TIDs);
+
+	/**
+	 * @brief 物品定义的 UI 资源包加载完成：写入物品配置的定义名称与图标、更新图集并刷新格子
+	 * 
+	 * @param TIDs 本次加载的物品 TID
+	 */
+	void OnItemUIBundlesLoaded(TArray<int32> TIDs);
+
+	/**
+	 * @brief 物品配置中的图标加载完成：更新图集并刷新格子
+	 * 
+	 * @param TIDs 本次加载的物品 TID
+	 */
+	void OnItemIconsLoaded(TArray<int32> TIDs);
+
+	/**
+	 * @brief 物品数量变化：物品离开背包时等待释放其 UI 资源包，重新进入时取消释放
+	 */
+	void HandleItemAmountChanged(int32 TID, int32 OldAmount, int32 NewAmount);
+
+	/** @brief 释放已离开背包的物品的 UI 资源包 */
+	void ReleaseItemUIBundles();
+
+	/**
+	 * @brief 提示框正在显示的物品数量或配置变化后，刷新其内容
+	 */
+	void RefreshItemToolTip();
+
+	/**
+	 * @brief 物品配置热重载：更新图集并刷新显示这些物品的格子
+	 * 
+	 * @param ChangedTIDs 内容发生变化或新增的物品 TID
+	 */
+	void HandleItemCfgsChanged(const TArray<int32>& ChangedTIDs);
+
 private:
+	/** 背包管理子系统（初始化时缓存） */
+	UPROPERTY()
+	TObjectPtr<class UEveInventoryMgr> InventoryMgr;
+
+	/** 物品文本缓存（初始化时缓存） */
+	UPROPERTY()
+	TObjectPtr<class UEveItemTextCache> TextCache;
+
+	/** 背包分帧调度器（初始化时缓存） */
+	UPROPERTY()
+	TObjectPtr<class UEveInventoryScheduler> Scheduler;
+
 	/** 背包 UI 根组件 */
 	UPROPERTY()
 	TObjectPtr<class UEveInventoryWidget> InventoryUI;
 
-	/** 物品 UI 组件池（用于管理 `ItemWidget`） */
+	/** 物品 UI 组件池（按格子索引存放常驻的 `ItemWidget`） */
 	UPROPERTY()
 	TArray<TObjectPtr<class UEveItemWidget>> ItemUIPool;
+
+	/** 物品图标图集（所有图标共享少量纹理，减少 Slate 绘制批次） */
+	UPROPERTY()
+	TObjectPtr<class UEveIconAtlas> IconAtlas;
+
+	/** 拖拽操作对象池（复用拖拽图片与拖拽操作） */
+	UPROPERTY()
+	TObjectPtr<class UEveDragDropPool> DragDropPool;
+
+	/** 所有格子共享的提示框（首次悬停时创建） */
+	UPROPERTY()
+	TObjectPtr<class UEveItemTooltipWidget> TooltipWidget;
+
+	/** 包裹 `TooltipWidget` 的 Slate 提示框，挂到每个被悬停的格子上 */
+	TSharedPtr<IToolTip> SharedToolTip;
+
+	/** 预创建的拖拽操作数量 */
+	const int32 DragDropPoolSize = 2;
+
+	/** 分帧同步时每个单元同步的格子数 */
+	const int32 SyncSlotsPerUnit = 64;
+
+	/** 分帧同步全部格子的任务 ID（没有时为 `INDEX_NONE`） */
+	int32 SyncJobId = INDEX_NONE;
+
+	/** 分帧同步已完成的格子数（之后的格子在打开时同步） */
+	int32 SyncedSlotNum = 0;
+
+	/** 已请求过图标（UI 资源包或软引用图标）的物品 TID */
+	TSet<int32> RequestedUIBundleTIDs;
+
+	/** 已离开背包、等待在下次格子更新时释放 UI 资源包的物品 TID */
+	TArray<int32> ReleasedUIBundleTIDs;
+
+	/** 是否分帧构建背包 UI（否则在初始化的下一帧一次性构建） */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Inventory")
+	bool bStagedConstruction = true;
+
+	/**
+	 * 构建完成后是否立即打开背包（默认与原先一样始终显示）。
+	 * 关闭时背包在后台预热，由玩家首次打开（需要为玩家控制器的 `ToggleInventoryAction` 配置按键）。
+	 */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Inventory")
+	bool bOpenOnStart = true;
+
+	/** 分帧构建每帧的时间预算（毫秒），每帧至少创建一个格子 UI */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Inventory")
+	float ConstructionBudgetMs = 2.f;
+
+	/** 当前构建阶段 */
+	EEveInventoryUIStage Stage = EEveInventoryUIStage::None;
+
+	/** 下一个要创建的格子索引 */
+	int32 NextSlotIdx = 0;
+
+	/** 分帧构建用了多少帧 */
+	int32 ConstructionFrames = 0;
+
+	/** 开始构建的时间 */
+	double ConstructionStartTime = 0.0;
+
+	/** 分帧构建的 Ticker 句柄 */
+	FTSTicker::FDelegateHandle ConstructionTickHandle;
+
+	/** 背包是否已打开 */
+	bool bInventoryOpen = false;
+
+	/** 是否已请求打开（构建完成后打开） */
+	bool bOpenRequested = false;
+
+	/** 背包打开时的可见性（取自 UI 蓝图的默认值） */
+	ESlateVisibility OpenVisibility = ESlateVisibility::SelfHitTestInvisible;
+
+	/** 首次打开背包的耗时（毫秒） */
+	double FirstOpenLatencyMs = -1.0;
 };
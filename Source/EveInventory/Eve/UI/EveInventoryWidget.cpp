@@ -1,7 +1,14 @@
 // Copyright Night Gamer, Inc. All Rights Reserved.
 
 #include "EveInventoryWidget.h"
+
+#include "EveDragDropOperation.h"
+#include "EveItemWidget.h"
+#include "Components/InvalidationBox.h"
+#include "Components/RetainerBox.h"
+#include "Components/UniformGridPanel.h"
 #include "EveInventory/Eve/Manager/EveInventoryMgr.h"
+#include "Rendering/DrawElements.h"
 
 /**
  * @brief UI 初始化
@@ -14,13 +21,141 @@ void UEveInventoryWidget::NativeConstruct()
 
 	// 确保 `Grid` 组件存在，否则 UI 无法正常显示
 	if (!ensure(Grid)) return;
+
+	ApplyRenderMode();
+}
+
+/**
+ * @brief 物品拖拽放下
+ * 
+ * - 先恢复被拖拽物品 UI 的可见性（放置成功后会由背包更新事件重建）
+ * - 来源为本容器：调用 `DropSelection` 整体移动
+ * - 来源为其他容器：调用 `TransferItemsTo` 转移到本容器
+ */
+bool UEveInventoryWidget::NativeOnDrop(const FGeometry& InGeometry, const FDragDropEvent& InDragDropEvent, UDragDropOperation* InOperation)
+{
+	const UEveDragDropOperation* DragDropOpr = Cast<UEveDragDropOperation>(InOperation);
+	if (!DragDropOpr) return Super::NativeOnDrop(InGeometry, InDragDropEvent, InOperation);
+
+	const FEveDragPayload& Payload = DragDropOpr->EvePayload;
+	const UEveItemWidget* SourceWidget = Payload.SourceWidget.Get();
+	UEveInventoryWidget* SourceContainer = SourceWidget ? SourceWidget->OwnerWidget.Get() : nullptr;
+	if (!ensure(SourceContainer)) return false;
+
+	// 恢复来源物品 UI 的可见性
+	SourceContainer->SetItemsVisibility(Payload.PosIdxes, ESlateVisibility::Visible);
+
+	const int32 TargetPosIdx = GetPosIdxAtScreenPosition(InDragDropEvent.GetScreenSpacePosition());
+	if (TargetPosIdx == INDEX_NONE) return true;
+
+	// 1. 本容器内的整体移动 / 交换
+	if (SourceContainer == this)
+	{
+		DropSelection(Payload, TargetPosIdx);
+		return true;
+	}
+
+	// 2. 从其他容器拖入：按相同的行列偏移计算目标格子，再整体转移
+	UEveInventoryMgr* SourceInventory = SourceContainer->GetInventory();
+	UEveInventoryMgr* TargetInventory = GetInventory();
+	if (!ensure(SourceInventory && TargetInventory)) return true;
+
+	const int32 DeltaRow = TargetPosIdx / KNumColumns - Payload.PosIdx / SourceContainer->KNumColumns;
+	const int32 DeltaCol = TargetPosIdx % KNumColumns - Payload.PosIdx % SourceContainer->KNumColumns;
+
+	TArray<int32> ToPosIdxes;
+	ToPosIdxes.Reserve(Payload.PosIdxes.Num());
+	for (const int32 From : Payload.PosIdxes)
+	{
+		const int32 Row = From / SourceContainer->KNumColumns + DeltaRow;
+		const int32 Col = From % SourceContainer->KNumColumns + DeltaCol;
+		if (Row < 0 || Row >= KNumRows || Col < 0 || Col >= KNumColumns) return true; // 超出网格范围
+
+		ToPosIdxes.Add(Row * KNumColumns + Col);
+	}
+
+	if (SourceInventory->TransferItemsTo(TargetInventory, Payload.PosIdxes, ToPosIdxes))
+	{
+		SourceContainer->ClearSelection();
+		SetSelection(ToPosIdxes);
+	}
+
+	return true;
+}
+
+/**
+ * @brief 在空白处按下鼠标左键时开始框选
+ * 
+ * 点在物品上时事件已被 `UEveItemWidget` 处理，不会到达这里。
+ */
+FReply UEveInventoryWidget::NativeOnMouseButtonDown(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent)
+{
+	if (InMouseEvent.GetEffectingButton() != EKeys::LeftMouseButton)
+	{
+		return Super::NativeOnMouseButtonDown(InGeometry, InMouseEvent);
+	}
+
+	// 无修饰键时框选替换原有选择
+	if (!InMouseEvent.IsShiftDown() && !InMouseEvent.IsControlDown())
+	{
+		ClearSelection();
+	}
+
+	bBoxSelecting = true;
+	BoxStartScreen = InMouseEvent.GetScreenSpacePosition();
+	BoxEndScreen = BoxStartScreen;
+
+	return FReply::Handled().CaptureMouse(TakeWidget());
+}
+
+/**
+ * @brief 框选过程中更新选框
+ */
+FReply UEveInventoryWidget::NativeOnMouseMove(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent)
+{
+	if (!bBoxSelecting) return Super::NativeOnMouseMove(InGeometry, InMouseEvent);
+
+	BoxEndScreen = InMouseEvent.GetScreenSpacePosition();
+	Invalidate(EInvalidateWidgetReason::Paint); // 只有框选时才需要重绘选框
+	RequestRetainerRender();
+	return FReply::Handled();
+}
+
+/**
+ * @brief 松开鼠标左键时结束框选，选中与选框相交的物品
+ */
+FReply UEveInventoryWidget::NativeOnMouseButtonUp(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent)
+{
+	if (!bBoxSelecting) return Super::NativeOnMouseButtonUp(InGeometry, InMouseEvent);
+
+	bBoxSelecting = false;
+	BoxEndScreen = InMouseEvent.GetScreenSpacePosition();
+	SelectInScreenRect(BoxStartScreen, BoxEndScreen);
+	Invalidate(EInvalidateWidgetReason::Paint);
+
+	return FReply::Handled().ReleaseMouseCapture();
+}
+
+/**
+ * @brief 绘制框选选框
+ */
+int32 UEveInventoryWidget::NativePaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	LayerId = Super::NativePaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
+	if (!bBoxSelecting) return LayerId;
+
+	const FVector2D A = AllottedGeometry.AbsoluteToLocal(BoxStartScreen);
+	const FVector2D B = AllottedGeometry.AbsoluteToLocal(BoxEndScreen);
+	const TArray<FVector2D> Points{A, FVector2D(B.X, A.Y), B, FVector2D(A.X, B.Y), A};
+
+	FSlateDrawElement::MakeLines(OutDrawElements, ++LayerId, AllottedGeometry.ToPaintGeometry(), Points, ESlateDrawEffect::None, BoxSelectColor, true, 1.f);
+	return LayerId;
 }
 
 /**
- * @brief 拖拽物品到一个空格（旧位置清除）
+ * @brief 拖拽物品到一个空格
  * 
- * - 先移除旧物品
- * - 创建新物品并放置到新的位置
+ * 通过 `MoveItems` 移动，保留物品的堆叠数量。
  * 
  * @param TID 物品的唯一 ID
  * @param OldPosIdx 旧位置索引
@@ -29,23 +164,14 @@ void UEveInventoryWidget::NativeConstruct()
 void UEveInventoryWidget::DragToOtherEmptySlot(int32 TID, int32 OldPosIdx, int32 NewPosIdx) const
 {
 	// 获取背包管理系统
-	UEveInventoryMgr* InventorySys = GetGameInstance()->GetSubsystem<UEveInventoryMgr>();
-    
-	// 先移除旧位置的物品
-	InventorySys->RemoveItem(TID);
-
-	// 创建新物品实例
-	TObjectPtr<UEveItem> Item = NewObject<UEveItem>();
-	Item->TID = TID;
+	UEveInventoryMgr* InventorySys = GetInventory();
+	if (!ensure(InventorySys)) return;
 
-	// 确保 `AllItemsCfg` 中存在该 `TID` 对应的配置
-	if (!ensure(InventorySys->AllItemsCfg.Contains(TID))) return;
-    
-	// 关联物品配置
-	Item->ItemCfg = InventorySys->AllItemsCfg[TID];
+	// 确保旧位置上确实是该物品
+	if (!ensure(InventorySys->PosToTIDMap.FindRef(OldPosIdx) == TID)) return;
 
-	// 将物品添加到新位置
-	InventorySys->AddItem(Item, NewPosIdx);
+	// 将物品移动到新位置
+	InventorySys->MoveItems({OldPosIdx}, {NewPosIdx});
 }
 
 /**
@@ -59,8 +185,318 @@ void UEveInventoryWidget::DragToOtherEmptySlot(int32 TID, int32 OldPosIdx, int32
 void UEveInventoryWidget::DragToExchange(int32 OldPosIdx, int32 NewPosIdx) const
 {
 	// 获取背包管理系统
-	UEveInventoryMgr* InventorySys = GetGameInstance()->GetSubsystem<UEveInventoryMgr>();
+	UEveInventoryMgr* InventorySys = GetInventory();
+	if (!ensure(InventorySys)) return;
 
 	// 调用 `ExchangeItem` 方法，交换两个位置的物品
 	InventorySys->ExchangeItem(OldPosIdx, NewPosIdx);
 }
+
+/**
+ * @brief 将拖拽的一组物品整体放到目标格子
+ * 
+ * 所有目标格子在一次 `MoveItems` 中解析为一个排列，只触发一次背包更新。
+ */
+bool UEveInventoryWidget::DropSelection(const FEveDragPayload& Payload, const int32 TargetPosIdx)
+{
+	UEveInventoryMgr* InventorySys = GetInventory();
+	if (!ensure(InventorySys)) return false;
+	if (TargetPosIdx == Payload.PosIdx) return false;
+
+	// 锚点的行列偏移
+	const int32 DeltaRow = TargetPosIdx / KNumColumns - Payload.PosIdx / KNumColumns;
+	const int32 DeltaCol = TargetPosIdx % KNumColumns - Payload.PosIdx % KNumColumns;
+
+	TArray<int32> ToPosIdxes;
+	ToPosIdxes.Reserve(Payload.PosIdxes.Num());
+	for (const int32 From : Payload.PosIdxes)
+	{
+		const int32 Row = From / KNumColumns + DeltaRow;
+		const int32 Col = From % KNumColumns + DeltaCol;
+		if (Row < 0 || Row >= KNumRows || Col < 0 || Col >= KNumColumns) return false; // 超出网格范围
+
+		ToPosIdxes.Add(Row * KNumColumns + Col);
+	}
+
+	// 先更新选择，背包更新事件重建物品 UI 时即可带上选中状态
+	const TArray<int32> PrevSelection = SelectedPosIdxes;
+	SetSelection(ToPosIdxes);
+
+	if (!InventorySys->MoveItems(Payload.PosIdxes, ToPosIdxes))
+	{
+		SetSelection(PrevSelection);
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief 处理物品点击的选择逻辑
+ */
+void UEveInventoryWidget::SelectOnClick(const int32 PosIdx, const FPointerEvent& InMouseEvent)
+{
+	if (InMouseEvent.IsControlDown())
+	{
+		// Ctrl：切换选中状态
+		if (SelectedPosIdxes.Contains(PosIdx))
+		{
+			SelectedPosIdxes.Remove(PosIdx);
+		}
+		else
+		{
+			SelectedPosIdxes.Add(PosIdx);
+			SelectedPosIdxes.Sort();
+		}
+		SelectionAnchorPosIdx = PosIdx;
+	}
+	else if (InMouseEvent.IsShiftDown() && SelectionAnchorPosIdx != INDEX_NONE)
+	{
+		// Shift：从锚点到当前格子的范围选择（只选有物品的格子）
+		const UEveInventoryMgr* InventorySys = GetInventory();
+		if (!ensure(InventorySys)) return;
+
+		SelectedPosIdxes.Reset();
+		const int32 First = FMath::Min(SelectionAnchorPosIdx, PosIdx);
+		const int32 Last = FMath::Max(SelectionAnchorPosIdx, PosIdx);
+		for (int32 Idx = First; Idx <= Last; Idx++)
+		{
+			if (InventorySys->CurPosIdxes.Contains(Idx))
+			{
+				SelectedPosIdxes.Add(Idx);
+			}
+		}
+	}
+	else if (!SelectedPosIdxes.Contains(PosIdx))
+	{
+		// 无修饰键：点击未选中的物品时只选中该物品（点击已选中的物品保留选择，便于整体拖拽）
+		SelectedPosIdxes.Reset();
+		SelectedPosIdxes.Add(PosIdx);
+		SelectionAnchorPosIdx = PosIdx;
+	}
+
+	RefreshSelectionVisuals();
+}
+
+/**
+ * @brief 清空选择
+ */
+void UEveInventoryWidget::ClearSelection()
+{
+	SelectedPosIdxes.Reset();
+	SelectionAnchorPosIdx = INDEX_NONE;
+	RefreshSelectionVisuals();
+}
+
+/**
+ * @brief 设置选择
+ */
+void UEveInventoryWidget::SetSelection(const TArray<int32>& PosIdxes)
+{
+	SelectedPosIdxes = PosIdxes;
+	SelectedPosIdxes.Sort();
+	SelectionAnchorPosIdx = SelectedPosIdxes.Num() > 0 ? SelectedPosIdxes[0] : INDEX_NONE;
+	RefreshSelectionVisuals();
+}
+
+/**
+ * @brief 设置一组格子上物品 UI 的可见性
+ */
+void UEveInventoryWidget::SetItemsVisibility(const TArray<int32>& PosIdxes, const ESlateVisibility InVisibility) const
+{
+	if (!ensure(Grid)) return;
+
+	for (UWidget* Child : Grid->GetAllChildren())
+	{
+		if (UEveItemWidget* ItemWidget = Cast<UEveItemWidget>(Child); ItemWidget && PosIdxes.Contains(ItemWidget->PosIdx))
+		{
+			ItemWidget->SetVisibility(InVisibility);
+		}
+	}
+}
+
+/**
+ * @brief 计算屏幕坐标所在的格子索引
+ */
+int32 UEveInventoryWidget::GetPosIdxAtScreenPosition(const FVector2D& ScreenPosition) const
+{
+	if (!ensure(Grid)) return INDEX_NONE;
+
+	// 计算网格单元格大小
+	const FGeometry& GridGeometry = Grid->GetCachedGeometry();
+	const FVector2D GridMousePosition = GridGeometry.AbsoluteToLocal(ScreenPosition);
+	const FVector2D GridSize = GridGeometry.GetLocalSize();
+	const float CellWidth = GridSize.X / KNumColumns;
+	const float CellHeight = GridSize.Y / KNumRows;
+
+	// 计算行列索引，并判断是否超出背包网格范围
+	const int32 Row = FMath::FloorToInt(GridMousePosition.Y / CellHeight);
+	const int32 Col = FMath::FloorToInt(GridMousePosition.X / CellWidth);
+	if (Row < 0 || Row >= KNumRows || Col < 0 || Col >= KNumColumns) return INDEX_NONE;
+
+	return Row * KNumColumns + Col;
+}
+
+/**
+ * @brief 获取本容器绑定的背包
+ */
+UEveInventoryMgr* UEveInventoryWidget::GetInventory() const
+{
+	if (Inventory.IsValid()) return Inventory.Get();
+
+	const UGameInstance* GameInstance = GetGameInstance();
+	return GameInstance ? GameInstance->GetSubsystem<UEveInventoryMgr>() : nullptr;
+}
+
+/**
+ * @brief 格子增量已应用到物品 UI 后调用
+ */
+void UEveInventoryWidget::NotifySlotsChanged()
+{
+	if (ActiveFilterIdx != INDEX_NONE)
+	{
+		ApplyFilter();
+	}
+	RequestRetainerRender();
+}
+
+/**
+ * @brief 切换筛选页签
+ */
+void UEveInventoryWidget::SetActiveFilter(const int32 FilterIdx)
+{
+	const int32 NewFilterIdx = FilterTabs.IsValidIndex(FilterIdx) ? FilterIdx : INDEX_NONE;
+	if (ActiveFilterIdx == NewFilterIdx) return;
+
+	ActiveFilterIdx = NewFilterIdx;
+	ApplyFilter();
+	RequestRetainerRender();
+}
+
+/**
+ * @brief 按激活的筛选页签查询格子，并同步到物品 UI
+ * 
+ * 查询条件每次重新编译（物品配置热重载后可能新增了标签位），只是几次哈希查找。
+ */
+void UEveInventoryWidget::ApplyFilter()
+{
+	if (!Grid) return;
+
+	const UEveInventoryMgr* InventorySys = GetInventory();
+	if (ActiveFilterIdx == INDEX_NONE || !InventorySys)
+	{
+		FilterMatches.Reset();
+	}
+	else
+	{
+		const FEveItemFilterTab& Tab = FilterTabs[ActiveFilterIdx];
+		InventorySys->QuerySlots(InventorySys->MakeTagQuery(Tab.AnyTags, Tab.AllTags, Tab.NoneTags), FilterMatches);
+	}
+
+	for (UWidget* Child : Grid->GetAllChildren())
+	{
+		if (UEveItemWidget* ItemWidget = Cast<UEveItemWidget>(Child))
+		{
+			const bool bFilteredOut = FilterMatches.IsValidIndex(ItemWidget->PosIdx) && !FilterMatches[ItemWidget->PosIdx];
+			ItemWidget->SetFilteredOut(bFilteredOut);
+		}
+	}
+}
+
+/**
+ * @brief 切换渲染模式
+ */
+void UEveInventoryWidget::SetRenderMode(const EEveInventoryRenderMode InRenderMode)
+{
+	if (RenderMode == InRenderMode) return;
+
+	RenderMode = InRenderMode;
+	ApplyRenderMode();
+}
+
+/**
+ * @brief 根据 `RenderMode` 配置缓存容器
+ */
+void UEveInventoryWidget::ApplyRenderMode() const
+{
+	if (InvalidationPanel)
+	{
+		InvalidationPanel->SetCanCache(RenderMode == EEveInventoryRenderMode::Invalidation);
+	}
+
+	if (Retainer)
+	{
+		Retainer->SetRetainRendering(RenderMode == EEveInventoryRenderMode::Retainer);
+		RequestRetainerRender();
+	}
+}
+
+/**
+ * @brief 请求 `Retainer` 重新渲染一次
+ */
+void UEveInventoryWidget::RequestRetainerRender() const
+{
+	if (Retainer && RenderMode == EEveInventoryRenderMode::Retainer)
+	{
+		Retainer->RequestRender();
+	}
+}
+
+/**
+ * @brief 将选中状态同步到网格中的物品 UI
+ * 
+ * 只有选中状态真正变化的物品 UI 会失效重绘。
+ */
+void UEveInventoryWidget::RefreshSelectionVisuals() const
+{
+	if (!Grid) return;
+
+	for (UWidget* Child : Grid->GetAllChildren())
+	{
+		if (UEveItemWidget* ItemWidget = Cast<UEveItemWidget>(Child))
+		{
+			ItemWidget->SetSelected(IsSelected(ItemWidget->PosIdx));
+		}
+	}
+
+	RequestRetainerRender();
+}
+
+/**
+ * @brief 选中与屏幕矩形相交的格子中的物品
+ */
+void UEveInventoryWidget::SelectInScreenRect(const FVector2D& ScreenA, const FVector2D& ScreenB)
+{
+	const UEveInventoryMgr* InventorySys = GetInventory();
+	if (!ensure(Grid) || !ensure(InventorySys)) return;
+
+	// 将选框转换到网格局部坐标
+	const FGeometry& GridGeometry = Grid->GetCachedGeometry();
+	const FVector2D LocalA = GridGeometry.AbsoluteToLocal(ScreenA);
+	const FVector2D LocalB = GridGeometry.AbsoluteToLocal(ScreenB);
+	const FVector2D GridSize = GridGeometry.GetLocalSize();
+	const float CellWidth = GridSize.X / KNumColumns;
+	const float CellHeight = GridSize.Y / KNumRows;
+
+	// 选框覆盖的行列范围
+	const int32 MinCol = FMath::Clamp(FMath::FloorToInt(FMath::Min(LocalA.X, LocalB.X) / CellWidth), 0, KNumColumns - 1);
+	const int32 MaxCol = FMath::Clamp(FMath::FloorToInt(FMath::Max(LocalA.X, LocalB.X) / CellWidth), 0, KNumColumns - 1);
+	const int32 MinRow = FMath::Clamp(FMath::FloorToInt(FMath::Min(LocalA.Y, LocalB.Y) / CellHeight), 0, KNumRows - 1);
+	const int32 MaxRow = FMath::Clamp(FMath::FloorToInt(FMath::Max(LocalA.Y, LocalB.Y) / CellHeight), 0, KNumRows - 1);
+
+	for (int32 Row = MinRow; Row <= MaxRow; Row++)
+	{
+		for (int32 Col = MinCol; Col <= MaxCol; Col++)
+		{
+			const int32 PosIdx = Row * KNumColumns + Col;
+			if (InventorySys->CurPosIdxes.Contains(PosIdx))
+			{
+				SelectedPosIdxes.AddUnique(PosIdx);
+			}
+		}
+	}
+
+	SelectedPosIdxes.Sort();
+	SelectionAnchorPosIdx = SelectedPosIdxes.Num() > 0 ? SelectedPosIdxes[0] : INDEX_NONE;
+	RefreshSelectionVisuals();
+}
@@ -4,8 +4,57 @@
 
 #include "CoreMinimal.h"
 #include "Blueprint/UserWidget.h"
+#include "GameplayTagContainer.h"
 #include "EveInventoryWidget.generated.h"
 
+class UEveInventoryMgr;
+class UInvalidationBox;
+class URetainerBox;
+struct FEveDragPayload;
+
+/**
+ * @brief 背包 UI 的渲染模式
+ */
+UENUM(BlueprintType)
+enum class EEveInventoryRenderMode : uint8
+{
+	/** 每帧正常绘制 */
+	Immediate,
+	/** 使用 `InvalidationPanel` 缓存，只有失效的物品 UI 才重新绘制 */
+	Invalidation,
+	/** 使用 `Retainer` 渲染到纹理，只有格子增量到达时才重新渲染 */
+	Retainer,
+};
+
+/**
+ * @brief 背包筛选页签
+ * 
+ * 三组标签在应用时由 `UEveInventoryMgr::MakeTagQuery` 编译为位掩码，
+ * 筛选只对格子的标签掩码数组做位运算，不遍历物品配置。
+ */
+USTRUCT(BlueprintType)
+struct FEveItemFilterTab
+{
+	GENERATED_BODY()
+
+public:
+	/** 页签名称 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Filter")
+	FText Label;
+
+	/** 至少包含其中一个标签 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Filter", meta=(Categories="Item"))
+	FGameplayTagContainer AnyTags;
+
+	/** 必须包含全部标签 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Filter", meta=(Categories="Item"))
+	FGameplayTagContainer AllTags;
+
+	/** 不能包含其中任何标签 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Filter", meta=(Categories="Item"))
+	FGameplayTagContainer NoneTags;
+};
+
 /**
  * @brief 背包 UI 组件
  * 
@@ -13,26 +62,49 @@
  * 主要功能：
  * - 监听 UI 构造事件
  * - 处理物品拖拽：拖拽物品到空格、交换物品位置
+ * - 多选（Shift/Ctrl 点击、框选）与整体拖拽，包括拖入其他容器
+ * - 保留式渲染：不参与原生 Tick，空闲时不重绘（见 `RenderMode`）
  */
-UCLASS()
+UCLASS(meta=(DisableNativeTick))
 class UEveInventoryWidget : public UUserWidget
 {
 	GENERATED_BODY()
 
 public:
-	/** 
+	/**
 	 * @brief UI 初始化
 	 * 
 	 * 该方法在 `UserWidget` 被构造时调用，用于确保 `Grid` 组件正确绑定。
 	 */
 	virtual void NativeConstruct() override;
-	
+
+	/**
+	 * @brief 物品拖拽放下时调用
+	 * 
+	 * - 拖拽来源为本容器：整体移动 / 交换选中的物品
+	 * - 拖拽来源为其他容器：将选中的物品转移到本容器
+	 * 
+	 * @return 是否处理了该拖拽
+	 */
+	virtual bool NativeOnDrop(const FGeometry& InGeometry, const FDragDropEvent& InDragDropEvent, UDragDropOperation* InOperation) override;
+
+	/** @brief 在空白处按下鼠标左键时开始框选 */
+	virtual FReply NativeOnMouseButtonDown(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent) override;
+
+	/** @brief 框选过程中更新选框 */
+	virtual FReply NativeOnMouseMove(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent) override;
+
+	/** @brief 松开鼠标左键时结束框选 */
+	virtual FReply NativeOnMouseButtonUp(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent) override;
+
+	/** @brief 绘制框选选框 */
+	virtual int32 NativePaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+
 public:
 	/**
-	 * @brief 拖拽物品到一个空格（旧位置清除）
+	 * @brief 拖拽物品到一个空格
 	 * 
-	 * - 先移除旧物品
-	 * - 在新位置创建新的物品对象
+	 * 通过 `MoveItems` 移动，保留物品的堆叠数量。
 	 * 
 	 * @param TID 物品唯一 ID
 	 * @param OldPosIdx 旧位置索引
@@ -50,8 +122,109 @@ public:
 	 */
 	void DragToExchange(int32 OldPosIdx, int32 NewPosIdx) const;
 
+	/**
+	 * @brief 将拖拽的一组物品整体放到目标格子
+	 * 
+	 * 以拖拽锚点（`Payload.PosIdx`）对齐 `TargetPosIdx`，其余物品保持相对行列偏移。
+	 * 
+	 * @param Payload 拖拽负载
+	 * @param TargetPosIdx 锚点物品的目标格子
+	 * @return 是否放置成功
+	 */
+	bool DropSelection(const FEveDragPayload& Payload, int32 TargetPosIdx);
+
 public:
-	/** 
+	/**
+	 * @brief 处理物品点击的选择逻辑
+	 * 
+	 * - Ctrl：切换该物品的选中状态
+	 * - Shift：从锚点到该物品按格子顺序范围选择
+	 * - 无修饰键：点击未选中的物品时只选中该物品
+	 * 
+	 * @param PosIdx 被点击物品的格子索引
+	 * @param InMouseEvent 鼠标事件（读取修饰键）
+	 */
+	void SelectOnClick(int32 PosIdx, const FPointerEvent& InMouseEvent);
+
+	/** @brief 清空选择 */
+	void ClearSelection();
+
+	/** @brief 设置选择（按格子索引） */
+	void SetSelection(const TArray<int32>& PosIdxes);
+
+	/** @brief 某个格子是否被选中 */
+	bool IsSelected(int32 PosIdx) const { return SelectedPosIdxes.Contains(PosIdx); }
+
+	/** @brief 当前选中的格子索引（升序） */
+	const TArray<int32>& GetSelectedPosIdxes() const { return SelectedPosIdxes; }
+
+	/**
+	 * @brief 设置一组格子上物品 UI 的可见性
+	 * 
+	 * @param PosIdxes 格子索引
+	 * @param InVisibility 可见性
+	 */
+	void SetItemsVisibility(const TArray<int32>& PosIdxes, ESlateVisibility InVisibility) const;
+
+	/**
+	 * @brief 计算屏幕坐标所在的格子索引
+	 * 
+	 * @param ScreenPosition 屏幕坐标
+	 * @return 格子索引，超出网格范围时返回 `INDEX_NONE`
+	 */
+	int32 GetPosIdxAtScreenPosition(const FVector2D& ScreenPosition) const;
+
+	/** @brief 获取本容器绑定的背包（未绑定时使用 `GameInstance` 上的背包） */
+	UEveInventoryMgr* GetInventory() const;
+
+	/**
+	 * @brief 格子增量已应用到物品 UI 后调用
+	 * 
+	 * `Retainer` 模式下请求重新渲染一次；其他模式下物品 UI 已各自失效，无需额外处理。
+	 * 有激活的筛选页签时重新应用筛选。
+	 */
+	void NotifySlotsChanged();
+
+	/**
+	 * @brief 切换筛选页签
+	 * 
+	 * 不匹配的物品变暗显示，格子布局不变。
+	 * 
+	 * @param FilterIdx `FilterTabs` 中的下标，`INDEX_NONE` 表示显示全部
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	void SetActiveFilter(int32 FilterIdx);
+
+	/** @brief 当前激活的筛选页签下标 */
+	UFUNCTION(BlueprintPure, Category = "Inventory")
+	int32 GetActiveFilter() const { return ActiveFilterIdx; }
+
+	/**
+	 * @brief 切换渲染模式
+	 * 
+	 * @param InRenderMode 新的渲染模式
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	void SetRenderMode(EEveInventoryRenderMode InRenderMode);
+
+private:
+	/** @brief 将选中状态同步到网格中的物品 UI */
+	void RefreshSelectionVisuals() const;
+
+	/** @brief 选中与屏幕矩形相交的格子中的物品 */
+	void SelectInScreenRect(const FVector2D& ScreenA, const FVector2D& ScreenB);
+
+	/** @brief 根据 `RenderMode` 配置缓存容器 */
+	void ApplyRenderMode() const;
+
+	/** @brief 请求 `Retainer` 重新渲染一次（选择、框选等视觉变化时调用） */
+	void RequestRetainerRender() const;
+
+	/** @brief 按激活的筛选页签查询格子，并同步到物品 UI */
+	void ApplyFilter();
+
+public:
+	/**
 	 * @brief 背包网格组件
 	 * 
 	 * `UniformGridPanel` 组件用于存放 `EveItemWidget`（单个物品 UI）。
@@ -59,4 +232,69 @@ public:
 	 */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(BindWidget))
 	TObjectPtr<class UUniformGridPanel> Grid;
+
+	/** 
+	 * @brief 可选的失效缓存面板（包裹 `Grid`）
+	 * 
+	 * `Invalidation` 模式下开启缓存，空闲时整个背包的绘制直接复用缓存。
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(BindWidgetOptional))
+	TObjectPtr<UInvalidationBox> InvalidationPanel;
+
+	/** 
+	 * @brief 可选的保留渲染容器（包裹 `Grid`）
+	 * 
+	 * `Retainer` 模式下开启，UMG 中需勾选 `RenderOnInvalidation`，
+	 * 只有 `NotifySlotsChanged` 请求时才重新渲染到纹理。
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(BindWidgetOptional))
+	TObjectPtr<URetainerBox> Retainer;
+
+	/** 渲染模式 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Inventory")
+	EEveInventoryRenderMode RenderMode = EEveInventoryRenderMode::Invalidation;
+
+	/**
+	 * @brief 本容器绑定的背包
+	 * 
+	 * 不同容器（背包、仓库等）绑定不同的 `UEveInventoryMgr`，拖拽在容器之间时据此转移物品。
+	 */
+	UPROPERTY()
+	TWeakObjectPtr<UEveInventoryMgr> Inventory;
+
+	/** 网格的行数 */
+	const int32 KNumRows = 2;
+
+	/** 网格的列数 */
+	const int32 KNumColumns = 3;
+
+	/** 筛选页签（在蓝图中据此生成页签按钮，点击时调用 `SetActiveFilter`） */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory")
+	TArray<FEveItemFilterTab> FilterTabs;
+
+	/** 框选选框颜色 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory")
+	FLinearColor BoxSelectColor = FLinearColor(1.f, 1.f, 1.f, 0.8f);
+
+private:
+	/** 当前选中的格子索引（升序） */
+	TArray<int32> SelectedPosIdxes;
+
+	/** 当前激活的筛选页签下标 */
+	int32 ActiveFilterIdx = INDEX_NONE;
+
+	/** 筛选结果（每个格子是否匹配），复用避免分配 */
+	TBitArray<> FilterMatches;
+
+	/** Shift 范围选择的锚点 */
+	int32 SelectionAnchorPosIdx = INDEX_NONE;
+
+	/** 是否正在框选 */
+	bool bBoxSelecting = false;
+
+	/** 框选起点（屏幕坐标） */
+	FVector2D BoxStartScreen = FVector2D::ZeroVector;
+
+	/** 框选当前点（屏幕坐标） */
+	FVector2D BoxEndScreen = FVector2D::ZeroVector;
 };
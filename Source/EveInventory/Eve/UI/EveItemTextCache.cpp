@@ -0,0 +1,144 @@
+// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#include "EveItemTextCache.h"
+
+#include "Framework/Application/SlateApplication.h"
+#include "Fonts/FontMeasure.h"
+#include "Internationalization/Internationalization.h"
+#include "Internationalization/StringTable.h"
+#include "Internationalization/StringTableCore.h"
+#include "Rendering/SlateRenderer.h"
+#include "Styling/CoreStyle.h"
+#include "EveInventory/Eve/Asset/EveAssetMgr.h"
+#include "EveInventory/Eve/Manager/EveInventoryMgr.h"
+
+void UEveItemTextCache::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	InventoryMgr = Collection.InitializeDependency<UEveInventoryMgr>();
+	InventoryMgr->OnItemCfgsChanged.AddUObject(this, &ThisClass::HandleItemCfgsChanged);
+
+	LabelFont = FCoreStyle::GetDefaultFontStyle("Regular", 10);
+
+	if (const UStringTable* StringTable = UEveAssetMgr::Get().GetAssetSync(UEveAssetMgr::Get().ItemNameStringTable))
+	{
+		NameStringTableId = StringTable->GetStringTableId();
+	}
+
+	FInternationalization::Get().OnCultureChanged().AddUObject(this, &ThisClass::HandleCultureChanged);
+}
+
+void UEveItemTextCache::Deinitialize()
+{
+	FInternationalization::Get().OnCultureChanged().RemoveAll(this);
+	if (InventoryMgr)
+	{
+		InventoryMgr->OnItemCfgsChanged.RemoveAll(this);
+	}
+	Entries.Empty();
+
+	Super::Deinitialize();
+}
+
+const FText& UEveItemTextCache::GetName(const int32 CfgIdx)
+{
+	return GetEntry(CfgIdx).Name;
+}
+
+float UEveItemTextCache::GetLabelWidth(const int32 CfgIdx)
+{
+	return GetEntry(CfgIdx).LabelWidth;
+}
+
+const FText& UEveItemTextCache::GetNameByTID(const int32 TID)
+{
+	return GetName(InventoryMgr->FindCfgIdx(TID));
+}
+
+/**
+ * @brief 设置测量标签宽度使用的字体
+ * 
+ * 复用文化版本号让所有条目失效，名称在下次访问时一并重建。
+ */
+void UEveItemTextCache::SetLabelFont(const FSlateFontInfo& Font)
+{
+	if (LabelFont == Font) return;
+
+	LabelFont = Font;
+	CultureStamp++;
+	OnItemTextsChanged.Broadcast();
+}
+
+void UEveItemTextCache::Invalidate(const TArray<int32>& TIDs)
+{
+	for (const int32 TID : TIDs)
+	{
+		const int32 CfgIdx = InventoryMgr->FindCfgIdx(TID);
+		if (Entries.IsValidIndex(CfgIdx))
+		{
+			Entries[CfgIdx].CultureStamp = 0;
+		}
+	}
+}
+
+/**
+ * @brief 获取条目，不是当前文化版本时重建
+ * 
+ * 重建只发生在首次访问和文化切换 / 热重载后的首次访问。
+ */
+const UEveItemTextCache::FEntry& UEveItemTextCache::GetEntry(const int32 CfgIdx)
+{
+	static const FEntry EmptyEntry;
+
+	const UEveItemCfg* ItemCfg = InventoryMgr->GetCfgByIdx(CfgIdx);
+	if (!ItemCfg) return EmptyEntry;
+
+	if (!Entries.IsValidIndex(CfgIdx))
+	{
+		Entries.SetNum(InventoryMgr->ItemCfgs.Num());
+	}
+
+	FEntry& Entry = Entries[CfgIdx];
+	if (Entry.CultureStamp == CultureStamp) return Entry;
+
+	// 字符串表中有该 TID 时使用本地化文本，否则使用配置中的名称
+	const FString Key = FString::FromInt(ItemCfg->ItemData.TID);
+	FStringTableConstPtr StringTable = NameStringTableId.IsNone() ? nullptr : FStringTableRegistry::Get().FindStringTable(NameStringTableId);
+	FString SourceString;
+	if (StringTable.IsValid() && StringTable->GetSourceString(Key, SourceString))
+	{
+		Entry.Name = FText::FromStringTable(NameStringTableId, Key);
+	}
+	else
+	{
+		Entry.Name = FText::AsCultureInvariant(ItemCfg->GetDisplayName());
+	}
+
+	Entry.LabelWidth = 0.f;
+	if (FSlateApplication::IsInitialized())
+	{
+		const TSharedRef<FSlateFontMeasure> FontMeasure = FSlateApplication::Get().GetRenderer()->GetFontMeasureService();
+		Entry.LabelWidth = FontMeasure->Measure(Entry.Name, LabelFont).X;
+	}
+
+	Entry.CultureStamp = CultureStamp;
+	return Entry;
+}
+
+/**
+ * @brief 文化切换：推进版本号并通知 UI
+ */
+void UEveItemTextCache::HandleCultureChanged()
+{
+	CultureStamp++;
+	OnItemTextsChanged.Broadcast();
+}
+
+void UEveItemTextCache::HandleItemCfgsChanged(const TArray<int32>& ChangedTIDs)
+{
+	Invalidate(ChangedTIDs);
+
+	// 与切换文化一样通知 UI，正在显示的标签立即换成新名称
+	OnItemTextsChanged.Broadcast();
+}
@@ -0,0 +1,108 @@
+// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Fonts/SlateFontInfo.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "EveItemTextCache.generated.h"
+
+class UEveInventoryMgr;
+
+/**
+ * @brief 物品文本缓存（UEveItemTextCache）
+ * 
+ * 按配置索引（`CfgIdx`）存放每个物品的本地化名称 `FText` 及其标签宽度：
+ * - 名称优先取自字符串表 `UEveAssetMgr::ItemNameStringTable`（键为 TID），否则使用配置中的名称
+ * - 每个物品在每种文化下只构建一次，所有 UI（格子标签、提示框、搜索）共享同一个 `FText`
+ * - 标签宽度按格子名称标签的字体（`SetLabelFont`）预先测量，格子标签无需再次测量文本
+ * - 切换文化时只推进版本号，条目在下次访问时才重建，未显示的物品不产生开销
+ */
+UCLASS()
+class UEveItemTextCache : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+public:
+	/**
+	 * @brief 获取物品的本地化名称
+	 * 
+	 * @param CfgIdx 物品配置索引
+	 * @return 名称，索引无效时返回空文本
+	 */
+	const FText& GetName(int32 CfgIdx);
+
+	/**
+	 * @brief 获取物品名称按 `LabelFont` 测量的宽度
+	 * 
+	 * @param CfgIdx 物品配置索引
+	 * @return 宽度（Slate 单位），Slate 未初始化时为 0
+	 */
+	float GetLabelWidth(int32 CfgIdx);
+
+	/**
+	 * @brief 设置测量标签宽度使用的字体（取自格子控件的名称标签）
+	 * 
+	 * 字体变化时所有条目在下次访问时重新测量，并通知 UI 刷新标签。
+	 * 
+	 * @param Font 名称标签的字体
+	 */
+	void SetLabelFont(const FSlateFontInfo& Font);
+
+	/** @brief 按 TID 获取物品的本地化名称 */
+	const FText& GetNameByTID(int32 TID);
+
+	/**
+	 * @brief 使指定物品的条目失效（物品配置热重载后调用）
+	 * 
+	 * @param TIDs 物品 TID
+	 */
+	void Invalidate(const TArray<int32>& TIDs);
+
+public:
+	/**
+	 * 物品文本变化事件（切换文化或物品配置热重载后触发），UI 据此只刷新正在显示的标签。
+	 */
+	DECLARE_MULTICAST_DELEGATE(FEveOnItemTextsChanged);
+	FEveOnItemTextsChanged OnItemTextsChanged;
+
+private:
+	/** 单个物品的文本条目 */
+	struct FEntry
+	{
+		FText Name;
+		float LabelWidth = 0.f;
+		uint32 CultureStamp = 0;
+	};
+
+	/** @brief 获取条目，不是当前文化版本时重建 */
+	const FEntry& GetEntry(int32 CfgIdx);
+
+	/** @brief 文化切换：推进版本号并通知 UI */
+	void HandleCultureChanged();
+
+	/** @brief 物品配置热重载：使条目失效并通知 UI */
+	void HandleItemCfgsChanged(const TArray<int32>& ChangedTIDs);
+
+private:
+	/** 背包管理子系统（提供物品配置） */
+	UPROPERTY()
+	TObjectPtr<UEveInventoryMgr> InventoryMgr;
+
+	/** 按配置索引存放的文本条目 */
+	TArray<FEntry> Entries;
+
+	/** 当前文化版本号（从 1 开始，条目为 0 表示未构建或已失效） */
+	uint32 CultureStamp = 1;
+
+	/** 格子标签字体，用于预先测量标签宽度（格子控件创建前为默认字体） */
+	FSlateFontInfo LabelFont;
+
+	/** 物品名称字符串表 ID（未配置时为 `NAME_None`） */
+	FName NameStringTableId;
+};
@@ -0,0 +1,88 @@
+// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#include "EveItemTooltipWidget.h"
+
+#include "Blueprint/WidgetTree.h"
+#include "Components/Border.h"
+#include "Components/TextBlock.h"
+#include "Components/VerticalBox.h"
+
+#define LOCTEXT_NAMESPACE "EveItemTooltip"
+
+/**
+ * @brief 构建默认布局
+ * 
+ * 蓝图子类已有布局时不做任何修改。
+ */
+void UEveItemTooltipWidget::NativeOnInitialized()
+{
+	Super::NativeOnInitialized();
+
+	if (!WidgetTree || WidgetTree->RootWidget) return;
+
+	UBorder* Border = WidgetTree->ConstructWidget<UBorder>(UBorder::StaticClass(), TEXT("Background"));
+	Border->SetBrushColor(FLinearColor(0.f, 0.f, 0.f, 0.8f));
+	Border->SetPadding(FMargin(8.f, 6.f));
+	WidgetTree->RootWidget = Border;
+
+	UVerticalBox* Box = WidgetTree->ConstructWidget<UVerticalBox>(UVerticalBox::StaticClass(), TEXT("Lines"));
+	Border->SetContent(Box);
+
+	auto AddLine = [this, Box](const FName Name)
+	{
+		UTextBlock* Line = WidgetTree->ConstructWidget<UTextBlock>(UTextBlock::StaticClass(), Name);
+		Box->AddChildToVerticalBox(Line);
+		return Line;
+	};
+	NameText = AddLine(TEXT("NameText"));
+	AmountText = AddLine(TEXT("AmountText"));
+	WeightText = AddLine(TEXT("WeightText"));
+	ValueText = AddLine(TEXT("ValueText"));
+	TotalWeightText = AddLine(TEXT("TotalWeightText"));
+}
+
+/**
+ * @brief 显示物品信息
+ * 
+ * 只格式化发生变化的行；同一物品重复悬停时直接返回。
+ */
+void UEveItemTooltipWidget::SetItem(const int32 InTID, const FText& Name, const FEveItemAggregate& Aggregate, const FEveItemAggregate& Total)
+{
+	const bool bItemChanged = ItemTID != InTID;
+	const bool bAggregateChanged = bItemChanged || !(ShownAggregate == Aggregate);
+	const bool bTotalChanged = bItemChanged || ShownTotal.Weight != Total.Weight;
+	ItemTID = InTID;
+	ShownAggregate = Aggregate;
+	ShownTotal = Total;
+
+	FNumberFormattingOptions WeightFormat;
+	WeightFormat.MaximumFractionalDigits = 1;
+
+	if (NameText && !NameText->GetText().IdenticalTo(Name))
+	{
+		NameText->SetText(Name);
+	}
+
+	if (bAggregateChanged)
+	{
+		if (AmountText)
+		{
+			AmountText->SetText(FText::Format(LOCTEXT("Amount", "Amount: {0}"), FText::AsNumber(Aggregate.Amount)));
+		}
+		if (WeightText)
+		{
+			WeightText->SetText(FText::Format(LOCTEXT("Weight", "Weight: {0}"), FText::AsNumber(Aggregate.Weight, &WeightFormat)));
+		}
+		if (ValueText)
+		{
+			ValueText->SetText(FText::Format(LOCTEXT("Value", "Value: {0}"), FText::AsNumber(Aggregate.Value)));
+		}
+	}
+
+	if (bTotalChanged && TotalWeightText)
+	{
+		TotalWeightText->SetText(FText::Format(LOCTEXT("TotalWeight", "Carried: {0}"), FText::AsNumber(Total.Weight, &WeightFormat)));
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,71 @@
+// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "EveInventory/Eve/Data/EveItemData.h"
+#include "EveItemTooltipWidget.generated.h"
+
+/**
+ * @brief 物品提示框 UI 组件
+ * 
+ * 所有格子共享同一个提示框实例，由 `UEveInventoryUI` 在首次悬停时创建。
+ * 悬停时只写入缓存好的名称与统计汇总，内容未变化时不做任何修改。
+ * 
+ * 蓝图子类可绑定任意文本控件；未设置 `UEveAssetMgr::TooltipClass` 时使用原生的默认布局。
+ */
+UCLASS(meta=(DisableNativeTick))
+class UEveItemTooltipWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * @brief UI 初始化
+	 * 
+	 * 没有蓝图布局时构建默认布局（名称、数量、重量、价值、背包总重）。
+	 */
+	virtual void NativeOnInitialized() override;
+
+public:
+	/**
+	 * @brief 显示物品信息
+	 * 
+	 * @param InTID 物品 TID
+	 * @param Name 物品名称（`UEveItemTextCache` 中共享的文本）
+	 * @param Aggregate 该物品的统计汇总
+	 * @param Total 整个背包的统计汇总
+	 */
+	void SetItem(int32 InTID, const FText& Name, const FEveItemAggregate& Aggregate, const FEveItemAggregate& Total);
+
+	/** @brief 当前显示的物品 TID */
+	int32 GetItemTID() const { return ItemTID; }
+
+private:
+	/** 当前显示的内容，用于跳过未变化的刷新 */
+	int32 ItemTID = -1;
+	FEveItemAggregate ShownAggregate;
+	FEveItemAggregate ShownTotal;
+
+public:
+	/** 物品名称 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(BindWidgetOptional))
+	TObjectPtr<class UTextBlock> NameText;
+
+	/** 持有数量 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(BindWidgetOptional))
+	TObjectPtr<class UTextBlock> AmountText;
+
+	/** 该物品的总重量 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(BindWidgetOptional))
+	TObjectPtr<class UTextBlock> WeightText;
+
+	/** 该物品的总价值 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(BindWidgetOptional))
+	TObjectPtr<class UTextBlock> ValueText;
+
+	/** 整个背包的总重量 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(BindWidgetOptional))
+	TObjectPtr<class UTextBlock> TotalWeightText;
+};
@@ -2,12 +2,14 @@
 
 #include "EveItemWidget.h"
 
-#include "Blueprint/DragDropOperation.h"
+#include "EveDragDropOperation.h"
+#include "EveInventoryUI.h"
 #include "Blueprint/WidgetBlueprintLibrary.h"
 #include "Components/UniformGridPanel.h"
 #include "Blueprint/WidgetTree.h"
 #include "Components/Image.h"
 #include "Components/SizeBox.h"
+#include "Components/TextBlock.h"
 #include "EveInventory/Eve/Manager/EveInventoryMgr.h"
 #include "Framework/Application/SlateApplication.h"
 
@@ -28,9 +30,8 @@ void UEveItemWidget::NativeConstruct()
  * @brief 处理物品拖拽开始事件
  * 
  * `NativeOnDragDetected()` 触发时：
- * - 创建一个 `UImage` 作为拖拽时的视觉对象
- * - 生成 `UDragDropOperation`，用于拖拽操作
- * - 将当前物品的 `TID` 传入 `Payload`
+ * - 从 `UEveInventoryUI` 的拖拽对象池中取出复用的 `UEveDragDropOperation`
+ * - 将当前物品的 `TID` 与 `PosIdx` 写入强类型负载 `FEveDragPayload`
  * - 隐藏当前 `ItemWidget`
  * 
  * @param InGeometry 物品 UI 的几何信息
@@ -41,37 +42,46 @@ void UEveItemWidget::NativeOnDragDetected(const FGeometry& InGeometry, const FPo
 {
 	Super::NativeOnDragDetected(InGeometry, InMouseEvent, OutOperation);
 
-	// 获取库存管理系统
-	UEveInventoryMgr* InventorySys = GetGameInstance()->GetSubsystem<UEveInventoryMgr>();
-	if (!ensure(InventorySys->AllItemsCfg.Contains(ItemTID))) return;
-	if (!ensure(InventorySys->AllItemsCfg[ItemTID])) return;
-
-	// 创建拖拽时的图片
-	UImage* DragImage = NewObject<UImage>();
-	UTexture2D* DragTexture = InventorySys->AllItemsCfg[ItemTID]->ItemData.Icon;
-	DragImage->SetBrushFromTexture(DragTexture);
-	DragImage->SetRenderScale(FVector2D(ScaleSize));
-
-	// 创建拖拽操作
-	UDragDropOperation* DragDropOpr = NewObject<UDragDropOperation>(GetTransientPackage());
-	DragDropOpr->DefaultDragVisual = DragImage;  // 设置拖拽显示的 UI
-	DragDropOpr->Payload = this;  // 传递当前 `ItemWidget`
-	DragDropOpr->Pivot = EDragPivot::CenterCenter;
+	// 获取库存管理系统与物品配置（缓存的配置索引，直接数组访问）
+	if (!ensure(OwnerWidget.IsValid())) return;
+	const UEveInventoryMgr* InventorySys = OwnerWidget->GetInventory();
+	if (!ensure(InventorySys)) return;
+	const UEveItemCfg* ItemCfg = InventorySys->GetCfgByIdx(CfgIdx);
+	if (!ensure(ItemCfg)) return;
+
+	// 获取拖拽对象池
+	if (!ensure(DragDropPool.IsValid())) return;
+
+	// 填充强类型负载
+	FEveDragPayload Payload;
+	Payload.TID = ItemTID;
+	Payload.PosIdx = PosIdx;
+	Payload.SourceWidget = this;
+
+	// 取出复用的拖拽操作（拖拽图片随操作一起复用）
+	UEveDragDropOperation* DragDropOpr = DragDropPool->Acquire(Payload, ItemCfg->ItemData.IconBrush);
+	if (!ensure(DragDropOpr)) return;
+
+	// 当前物品被选中时整体拖拽所有选中的物品，否则只拖拽当前物品
+	if (OwnerWidget->IsSelected(PosIdx))
+	{
+		DragDropOpr->EvePayload.PosIdxes.Append(OwnerWidget->GetSelectedPosIdxes());
+	}
+	else
+	{
+		DragDropOpr->EvePayload.PosIdxes.Add(PosIdx);
+	}
 	OutOperation = DragDropOpr;
 
-	// 隐藏原来的 `ItemWidget`
-	SetVisibility(ESlateVisibility::Hidden);
+	// 隐藏所有被拖拽的 `ItemWidget`
+	OwnerWidget->SetItemsVisibility(DragDropOpr->EvePayload.PosIdxes, ESlateVisibility::Hidden);
 }
 
 /**
- * @brief 处理拖拽取消事件（物品未成功放置）
+ * @brief 处理拖拽取消事件（物品未被任何容器接收）
  * 
- * `NativeOnDragCancelled()` 触发时：
- * - 计算鼠标是否在 `UniformGridPanel` 背包网格范围内
- * - 判断是否拖拽到了空格子或已有物品的格子
- * - 根据情况：
- *   - 还原 `ItemWidget` 可见性（如果无效拖拽）
- *   - 调用 `DragToOtherEmptySlot()` 或 `DragToExchange()`
+ * 放到背包网格上的拖拽由 `UEveInventoryWidget::NativeOnDrop()` 处理，
+ * 到达这里说明拖拽落在了所有容器之外，只需还原被拖拽物品的可见性。
  * 
  * @param InDragDropEvent 拖拽事件
  * @param InOperation 拖拽操作
@@ -79,49 +89,20 @@ void UEveItemWidget::NativeOnDragDetected(const FGeometry& InGeometry, const FPo
 void UEveItemWidget::NativeOnDragCancelled(const FDragDropEvent& InDragDropEvent, UDragDropOperation* InOperation)
 {
 	Super::NativeOnDragCancelled(InDragDropEvent, InOperation);
-	if (!ensure(OwnerGrid.IsValid())) return;
-
-	// 获取鼠标位置
-	FVector2D MousePosition = InDragDropEvent.GetScreenSpacePosition();
-	FVector2D GridMousePosition = OwnerGrid->GetCachedGeometry().AbsoluteToLocal(MousePosition);
-	FVector2D GridSize = OwnerGrid->GetCachedGeometry().GetLocalSize();
 
-	// 计算网格单元格大小
-	float CellWidth = GridSize.X / KNumColumns;
-	float CellHeight = GridSize.Y / KNumRows;
+	// 读取强类型负载
+	const UEveDragDropOperation* DragDropOpr = Cast<UEveDragDropOperation>(InOperation);
+	if (!ensure(DragDropOpr)) return;
 
-	// 计算鼠标所处的行列索引
-	int32 Row = FMath::FloorToInt(GridMousePosition.Y / CellHeight);
-	int32 Col = FMath::FloorToInt(GridMousePosition.X / CellWidth);
-	int32 MousePosIdx = Row * KNumColumns + Col;
-
-	// 判断鼠标是否超出背包网格范围
-	bool bCrossBorder = false;
-	if (Row < 0 || Row >= KNumRows || Col < 0 || Col >= KNumColumns)
+	// 还原 `ItemWidget` 可见性（无效拖拽）
+	if (OwnerWidget.IsValid())
 	{
-		bCrossBorder = true;
+		OwnerWidget->SetItemsVisibility(DragDropOpr->EvePayload.PosIdxes, ESlateVisibility::Visible);
 	}
-
-	// 获取库存管理系统
-	UEveInventoryMgr* InventorySys = GetGameInstance()->GetSubsystem<UEveInventoryMgr>();
-	if (!ensure(OwnerWidget.IsValid())) return;
-
-	// 处理拖拽取消逻辑：
-	if (MousePosIdx == PosIdx || !AllPosIdx.Contains(MousePosIdx) || bCrossBorder)
+	else
 	{
-		// 1. 还原 `ItemWidget` 可见性（无效拖拽）
 		SetVisibility(ESlateVisibility::Visible);
 	}
-	else if (!InventorySys->CurPosIdxes.Contains(MousePosIdx))
-	{
-		// 2. 拖拽到空格子
-		OwnerWidget->DragToOtherEmptySlot(ItemTID, PosIdx, MousePosIdx);
-	}
-	else if (InventorySys->CurPosIdxes.Contains(MousePosIdx))
-	{
-		// 3. 拖拽到另一个物品的位置（交换）
-		OwnerWidget->DragToExchange(PosIdx, MousePosIdx);
-	}
 }
 
 /**
@@ -129,6 +110,7 @@ void UEveItemWidget::NativeOnDragCancelled(const FDragDropEvent& InDragDropEvent
  * 
  * `NativeOnMouseButtonDown()` 触发时：
  * - 检测鼠标左键按下
+ * - 根据 Shift/Ctrl 更新所属背包 UI 的选择
  * - 调用 `DetectDragIfPressed()` 触发拖拽事件
  * 
  * @param InGeometry 物品 UI 的几何信息
@@ -139,6 +121,135 @@ FReply UEveItemWidget::NativeOnMouseButtonDown(const FGeometry& InGeometry, cons
 {
 	Super::NativeOnMouseButtonDown(InGeometry, InMouseEvent);
 
+	// 更新选择
+	if (InMouseEvent.GetEffectingButton() == EKeys::LeftMouseButton && OwnerWidget.IsValid())
+	{
+		OwnerWidget->SelectOnClick(PosIdx, InMouseEvent);
+	}
+
 	// 监听鼠标左键点击，开始拖拽
 	return UWidgetBlueprintLibrary::DetectDragIfPressed(InMouseEvent, this, EKeys::LeftMouseButton).NativeReply;
 }
+
+/**
+ * @brief 处理鼠标进入事件
+ * 
+ * 提示框内容只来自文本缓存与背包维护的统计汇总，悬停不会遍历背包；
+ * 所有格子共享同一个 `SToolTip`，重复悬停时只比较指针。
+ * 
+ * @param InGeometry 物品 UI 的几何信息
+ * @param InMouseEvent 鼠标事件信息
+ */
+void UEveItemWidget::NativeOnMouseEnter(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent)
+{
+	Super::NativeOnMouseEnter(InGeometry, InMouseEvent);
+
+	if (ItemTID < 0 || !InventoryUI.IsValid()) return;
+
+	const TSharedPtr<IToolTip> ToolTip = InventoryUI->ShowItemToolTip(ItemTID, CfgIdx);
+	const TSharedPtr<SWidget> CachedWidget = GetCachedWidget();
+	if (ToolTip && CachedWidget && CachedWidget->GetToolTip() != ToolTip)
+	{
+		CachedWidget->SetToolTip(ToolTip);
+	}
+}
+
+/**
+ * @brief 显示格子中的物品
+ * 
+ * @param InTID 物品 TID
+ * @param InCfgIdx 物品配置索引
+ * @param IconBrush 预生成的图标画刷
+ */
+void UEveItemWidget::SetSlotItem(const int32 InTID, const int32 InCfgIdx, const FSlateBrush& IconBrush, const bool bForceRefresh)
+{
+	if (!ensure(Img)) return;
+
+	if (ItemTID != InTID || bForceRefresh)
+	{
+		ItemTID = InTID;
+		CfgIdx = InCfgIdx;
+		Img->SetBrush(IconBrush);
+		Invalidate(EInvalidateWidgetReason::Paint);
+	}
+
+	if (GetVisibility() != ESlateVisibility::Visible)
+	{
+		SetVisibility(ESlateVisibility::Visible);
+	}
+}
+
+/**
+ * @brief 设置格子的名称标签
+ */
+void UEveItemWidget::SetSlotLabel(const FText& Name, const float LabelWidth)
+{
+	if (!NameLabel) return;
+
+	if (!NameLabel->GetText().IdenticalTo(Name))
+	{
+		NameLabel->SetText(Name);
+	}
+
+	const float Scale = LabelMaxWidth > 0.f && LabelWidth > LabelMaxWidth ? LabelMaxWidth / LabelWidth : 1.f;
+	if (NameLabel->GetRenderTransform().Scale.X != Scale)
+	{
+		NameLabel->SetRenderScale(FVector2D(Scale, Scale));
+	}
+}
+
+/**
+ * @brief 获取名称标签实际使用的字体
+ */
+bool UEveItemWidget::GetLabelFont(FSlateFontInfo& OutFont) const
+{
+	if (!NameLabel) return false;
+
+	OutFont = NameLabel->GetFont();
+	return true;
+}
+
+/**
+ * @brief 清空格子
+ */
+void UEveItemWidget::ClearSlot()
+{
+	ItemTID = -1;
+	CfgIdx = INDEX_NONE;
+
+	if (GetVisibility() != ESlateVisibility::Hidden)
+	{
+		SetVisibility(ESlateVisibility::Hidden);
+	}
+}
+
+/**
+ * @brief 设置选中状态
+ * 
+ * 选中时为图片叠加高亮色，未选中时还原。
+ * 
+ * @param bInSelected 是否选中
+ */
+void UEveItemWidget::SetSelected(const bool bInSelected)
+{
+	if (bSelected == bInSelected) return;
+	bSelected = bInSelected;
+
+	if (!ensure(Img)) return;
+	Img->SetColorAndOpacity(bSelected ? SelectedTint : FLinearColor::White);
+}
+
+/**
+ * @brief 设置是否被筛选掉
+ * 
+ * 只修改渲染不透明度，不影响布局与命中测试。
+ * 
+ * @param bInFilteredOut 是否被筛选掉
+ */
+void UEveItemWidget::SetFilteredOut(const bool bInFilteredOut)
+{
+	if (bFilteredOut == bInFilteredOut) return;
+	bFilteredOut = bInFilteredOut;
+
+	SetRenderOpacity(bFilteredOut ? FilteredOutOpacity : 1.f);
+}
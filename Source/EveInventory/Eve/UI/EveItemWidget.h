@@ -15,8 +15,11 @@
  * - 监听物品拖拽事件
  * - 响应鼠标点击事件
  * - 处理物品在网格中的显示
+ * 
+ * 每个格子对应一个常驻的 `UEveItemWidget`，不参与原生 Tick，
+ * 只有在自身格子的增量到达时才更新内容并使自身失效重绘。
  */
-UCLASS()
+UCLASS(meta=(DisableNativeTick))
 class UEveItemWidget : public UUserWidget
 {
 	GENERATED_BODY()
@@ -62,6 +65,77 @@ public:
 	 */
 	virtual FReply NativeOnMouseButtonDown(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent) override;
 
+	/**
+	 * @brief 鼠标进入时调用
+	 * 
+	 * - 将共享提示框填充为当前物品的信息，并挂到自身（提示框在首次悬停时才创建）。
+	 * 
+	 * @param InGeometry 当前控件的几何信息
+	 * @param InMouseEvent 鼠标事件信息
+	 */
+	virtual void NativeOnMouseEnter(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent) override;
+
+public:
+	/**
+	 * @brief 设置选中状态
+	 * 
+	 * 由所属的 `UEveInventoryWidget` 在选择变化时调用，更新高亮显示。
+	 * 
+	 * @param bInSelected 是否选中
+	 */
+	void SetSelected(bool bInSelected);
+
+	/** @brief 是否被选中 */
+	bool IsSelected() const { return bSelected; }
+
+	/**
+	 * @brief 设置是否被筛选掉
+	 * 
+	 * 由所属的 `UEveInventoryWidget` 在筛选页签变化时调用，被筛选掉的物品按 `FilteredOutOpacity` 变暗。
+	 * 
+	 * @param bInFilteredOut 是否被筛选掉
+	 */
+	void SetFilteredOut(bool bInFilteredOut);
+
+	/**
+	 * @brief 显示格子中的物品
+	 * 
+	 * 物品未变化时直接返回；变化时只更新画刷并使自身重绘，不影响网格中的其他格子。
+	 * 
+	 * @param InTID 物品 TID
+	 * @param InCfgIdx 物品配置索引（`UEveInventoryMgr::FindCfgIdx` 的结果）
+	 * @param IconBrush 预生成的图标画刷
+	 * @param bForceRefresh 物品未变化时也重新设置画刷（图标资源或配置更新后使用）
+	 */
+	void SetSlotItem(int32 InTID, int32 InCfgIdx, const FSlateBrush& IconBrush, bool bForceRefresh = false);
+
+	/**
+	 * @brief 设置格子的名称标签
+	 * 
+	 * 文本相同时不做任何修改；名称宽度超出 `LabelMaxWidth` 时按比例缩小，宽度由文本缓存预先测量。
+	 * 
+	 * @param Name 物品名称（`UEveItemTextCache` 中共享的文本）
+	 * @param LabelWidth 预先测量的名称宽度
+	 */
+	void SetSlotLabel(const FText& Name, float LabelWidth);
+
+	/**
+	 * @brief 获取名称标签实际使用的字体
+	 * 
+	 * 文本缓存按该字体预先测量标签宽度，保证与 `LabelMaxWidth` 的比较使用同一套字体度量。
+	 * 
+	 * @param OutFont 标签字体
+	 * @return 是否绑定了名称标签
+	 */
+	bool GetLabelFont(FSlateFontInfo& OutFont) const;
+
+	/**
+	 * @brief 清空格子
+	 * 
+	 * 使用 `Hidden` 而不是 `Collapsed`，格子保留布局，网格无需重新排布。
+	 */
+	void ClearSlot();
+
 public:
 	/** 
 	 * @brief 物品是否正在被拖拽
@@ -87,6 +161,14 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "ItemWidget")
 	int32 ItemTID = -1;
 
+	/** 
+	 * @brief 物品配置索引
+	 * 
+	 * `CfgIdx` 缓存了 `ItemTID` 对应的稠密配置索引，拖拽等热路径直接数组访问配置。
+	 */
+	UPROPERTY(BlueprintReadOnly, Category = "ItemWidget")
+	int32 CfgIdx = INDEX_NONE;
+
 	/** 
 	 * @brief 物品所属的背包 UI 控件
 	 * 
@@ -103,34 +185,52 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "ItemWidget")
 	TWeakObjectPtr<class UUniformGridPanel> OwnerGrid;
 
-private:
 	/** 
-	 * @brief 物品在拖拽时的缩放比例
+	 * @brief 拖拽操作对象池
 	 * 
-	 * `ScaleSize` 控制拖拽时物品的大小。
+	 * 由 `UEveInventoryUI` 在创建格子时注入，拖拽开始时无需再查找子系统。
 	 */
-	const float ScaleSize = 2.0f;
+	TWeakObjectPtr<class UEveDragDropPool> DragDropPool;
 
 	/** 
-	 * @brief 网格的行数
+	 * @brief 背包 UI 子系统
 	 * 
-	 * `KNumRows` 用于定义网格的行数，决定物品槽的布局。
+	 * 由 `UEveInventoryUI` 在创建格子时注入，悬停时从中获取共享的提示框。
 	 */
-	const int32 KNumRows = 2;
+	TWeakObjectPtr<class UEveInventoryUI> InventoryUI;
 
 	/** 
-	 * @brief 网格的列数
+	 * @brief 选中时的高亮颜色
 	 * 
-	 * `KNumColumns` 用于定义网格的列数，决定物品槽的布局。
+	 * `SelectedTint` 在物品被选中时叠加到 `Img` 上。
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "ItemWidget")
+	FLinearColor SelectedTint = FLinearColor(0.5f, 0.8f, 1.f, 1.f);
+
+	/** 
+	 * @brief 被筛选掉时的不透明度
 	 */
-	const int32 KNumColumns = 3;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "ItemWidget")
+	float FilteredOutOpacity = 0.3f;
 
 	/** 
-	 * @brief 所有有效的物品位置索引
+	 * @brief 名称标签的最大宽度
 	 * 
-	 * `AllPosIdx` 定义了物品可能的有效位置，确保背包有足够的槽位。
+	 * 为 0 时不缩放标签。
 	 */
-	const TSet<int32> AllPosIdx{0, 1, 2, 3, 4, 5};
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "ItemWidget")
+	float LabelMaxWidth = 0.f;
+
+private:
+	/** 
+	 * @brief 物品是否被选中
+	 */
+	bool bSelected = false;
+
+	/** 
+	 * @brief 物品是否被筛选掉
+	 */
+	bool bFilteredOut = false;
 
 public:
 	/** 
@@ -140,4 +240,10 @@ public:
 	 */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(BindWidget))
 	TObjectPtr<class UImage> Img;
+
+	/** 
+	 * @brief 可选的物品名称标签
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(BindWidgetOptional))
+	TObjectPtr<class UTextBlock> NameLabel;
 };
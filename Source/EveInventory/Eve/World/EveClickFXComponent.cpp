@@ -0,0 +1,70 @@
+// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#include "EveClickFXComponent.h"
+
+#include "NiagaraComponent.h"
+#include "NiagaraFunctionLibrary.h"
+#include "NiagaraSystem.h"
+#include "EveInventory/EveInventory.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Click FX Spawns Avoided"), STAT_EveClickFXSpawnsAvoided, STATGROUP_EveInventory);
+
+UEveClickFXComponent::UEveClickFXComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UEveClickFXComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	for (UNiagaraComponent* FXComponent : Ring)
+	{
+		if (IsValid(FXComponent))
+		{
+			FXComponent->DestroyComponent();
+		}
+	}
+	Ring.Reset();
+	NextIdx = 0;
+
+	Super::EndPlay(EndPlayReason);
+}
+
+/**
+ * @brief 在指定位置播放点击特效
+ *
+ * 环形池未满时新建组件（不自动销毁），已满时复用最早播放的组件。
+ */
+void UEveClickFXComponent::PlayAt(const FVector& Location)
+{
+	if (!FXSystem) return;
+
+	const int32 Capacity = FMath::Max(1, PoolSize);
+	if (NextIdx >= Capacity) NextIdx = 0;
+
+	UNiagaraComponent* FXComponent = Ring.IsValidIndex(NextIdx) ? Ring[NextIdx].Get() : nullptr;
+	if (IsValid(FXComponent))
+	{
+		// 复用：移动到新位置并从头播放
+		FXComponent->SetWorldLocation(Location);
+		FXComponent->ResetSystem();
+
+		SpawnsAvoided++;
+		INC_DWORD_STAT(STAT_EveClickFXSpawnsAvoided);
+	}
+	else
+	{
+		FXComponent = UNiagaraFunctionLibrary::SpawnSystemAtLocation(this, FXSystem, Location, FRotator::ZeroRotator, FVector(1.f), false, true, ENCPoolMethod::None, true);
+		if (!FXComponent) return;
+
+		if (Ring.IsValidIndex(NextIdx))
+		{
+			Ring[NextIdx] = FXComponent;
+		}
+		else
+		{
+			Ring.Add(FXComponent);
+		}
+	}
+
+	NextIdx = (NextIdx + 1) % Capacity;
+}
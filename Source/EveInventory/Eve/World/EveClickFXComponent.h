@@ -0,0 +1,57 @@
+// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "EveClickFXComponent.generated.h"
+
+class UNiagaraComponent;
+class UNiagaraSystem;
+
+/**
+ * @brief 点击反馈特效组件
+ *
+ * 由玩家控制器持有，维护一个固定大小的 Niagara 组件环形池：
+ * - 前 `PoolSize` 次点击创建组件，之后轮流复用最早的组件（移动位置后重置播放）
+ * - 快速连点不再产生组件分配与初始化
+ */
+UCLASS(ClassGroup = (Eve), meta = (BlueprintSpawnableComponent))
+class UEveClickFXComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UEveClickFXComponent();
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/**
+	 * @brief 在指定位置播放点击特效
+	 *
+	 * @param Location 特效位置
+	 */
+	UFUNCTION(BlueprintCallable, Category = "FX")
+	void PlayAt(const FVector& Location);
+
+public:
+	/** 点击特效 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FX")
+	TObjectPtr<UNiagaraSystem> FXSystem;
+
+	/** 环形池大小（同时可见的点击特效数量） */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "FX", meta = (ClampMin = "1"))
+	int32 PoolSize = 4;
+
+	/** 通过复用避免的特效生成次数 */
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "FX")
+	int32 SpawnsAvoided = 0;
+
+private:
+	/** 环形池中的特效组件 */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UNiagaraComponent>> Ring;
+
+	/** 下一次使用的环形池下标 */
+	int32 NextIdx = 0;
+};
@@ -0,0 +1,381 @@
+// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#include "EveDroppedItemMgr.h"
+
+#include "EveLootSubsystem.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/GameInstance.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "EveInventory/EveInventory.h"
+#include "EveInventory/Eve/Asset/EveAssetMgr.h"
+#include "EveInventory/Eve/Data/EveItemDefinition.h"
+#include "EveInventory/Eve/Manager/EveInventoryMgr.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dropped Items"), STAT_EveDroppedItems, STATGROUP_EveInventory);
+
+static FAutoConsoleCommandWithWorldAndArgs GEveDropItemCmd(
+	TEXT("Eve.DropItem"),
+	TEXT("Drop a whole stack from the inventory in front of the player. Usage: Eve.DropItem <TID> [Distance=200]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (Args.Num() < 1 || !World) return;
+
+		const APlayerController* PlayerController = World->GetFirstPlayerController();
+		const APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+		UEveDroppedItemMgr* DroppedItemMgr = World->GetSubsystem<UEveDroppedItemMgr>();
+		UEveInventoryMgr* InventoryMgr = World->GetGameInstance() ? World->GetGameInstance()->GetSubsystem<UEveInventoryMgr>() : nullptr;
+		if (!Pawn || !DroppedItemMgr || !InventoryMgr) return;
+
+		const int32 TID = FCString::Atoi(*Args[0]);
+		if (!InventoryMgr->InventoryItems.Contains(TID))
+		{
+			UE_LOG(LogEveInventory, Warning, TEXT("Item %d is not in the inventory"), TID);
+			return;
+		}
+
+		const float Distance = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 200.f;
+		DroppedItemMgr->DropFromInventory(InventoryMgr, TID, Pawn->GetActorLocation() + Pawn->GetActorForwardVector() * Distance);
+	}));
+
+bool UEveDroppedItemMgr::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UEveDroppedItemMgr::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// 掉落物通过掉落物子系统参与自动拾取
+	LootSubsystem = Collection.InitializeDependency<UEveLootSubsystem>();
+	if (LootSubsystem)
+	{
+		LootSubsystem->OnLootCollected.AddUObject(this, &ThisClass::HandleLootCollected);
+	}
+}
+
+void UEveDroppedItemMgr::Deinitialize()
+{
+	if (LootSubsystem)
+	{
+		LootSubsystem->OnLootCollected.RemoveAll(this);
+		LootSubsystem = nullptr;
+	}
+
+	Proxies.Empty();
+	LootHandleToProxy.Empty();
+	Batches.Empty();
+	HostActor = nullptr;
+
+	Super::Deinitialize();
+}
+
+/**
+ * @brief 在场景中掉落一份物品
+ *
+ * 优先复用已隐藏的实例下标，没有时才追加新实例；模型未加载完成时只登记代理。
+ */
+int32 UEveDroppedItemMgr::DropItem(const FEveItemStack& Stack, const FVector& Location)
+{
+	if (!ensure(Stack.Amount > 0) || !LootSubsystem) return INDEX_NONE;
+
+	FEveDroppedItemBatch* Batch = FindOrAddBatch(Stack.TID);
+	if (!Batch) return INDEX_NONE;
+
+	const int32 ProxyIdx = AddProxy(*Batch, Stack, Location);
+	FlushPendingInstances(*Batch);
+
+	SET_DWORD_STAT(STAT_EveDroppedItems, Proxies.Num());
+	return ProxyIdx;
+}
+
+/**
+ * @brief 在一个范围内散落一组物品
+ *
+ * 每个批次的新实例在最后通过一次 `AddInstances` 添加。
+ */
+void UEveDroppedItemMgr::DropItems(const TConstArrayView<FEveItemStack> Stacks, const FVector& Center, const float ScatterRadius)
+{
+	if (!LootSubsystem) return;
+
+	Proxies.Reserve(Proxies.Num() + Stacks.Num());
+	LootHandleToProxy.Reserve(LootHandleToProxy.Num() + Stacks.Num());
+
+	TArray<int32, TInlineAllocator<8>> TouchedTIDs;
+	for (const FEveItemStack& Stack : Stacks)
+	{
+		if (!ensure(Stack.Amount > 0)) continue;
+
+		FEveDroppedItemBatch* Batch = FindOrAddBatch(Stack.TID);
+		if (!Batch) continue;
+
+		// 圆盘内均匀分布
+		const float Angle = FMath::FRandRange(0.f, UE_TWO_PI);
+		const float Dist = ScatterRadius * FMath::Sqrt(FMath::FRand());
+		AddProxy(*Batch, Stack, Center + FVector(FMath::Cos(Angle) * Dist, FMath::Sin(Angle) * Dist, 0.f));
+		TouchedTIDs.AddUnique(Stack.TID);
+	}
+
+	for (const int32 TID : TouchedTIDs)
+	{
+		FlushPendingInstances(Batches.FindChecked(TID));
+	}
+
+	SET_DWORD_STAT(STAT_EveDroppedItems, Proxies.Num());
+}
+
+/**
+ * @brief 登记一个掉落物代理
+ */
+int32 UEveDroppedItemMgr::AddProxy(FEveDroppedItemBatch& Batch, const FEveItemStack& Stack, const FVector& Location)
+{
+	FEveDroppedItemProxy Proxy;
+	Proxy.Stack = Stack;
+	Proxy.Location = Location;
+	Proxy.LootHandle = LootSubsystem->RegisterLoot(Location, Stack);
+
+	// 只有模型就绪后才会有被隐藏的实例
+	if (Batch.FreeInstances.Num() > 0)
+	{
+		Proxy.InstanceIdx = Batch.FreeInstances.Pop(EveNoShrink);
+		Batch.ISM->UpdateInstanceTransform(Proxy.InstanceIdx, FTransform(Location), true, true, true);
+	}
+
+	const int32 LootHandle = Proxy.LootHandle;
+	const bool bNeedsInstance = Proxy.InstanceIdx == INDEX_NONE;
+	const int32 ProxyIdx = Proxies.Add(MoveTemp(Proxy));
+	LootHandleToProxy.Add(LootHandle, ProxyIdx);
+
+	if (bNeedsInstance)
+	{
+		Batch.PendingProxies.Add(ProxyIdx);
+	}
+	return ProxyIdx;
+}
+
+/**
+ * @brief 为批次中所有待添加的代理一次性添加实例
+ */
+void UEveDroppedItemMgr::FlushPendingInstances(FEveDroppedItemBatch& Batch)
+{
+	if (!Batch.bMeshReady || Batch.PendingProxies.Num() == 0) return;
+
+	TArray<FTransform> Transforms;
+	Transforms.Reserve(Batch.PendingProxies.Num());
+	for (const int32 ProxyIdx : Batch.PendingProxies)
+	{
+		Transforms.Add(FTransform(Proxies[ProxyIdx].Location));
+	}
+
+	const TArray<int32> InstanceIdxes = Batch.ISM->AddInstances(Transforms, true, true);
+	for (int32 Idx = 0; Idx < InstanceIdxes.Num(); Idx++)
+	{
+		Proxies[Batch.PendingProxies[Idx]].InstanceIdx = InstanceIdxes[Idx];
+	}
+	Batch.PendingProxies.Reset();
+}
+
+/**
+ * @brief 将背包中的物品整堆丢到场景中
+ */
+bool UEveDroppedItemMgr::DropFromInventory(UEveInventoryMgr* Inventory, const int32 TID, const FVector& Location)
+{
+	if (!ensure(Inventory)) return false;
+
+	const TObjectPtr<UEveInventoryItem>* Item = Inventory->InventoryItems.Find(TID);
+	if (!ensure(Item && *Item)) return false;
+
+	const FEveItemStack Stack(TID, (*Item)->Amount);
+	if (DropItem(Stack, Location) == INDEX_NONE) return false;
+
+	Inventory->RemoveItem(TID);
+	return true;
+}
+
+/**
+ * @brief 移除一个掉落物（不进入背包）
+ */
+void UEveDroppedItemMgr::RemoveDroppedItem(const int32 ProxyIdx)
+{
+	if (!Proxies.IsValidIndex(ProxyIdx)) return;
+
+	if (LootSubsystem)
+	{
+		LootSubsystem->UnregisterLoot(Proxies[ProxyIdx].LootHandle);
+	}
+	ReleaseProxy(ProxyIdx);
+}
+
+/**
+ * @brief 掉落物被拾取后回收表现
+ */
+void UEveDroppedItemMgr::HandleLootCollected(const int32 LootHandle)
+{
+	if (const int32* ProxyIdx = LootHandleToProxy.Find(LootHandle))
+	{
+		ReleaseProxy(*ProxyIdx);
+	}
+}
+
+/**
+ * @brief 获取或创建 TID 对应的实例化批次
+ *
+ * 每个 TID 只在第一次掉落时创建组件并请求异步加载模型，不在游戏线程上同步加载。
+ * 找不到任何模型时也创建批次，与模型加载失败一样添加不可见的实例。
+ */
+FEveDroppedItemBatch* UEveDroppedItemMgr::FindOrAddBatch(const int32 TID)
+{
+	if (FEveDroppedItemBatch* Batch = Batches.Find(TID))
+	{
+		return Batch;
+	}
+
+	UWorld* World = GetWorld();
+	if (!World) return nullptr;
+
+	// 解析模型：有物品定义时异步加载其 `World` 资源包；
+	// 否则使用物品配置的 `WorldMesh`，再否则使用默认模型
+	UEveAssetMgr& AssetMgr = UEveAssetMgr::Get();
+	const bool bHasDefinition = AssetMgr.FindItemDefinitionId(TID).IsValid();
+
+	TSoftObjectPtr<UStaticMesh> Mesh;
+	const UEveInventoryMgr* InventoryMgr = World->GetGameInstance()->GetSubsystem<UEveInventoryMgr>();
+	if (!bHasDefinition && InventoryMgr)
+	{
+		if (const UEveItemCfg* ItemCfg = InventoryMgr->GetCfgByIdx(InventoryMgr->FindCfgIdx(TID)))
+		{
+			Mesh = ItemCfg->ItemData.WorldMesh;
+		}
+	}
+	if (Mesh.IsNull())
+	{
+		Mesh = AssetMgr.DroppedItemMesh;
+	}
+	if (Mesh.IsNull() && !bHasDefinition)
+	{
+		// 没有模型时仍然创建批次：实例不可见，但代理与实例下标照常登记，拾取不受影响
+		UE_LOG(LogEveInventory, Warning, TEXT("No world mesh for dropped item %d, instances will be invisible"), TID);
+	}
+
+	// 所有实例化组件挂在同一个不 Tick 的 Actor 上
+	if (!HostActor)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		HostActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+		if (!ensure(HostActor)) return nullptr;
+
+		HostActor->SetActorTickEnabled(false);
+		USceneComponent* Root = NewObject<USceneComponent>(HostActor, TEXT("Root"));
+		HostActor->SetRootComponent(Root);
+		Root->RegisterComponent();
+	}
+
+	UInstancedStaticMeshComponent* ISM = NewObject<UInstancedStaticMeshComponent>(HostActor);
+	ISM->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	ISM->SetGenerateOverlapEvents(false);
+	ISM->SetCanEverAffectNavigation(false);
+	ISM->SetupAttachment(HostActor->GetRootComponent());
+	ISM->RegisterComponent();
+	HostActor->AddInstanceComponent(ISM);
+
+	FEveDroppedItemBatch& Batch = Batches.Add(TID);
+	Batch.ISM = ISM;
+
+	// 回调可能在请求时同步执行，批次此时已登记，之后的掉落会直接添加实例
+	if (bHasDefinition)
+	{
+		AssetMgr.LoadItemBundles({ TID }, UEveAssetMgr::WorldBundle, FStreamableDelegate::CreateUObject(this, &ThisClass::OnItemWorldBundleLoaded, TID));
+	}
+	else
+	{
+		RequestBatchMesh(TID, Mesh);
+	}
+	return Batches.Find(TID);
+}
+
+/**
+ * @brief 异步加载批次的模型
+ */
+void UEveDroppedItemMgr::RequestBatchMesh(const int32 TID, const TSoftObjectPtr<UStaticMesh>& Mesh)
+{
+	if (Mesh.IsNull() || Mesh.Get())
+	{
+		OnBatchMeshLoaded(TID, Mesh);
+		return;
+	}
+
+	UEveAssetMgr::Get().GetStreamableManager().RequestAsyncLoad(Mesh.ToSoftObjectPath(),
+		FStreamableDelegate::CreateUObject(this, &ThisClass::OnBatchMeshLoaded, TID, Mesh));
+}
+
+/**
+ * @brief 批次的模型加载完成，添加等待中的实例
+ *
+ * 加载失败时仍然添加实例（不可见），保证代理与实例下标一致，拾取不受影响。
+ */
+void UEveDroppedItemMgr::OnBatchMeshLoaded(const int32 TID, const TSoftObjectPtr<UStaticMesh> Mesh)
+{
+	FEveDroppedItemBatch* Batch = Batches.Find(TID);
+	if (!Batch || !Batch->ISM || Batch->bMeshReady) return;
+
+	UStaticMesh* LoadedMesh = Mesh.Get();
+	if (!LoadedMesh && !Mesh.IsNull())
+	{
+		UE_LOG(LogEveInventory, Warning, TEXT("Failed to load world mesh for dropped item %d"), TID);
+	}
+
+	Batch->ISM->SetStaticMesh(LoadedMesh);
+	Batch->bMeshReady = true;
+	FlushPendingInstances(*Batch);
+}
+
+/**
+ * @brief 物品定义的 `World` 资源包加载完成，使用定义中的模型
+ *
+ * 定义没有模型时退回默认模型。
+ */
+void UEveDroppedItemMgr::OnItemWorldBundleLoaded(const int32 TID)
+{
+	const UEveItemDefinition* ItemDefinition = UEveAssetMgr::Get().GetItemDefinition(TID);
+	if (ItemDefinition && ItemDefinition->WorldMesh.Get())
+	{
+		OnBatchMeshLoaded(TID, ItemDefinition->WorldMesh);
+		return;
+	}
+
+	RequestBatchMesh(TID, UEveAssetMgr::Get().DroppedItemMesh);
+}
+
+/**
+ * @brief 隐藏实例并回收代理
+ *
+ * 实例不删除（删除会移动后续实例的下标），缩放置零后放入空闲列表等待复用。
+ */
+void UEveDroppedItemMgr::ReleaseProxy(const int32 ProxyIdx)
+{
+	const FEveDroppedItemProxy& Proxy = Proxies[ProxyIdx];
+
+	if (FEveDroppedItemBatch* Batch = Batches.Find(Proxy.Stack.TID))
+	{
+		if (Proxy.InstanceIdx == INDEX_NONE)
+		{
+			// 模型加载完成前被拾取，还没有实例
+			Batch->PendingProxies.RemoveSingleSwap(ProxyIdx, EveNoShrink);
+		}
+		else
+		{
+			const FTransform Hidden(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+			Batch->ISM->UpdateInstanceTransform(Proxy.InstanceIdx, Hidden, true, true, true);
+			Batch->FreeInstances.Add(Proxy.InstanceIdx);
+		}
+	}
+
+	LootHandleToProxy.Remove(Proxy.LootHandle);
+	Proxies.RemoveAt(ProxyIdx);
+
+	SET_DWORD_STAT(STAT_EveDroppedItems, Proxies.Num());
+}
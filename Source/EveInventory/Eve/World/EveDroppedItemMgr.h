@@ -0,0 +1,165 @@
+// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EveInventory/Eve/Data/EveItemData.h"
+#include "EveDroppedItemMgr.generated.h"
+
+class UEveInventoryMgr;
+class UEveLootSubsystem;
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+
+/**
+ * @brief 同一 TID 掉落物的实例化批次
+ */
+USTRUCT()
+struct FEveDroppedItemBatch
+{
+	GENERATED_BODY()
+
+public:
+	/** 该 TID 所有掉落物共用的实例化模型组件 */
+	UPROPERTY()
+	TObjectPtr<UInstancedStaticMeshComponent> ISM;
+
+	/** 已隐藏、可复用的实例下标 */
+	TArray<int32> FreeInstances;
+
+	/** 等待添加实例的掉落物代理下标（模型加载中，或等待本次掉落结束后批量添加） */
+	TArray<int32> PendingProxies;
+
+	/** 模型是否已加载完成（完成前掉落物只登记代理，不添加实例） */
+	bool bMeshReady = false;
+};
+
+/**
+ * @brief 掉落物代理
+ *
+ * 代替每个掉落物一个 Actor，只记录数据与实例下标，存放在稀疏数组中随用随回收。
+ */
+struct FEveDroppedItemProxy
+{
+	/** 掉落的物品堆叠 */
+	FEveItemStack Stack;
+
+	/** 掉落位置 */
+	FVector Location = FVector::ZeroVector;
+
+	/** 在对应批次中的实例下标，模型加载完成前为 `INDEX_NONE` */
+	int32 InstanceIdx = INDEX_NONE;
+
+	/** 在 `UEveLootSubsystem` 中的句柄 */
+	int32 LootHandle = INDEX_NONE;
+};
+
+/**
+ * @brief 掉落物管理器（UEveDroppedItemMgr）
+ *
+ * 负责将物品掉落到场景中：
+ * - 每个 TID 一个 `UInstancedStaticMeshComponent`，所有掉落物都是其中的一个实例，不生成 Actor
+ * - 模型异步加载，加载完成前掉落的物品在到达时一次性添加实例
+ * - 掉落物注册到 `UEveLootSubsystem` 参与自动拾取，被拾取后隐藏实例并回收代理与实例下标
+ * - 单个掉落物的开销只是一次实例添加 / 更新，空闲时不 Tick
+ */
+UCLASS()
+class UEveDroppedItemMgr : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+public:
+	/**
+	 * @brief 在场景中掉落一份物品
+	 *
+	 * @param Stack 掉落的物品堆叠
+	 * @param Location 掉落位置
+	 * @return 掉落物代理下标，失败时返回 `INDEX_NONE`
+	 */
+	int32 DropItem(const FEveItemStack& Stack, const FVector& Location);
+
+	/**
+	 * @brief 在一个范围内散落一组物品（如 Boss 掉落）
+	 *
+	 * @param Stacks 掉落的物品堆叠
+	 * @param Center 散落中心
+	 * @param ScatterRadius 散落半径
+	 */
+	void DropItems(TConstArrayView<FEveItemStack> Stacks, const FVector& Center, float ScatterRadius);
+
+	/**
+	 * @brief 将背包中的物品整堆丢到场景中（`Eve.DropItem` 控制台命令丢在玩家面前）
+	 *
+	 * @param Inventory 来源背包
+	 * @param TID 物品唯一 ID
+	 * @param Location 掉落位置
+	 * @return 是否丢弃成功
+	 */
+	bool DropFromInventory(UEveInventoryMgr* Inventory, int32 TID, const FVector& Location);
+
+	/**
+	 * @brief 移除一个掉落物（不进入背包）
+	 *
+	 * @param ProxyIdx 掉落物代理下标
+	 */
+	void RemoveDroppedItem(int32 ProxyIdx);
+
+	/** @brief 场景中的掉落物数量 */
+	int32 GetDroppedNum() const { return Proxies.Num(); }
+
+private:
+	/** @brief 掉落物被拾取后回收表现 */
+	void HandleLootCollected(int32 LootHandle);
+
+	/** @brief 获取或创建 TID 对应的实例化批次 */
+	FEveDroppedItemBatch* FindOrAddBatch(int32 TID);
+
+	/**
+	 * @brief 登记一个掉落物代理，有可复用的实例时直接复用，否则放入批次的待添加列表
+	 * 
+	 * @return 掉落物代理下标
+	 */
+	int32 AddProxy(FEveDroppedItemBatch& Batch, const FEveItemStack& Stack, const FVector& Location);
+
+	/** @brief 模型已就绪时，为批次中所有待添加的代理一次性添加实例 */
+	void FlushPendingInstances(FEveDroppedItemBatch& Batch);
+
+	/** @brief 异步加载批次的模型 */
+	void RequestBatchMesh(int32 TID, const TSoftObjectPtr<UStaticMesh>& Mesh);
+
+	/** @brief 批次的模型加载完成，添加等待中的实例 */
+	void OnBatchMeshLoaded(int32 TID, TSoftObjectPtr<UStaticMesh> Mesh);
+
+	/** @brief 物品定义的 `World` 资源包加载完成，使用定义中的模型 */
+	void OnItemWorldBundleLoaded(int32 TID);
+
+	/** @brief 隐藏实例并回收代理 */
+	void ReleaseProxy(int32 ProxyIdx);
+
+private:
+	/** 承载所有实例化组件的 Actor（不 Tick） */
+	UPROPERTY()
+	TObjectPtr<AActor> HostActor;
+
+	/** TID 到实例化批次的映射 */
+	UPROPERTY()
+	TMap<int32, FEveDroppedItemBatch> Batches;
+
+	/** 掉落物代理，下标即代理句柄，移除后的位置会被复用 */
+	TSparseArray<FEveDroppedItemProxy> Proxies;
+
+	/** 掉落物句柄到代理下标的映射 */
+	TMap<int32, int32> LootHandleToProxy;
+
+	/** 掉落物子系统 */
+	UPROPERTY()
+	TObjectPtr<UEveLootSubsystem> LootSubsystem;
+};
@@ -0,0 +1,54 @@
+// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#include "EveLootPickup.h"
+
+#include "EveLootSubsystem.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/World.h"
+
+AEveLootPickup::AEveLootPickup()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	// 拾取由子系统的空间索引判定，不需要碰撞和重叠事件
+	Mesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Mesh"));
+	Mesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Mesh->SetGenerateOverlapEvents(false);
+	Mesh->SetCanEverAffectNavigation(false);
+	RootComponent = Mesh;
+}
+
+void AEveLootPickup::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UEveLootSubsystem* LootSubsystem = GetWorld()->GetSubsystem<UEveLootSubsystem>())
+	{
+		LootHandle = LootSubsystem->RegisterLoot(GetActorLocation(), Stack, this);
+	}
+}
+
+void AEveLootPickup::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (LootHandle != INDEX_NONE)
+	{
+		if (UEveLootSubsystem* LootSubsystem = GetWorld()->GetSubsystem<UEveLootSubsystem>())
+		{
+			LootSubsystem->UnregisterLoot(LootHandle);
+		}
+		LootHandle = INDEX_NONE;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+/**
+ * @brief 被收入背包后调用
+ *
+ * 子系统已移除对应的条目，这里只清空句柄并销毁自身。
+ */
+void AEveLootPickup::OnCollected()
+{
+	LootHandle = INDEX_NONE;
+	Destroy();
+}
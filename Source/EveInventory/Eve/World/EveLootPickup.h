@@ -0,0 +1,45 @@
+// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "EveInventory/Eve/Data/EveItemData.h"
+#include "EveLootPickup.generated.h"
+
+class UStaticMeshComponent;
+
+/**
+ * @brief 场景中的掉落物
+ *
+ * 开始游戏时注册到 `UEveLootSubsystem`，由子系统统一做范围查询和自动拾取，
+ * 自身不 Tick、不参与碰撞。被拾取后销毁。
+ */
+UCLASS(Blueprintable)
+class AEveLootPickup : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AEveLootPickup();
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** @brief 被 `UEveLootSubsystem` 收入背包后调用 */
+	void OnCollected();
+
+public:
+	/** 掉落的物品堆叠 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory", meta = (ExposeOnSpawn = "true"))
+	FEveItemStack Stack = FEveItemStack(1, 1);
+
+private:
+	/** 掉落物外观 */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory", meta = (AllowPrivateAccess = "true"))
+	TObjectPtr<UStaticMeshComponent> Mesh;
+
+	/** 在 `UEveLootSubsystem` 中的句柄 */
+	int32 LootHandle = INDEX_NONE;
+};
@@ -0,0 +1,171 @@
+// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#include "EveLootSubsystem.h"
+
+#include "EveLootPickup.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "EveInventory/EveInventory.h"
+#include "EveInventory/Eve/Manager/EveInventoryMgr.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT(TEXT("Loot Collect"), STAT_EveLootCollect, STATGROUP_EveInventory);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Loot Entries"), STAT_EveLootEntries, STATGROUP_EveInventory);
+
+bool UEveLootSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UEveLootSubsystem::Deinitialize()
+{
+	Entries.Empty();
+	Cells.Empty();
+
+	Super::Deinitialize();
+}
+
+/**
+ * @brief 对本地玩家角色做一次自动拾取
+ */
+void UEveLootSubsystem::Tick(const float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SET_DWORD_STAT(STAT_EveLootEntries, Entries.Num());
+
+	const UWorld* World = GetWorld();
+	const APlayerController* PC = World ? World->GetFirstPlayerController() : nullptr;
+	const APawn* Pawn = PC ? PC->GetPawn() : nullptr;
+	if (!Pawn) return;
+
+	const UGameInstance* GameInstance = World->GetGameInstance();
+	UEveInventoryMgr* InventoryMgr = GameInstance ? GameInstance->GetSubsystem<UEveInventoryMgr>() : nullptr;
+	if (!InventoryMgr) return;
+
+	CollectInRadius(Pawn->GetActorLocation(), AutoLootRadius, InventoryMgr);
+}
+
+TStatId UEveLootSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEveLootSubsystem, STATGROUP_EveInventory);
+}
+
+/**
+ * @brief 注册一份掉落物
+ */
+int32 UEveLootSubsystem::RegisterLoot(const FVector& Location, const FEveItemStack& Stack, AEveLootPickup* Pickup)
+{
+	FEveLootEntry Entry;
+	Entry.Location = Location;
+	Entry.Stack = Stack;
+	Entry.Cell = GetCell(Location);
+	Entry.Pickup = Pickup;
+
+	const FIntPoint Cell = Entry.Cell;
+	const int32 Handle = Entries.Add(MoveTemp(Entry));
+	Cells.FindOrAdd(Cell).Add(Handle);
+	return Handle;
+}
+
+/**
+ * @brief 注销一份掉落物
+ */
+void UEveLootSubsystem::UnregisterLoot(const int32 Handle)
+{
+	if (!Entries.IsValidIndex(Handle)) return;
+
+	const FIntPoint Cell = Entries[Handle].Cell;
+	if (TArray<int32>* CellHandles = Cells.Find(Cell))
+	{
+		CellHandles->RemoveSingleSwap(Handle, EveNoShrink);
+		if (CellHandles->Num() == 0)
+		{
+			Cells.Remove(Cell);
+		}
+	}
+
+	Entries.RemoveAt(Handle);
+}
+
+/**
+ * @brief 查询范围内的掉落物
+ *
+ * 只遍历与查询圆的包围盒相交的网格单元。
+ */
+void UEveLootSubsystem::QueryInRadius(const FVector& Center, const float Radius, TArray<int32>& OutHandles) const
+{
+	const FIntPoint MinCell = GetCell(Center - FVector(Radius, Radius, 0.f));
+	const FIntPoint MaxCell = GetCell(Center + FVector(Radius, Radius, 0.f));
+	const float RadiusSq = Radius * Radius;
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			const TArray<int32>* CellHandles = Cells.Find(FIntPoint(X, Y));
+			if (!CellHandles) continue;
+
+			for (const int32 Handle : *CellHandles)
+			{
+				if (FVector::DistSquaredXY(Entries[Handle].Location, Center) <= RadiusSq)
+				{
+					OutHandles.Add(Handle);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * @brief 将范围内的掉落物批量收入背包
+ */
+int32 UEveLootSubsystem::CollectInRadius(const FVector& Center, const float Radius, UEveInventoryMgr* Inventory)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EveLootCollect);
+
+	if (!ensure(Inventory)) return 0;
+
+	ScratchHandles.Reset();
+	QueryInRadius(Center, Radius, ScratchHandles);
+	if (ScratchHandles.Num() == 0) return 0;
+
+	if (ScratchHandles.Num() > MaxCollectPerTick)
+	{
+		ScratchHandles.SetNum(MaxCollectPerTick, EveNoShrink);
+	}
+
+	ScratchStacks.Reset();
+	for (const int32 Handle : ScratchHandles)
+	{
+		ScratchStacks.Add(Entries[Handle].Stack);
+	}
+
+	// 整批添加，背包只广播一次
+	const int32 AddedNum = Inventory->AddItemStacks(ScratchStacks, &ScratchAdded);
+	if (AddedNum == 0) return 0;
+
+	for (int32 Idx = 0; Idx < ScratchHandles.Num(); Idx++)
+	{
+		if (!ScratchAdded[Idx]) continue;
+
+		const int32 Handle = ScratchHandles[Idx];
+		AEveLootPickup* Pickup = Entries[Handle].Pickup.Get();
+		UnregisterLoot(Handle);
+
+		if (Pickup)
+		{
+			Pickup->OnCollected();
+		}
+		OnLootCollected.Broadcast(Handle);
+	}
+
+	UE_LOG(LogEveInventory, Verbose, TEXT("Collected %d loot(s), %d remaining"), AddedNum, Entries.Num());
+	return AddedNum;
+}
+
+FIntPoint UEveLootSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
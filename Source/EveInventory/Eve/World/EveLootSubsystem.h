@@ -0,0 +1,130 @@
+// Copyright Night Gamer, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EveInventory/Eve/Data/EveItemData.h"
+#include "EveLootSubsystem.generated.h"
+
+class AEveLootPickup;
+class UEveInventoryMgr;
+
+/**
+ * @brief 场景中的一份掉落物
+ */
+struct FEveLootEntry
+{
+	/** 掉落物位置 */
+	FVector Location = FVector::ZeroVector;
+
+	/** 掉落的物品堆叠 */
+	FEveItemStack Stack;
+
+	/** 所在网格单元 */
+	FIntPoint Cell = FIntPoint::ZeroValue;
+
+	/** 对应的拾取物 Actor（可为空，纯数据掉落） */
+	TWeakObjectPtr<AEveLootPickup> Pickup;
+};
+
+/**
+ * @brief 掉落物子系统（UEveLootSubsystem）
+ *
+ * 以二维均匀网格（XY 平面）索引场景中的所有掉落物：
+ * - 范围查询只遍历与查询圆相交的网格单元，与场景掉落物总数无关
+ * - 每帧对本地玩家角色做一次自动拾取，范围内的物品合并为一次 `AddItemStacks`，背包只广播一次
+ * - 没有掉落物时不参与 Tick
+ */
+UCLASS()
+class UEveLootSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual bool IsTickable() const override { return Entries.Num() > 0; }
+
+	virtual TStatId GetStatId() const override;
+
+public:
+	/**
+	 * @brief 注册一份掉落物
+	 *
+	 * @param Location 掉落物位置
+	 * @param Stack 掉落的物品堆叠
+	 * @param Pickup 对应的拾取物 Actor，拾取后会被销毁；为空时通过 `OnLootCollected` 通知
+	 * @return 掉落物句柄
+	 */
+	int32 RegisterLoot(const FVector& Location, const FEveItemStack& Stack, AEveLootPickup* Pickup = nullptr);
+
+	/**
+	 * @brief 注销一份掉落物（不会销毁拾取物 Actor）
+	 *
+	 * @param Handle 掉落物句柄
+	 */
+	void UnregisterLoot(int32 Handle);
+
+	/**
+	 * @brief 查询范围内的掉落物
+	 *
+	 * @param Center 查询中心
+	 * @param Radius 查询半径（只比较 XY 平面距离）
+	 * @param OutHandles 范围内的掉落物句柄（追加写入）
+	 */
+	void QueryInRadius(const FVector& Center, float Radius, TArray<int32>& OutHandles) const;
+
+	/**
+	 * @brief 将范围内的掉落物批量收入背包
+	 *
+	 * 单次最多收取 `MaxCollectPerTick` 份，整批只触发一次背包更新；背包放不下的掉落物保留在场景中。
+	 *
+	 * @param Center 拾取中心
+	 * @param Radius 拾取半径
+	 * @param Inventory 目标背包
+	 * @return 收取的掉落物数量
+	 */
+	int32 CollectInRadius(const FVector& Center, float Radius, UEveInventoryMgr* Inventory);
+
+	/** @brief 场景中的掉落物数量 */
+	int32 GetLootNum() const { return Entries.Num(); }
+
+public:
+	/**
+	 * 掉落物被收入背包事件，参数为已注销的掉落物句柄。
+	 * 没有拾取物 Actor 的纯数据掉落（如 `UEveDroppedItemMgr` 的实例化掉落物）据此回收表现。
+	 */
+	DECLARE_MULTICAST_DELEGATE_OneParam(FEveOnLootCollected, int32 /* Handle */);
+	FEveOnLootCollected OnLootCollected;
+
+public:
+	/** 网格单元边长（厘米），取与拾取半径同一量级，查询通常只覆盖 2x2 ~ 3x3 个单元 */
+	float CellSize = 400.f;
+
+	/** 自动拾取半径（厘米） */
+	float AutoLootRadius = 200.f;
+
+	/** 单次最多收取的掉落物数量，掉落爆发时分摊到多帧 */
+	int32 MaxCollectPerTick = 64;
+
+private:
+	/** 位置所在的网格单元 */
+	FIntPoint GetCell(const FVector& Location) const;
+
+private:
+	/** 所有掉落物，句柄即稀疏数组下标 */
+	TSparseArray<FEveLootEntry> Entries;
+
+	/** 网格单元到掉落物句柄的映射 */
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	/** 收取时复用的临时数组 */
+	TArray<int32> ScratchHandles;
+	TArray<FEveItemStack> ScratchStacks;
+	TBitArray<> ScratchAdded;
+};
@@ -3,5 +3,15 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Misc/EngineVersionComparison.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogEveInventory, Log, All);
+
+/** 容器移除元素时不收缩内存（UE 5.4 起布尔参数的重载已弃用，改用 `EAllowShrinking`） */
+#if UE_VERSION_OLDER_THAN(5, 4, 0)
+inline constexpr bool EveNoShrink = false;
+#else
+inline constexpr EAllowShrinking EveNoShrink = EAllowShrinking::No;
+#endif
+
+DECLARE_STATS_GROUP(TEXT("EveInventory"), STATGROUP_EveInventory, STATCAT_Advanced);
@@ -10,6 +10,8 @@
 #include "GameFramework/SpringArmComponent.h"
 #include "Materials/Material.h"
 #include "Engine/World.h"
+#include "Engine/GameInstance.h"
+#include "Eve/Manager/EveEquipmentMgr.h"
 
 AEveInventoryCharacter::AEveInventoryCharacter()
 {
@@ -45,7 +47,51 @@ AEveInventoryCharacter::AEveInventoryCharacter()
 	PrimaryActorTick.bStartWithTickEnabled = true;
 }
 
+void AEveInventoryCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	BaseMaxWalkSpeed = GetCharacterMovement()->MaxWalkSpeed;
+	if (const UGameInstance* GameInstance = GetGameInstance())
+	{
+		EquipmentMgr = GameInstance->GetSubsystem<UEveEquipmentMgr>();
+	}
+
+	// Only react when the move speed channel is marked dirty instead of polling every frame
+	if (UEveEquipmentMgr* Equipment = EquipmentMgr.Get())
+	{
+		Equipment->OnStatsDirty.AddUObject(this, &AEveInventoryCharacter::HandleStatsDirty);
+		UpdateMaxWalkSpeed();
+	}
+}
+
+void AEveInventoryCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UEveEquipmentMgr* Equipment = EquipmentMgr.Get())
+	{
+		Equipment->OnStatsDirty.RemoveAll(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AEveInventoryCharacter::Tick(float DeltaSeconds)
 {
     Super::Tick(DeltaSeconds);
 }
+
+void AEveInventoryCharacter::HandleStatsDirty(uint32 ChannelMask)
+{
+	if (ChannelMask & (1u << static_cast<int32>(EEveStatChannel::MoveSpeed)))
+	{
+		UpdateMaxWalkSpeed();
+	}
+}
+
+void AEveInventoryCharacter::UpdateMaxWalkSpeed()
+{
+	if (UEveEquipmentMgr* Equipment = EquipmentMgr.Get())
+	{
+		GetCharacterMovement()->MaxWalkSpeed = BaseMaxWalkSpeed + Equipment->GetStat(EEveStatChannel::MoveSpeed);
+	}
+}
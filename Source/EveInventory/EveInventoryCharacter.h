@@ -17,6 +17,10 @@ public:
 	// Called every frame.
 	virtual void Tick(float DeltaSeconds) override;
 
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/** Returns TopDownCameraComponent subobject **/
 	FORCEINLINE class UCameraComponent* GetTopDownCameraComponent() const { return TopDownCameraComponent; }
 	/** Returns CameraBoom subobject **/
@@ -30,5 +34,17 @@ private:
 	/** Camera boom positioning the camera above the character */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	class USpringArmComponent* CameraBoom;
+
+	/** Equipment subsystem providing aggregated stats (cached on BeginPlay) */
+	TWeakObjectPtr<class UEveEquipmentMgr> EquipmentMgr;
+
+	/** Walk speed before equipment bonuses */
+	float BaseMaxWalkSpeed = 0.f;
+
+	/** Called when equipment stats are marked dirty, refreshes the walk speed if the move speed channel changed */
+	void HandleStatsDirty(uint32 ChannelMask);
+
+	/** Applies the current move speed bonus to the movement component */
+	void UpdateMaxWalkSpeed();
 };
 
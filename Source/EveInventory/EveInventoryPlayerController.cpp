@@ -4,11 +4,18 @@
 #include "GameFramework/Pawn.h"
 #include "Blueprint/AIBlueprintHelperLibrary.h"
 #include "NiagaraSystem.h"
-#include "NiagaraFunctionLibrary.h"
 #include "EveInventoryCharacter.h"
+#include "Engine/GameInstance.h"
 #include "Engine/World.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
+#include "EveInventory.h"
+#include "Eve/UI/EveInventoryUI.h"
+#include "Eve/World/EveClickFXComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Destination Trace"), STAT_EveDestinationTrace, STATGROUP_EveInventory);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Destination Traces"), STAT_EveDestinationTraces, STATGROUP_EveInventory);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Destination Traces Reused"), STAT_EveDestinationTracesReused, STATGROUP_EveInventory);
 
 AEveInventoryPlayerController::AEveInventoryPlayerController()
 {
@@ -16,6 +23,8 @@ AEveInventoryPlayerController::AEveInventoryPlayerController()
 	DefaultMouseCursor = EMouseCursor::Default;
 	CachedDestination = FVector::ZeroVector;
 	FollowTime = 0.f;
+
+	ClickFX = CreateDefaultSubobject<UEveClickFXComponent>(TEXT("ClickFX"));
 }
 
 void AEveInventoryPlayerController::BeginPlay()
@@ -23,6 +32,11 @@ void AEveInventoryPlayerController::BeginPlay()
 	// Call the base class  
 	Super::BeginPlay();
 
+	if (ClickFX && !ClickFX->FXSystem)
+	{
+		ClickFX->FXSystem = FXCursor;
+	}
+
 	//Add Input Mapping Context
 	if (UEnhancedInputLocalPlayerSubsystem* Subsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(GetLocalPlayer()))
 	{
@@ -49,6 +63,12 @@ void AEveInventoryPlayerController::SetupInputComponent()
 		EnhancedInputComponent->BindAction(SetDestinationTouchAction, ETriggerEvent::Triggered, this, &AEveInventoryPlayerController::OnTouchTriggered);
 		EnhancedInputComponent->BindAction(SetDestinationTouchAction, ETriggerEvent::Completed, this, &AEveInventoryPlayerController::OnTouchReleased);
 		EnhancedInputComponent->BindAction(SetDestinationTouchAction, ETriggerEvent::Canceled, this, &AEveInventoryPlayerController::OnTouchReleased);
+
+		// Setup inventory input events
+		if (ToggleInventoryAction)
+		{
+			EnhancedInputComponent->BindAction(ToggleInventoryAction, ETriggerEvent::Started, this, &AEveInventoryPlayerController::OnToggleInventory);
+		}
 	}
 }
 
@@ -64,24 +84,9 @@ void AEveInventoryPlayerController::OnSetDestinationTriggered()
 	FollowTime += GetWorld()->GetDeltaSeconds();
 	
 	// We look for the location in the world where the player has pressed the input
-	FHitResult Hit;
-	bool bHitSuccessful = false;
-	if (bIsTouch)
-	{
-		bHitSuccessful = GetHitResultUnderFinger(ETouchIndex::Touch1, ECollisionChannel::ECC_Visibility, true, Hit);
-	}
-	else
-	{
-		bHitSuccessful = GetHitResultUnderCursor(ECollisionChannel::ECC_Visibility, true, Hit);
-	}
-
-	// If we hit a surface, cache the location
-	if (bHitSuccessful)
-	{
-		CachedDestination = Hit.Location;
-	}
+	UpdateCachedDestination();
 	
-	// Move towards mouse pointer or touch
+	// Move towards mouse pointer or touch (movement input is consumed every tick, so it is still fed every frame)
 	APawn* ControlledPawn = GetPawn();
 	if (ControlledPawn != nullptr)
 	{
@@ -97,10 +102,65 @@ void AEveInventoryPlayerController::OnSetDestinationReleased()
 	{
 		// We move there and spawn some particles
 		UAIBlueprintHelperLibrary::SimpleMoveToLocation(this, CachedDestination);
-		UNiagaraFunctionLibrary::SpawnSystemAtLocation(this, FXCursor, CachedDestination, FRotator::ZeroRotator, FVector(1.f, 1.f, 1.f), true, true, ENCPoolMethod::None, true);
+		ClickFX->PlayAt(CachedDestination);
 	}
 
 	FollowTime = 0.f;
+	bHasDestinationTrace = false;
+}
+
+void AEveInventoryPlayerController::UpdateCachedDestination()
+{
+	SCOPE_CYCLE_COUNTER(STAT_EveDestinationTrace);
+
+	float ScreenX = 0.f;
+	float ScreenY = 0.f;
+	bool bHasScreenPos = false;
+	if (bIsTouch)
+	{
+		bool bIsPressed = false;
+		GetInputTouchState(ETouchIndex::Touch1, ScreenX, ScreenY, bIsPressed);
+		bHasScreenPos = bIsPressed;
+	}
+	else
+	{
+		bHasScreenPos = GetMousePosition(ScreenX, ScreenY);
+	}
+	if (!bHasScreenPos)
+	{
+		return;
+	}
+	const FVector2D ScreenPos(ScreenX, ScreenY);
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	const FVector CameraLocation = PlayerCameraManager ? PlayerCameraManager->GetCameraLocation() : FVector::ZeroVector;
+
+	// Reuse the last hit if the cursor and camera are (nearly) still, or if we traced too recently
+	if (bThrottleDestinationTrace && bHasDestinationTrace)
+	{
+		const bool bCursorStill = FVector2D::DistSquared(ScreenPos, LastDestinationTraceScreenPos) <= FMath::Square(CursorMoveThreshold)
+			&& CameraLocation.Equals(LastDestinationTraceCameraLocation, 1.f);
+		const bool bTooSoon = DestinationTraceRate > 0.f && Now - LastDestinationTraceTime < 1.f / DestinationTraceRate;
+		if (bCursorStill || bTooSoon)
+		{
+			INC_DWORD_STAT(STAT_EveDestinationTracesReused);
+			return;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_EveDestinationTraces);
+
+	// If we hit a surface, cache the location
+	FHitResult Hit;
+	if (GetHitResultAtScreenPosition(ScreenPos, ECollisionChannel::ECC_Visibility, bTraceComplexDestination, Hit))
+	{
+		CachedDestination = Hit.Location;
+	}
+
+	bHasDestinationTrace = true;
+	LastDestinationTraceTime = Now;
+	LastDestinationTraceScreenPos = ScreenPos;
+	LastDestinationTraceCameraLocation = CameraLocation;
 }
 
 // Triggered every frame when the input is held down
@@ -115,3 +175,12 @@ void AEveInventoryPlayerController::OnTouchReleased()
 	bIsTouch = false;
 	OnSetDestinationReleased();
 }
+
+void AEveInventoryPlayerController::OnToggleInventory()
+{
+	const UGameInstance* GameInstance = GetGameInstance();
+	if (UEveInventoryUI* InventoryUI = GameInstance ? GameInstance->GetSubsystem<UEveInventoryUI>() : nullptr)
+	{
+		InventoryUI->ToggleInventory();
+	}
+}
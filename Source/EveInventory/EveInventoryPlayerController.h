@@ -10,6 +10,7 @@
 
 /** Forward declaration to improve compiling times */
 class UNiagaraSystem;
+class UEveClickFXComponent;
 
 UCLASS()
 class AEveInventoryPlayerController : public APlayerController
@@ -27,6 +28,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input)
 	UNiagaraSystem* FXCursor;
 
+	/** Pooled click feedback; plays FXCursor from a small ring of reused Niagara components */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Input)
+	UEveClickFXComponent* ClickFX;
+
 	/** MappingContext */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Input, meta=(AllowPrivateAccess = "true"))
 	class UInputMappingContext* DefaultMappingContext;
@@ -39,6 +44,26 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Input, meta=(AllowPrivateAccess = "true"))
 	class UInputAction* SetDestinationTouchAction;
 
+	/** Open / close the inventory; the bag UI is prewarmed in the background until the first open */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Input, meta=(AllowPrivateAccess = "true"))
+	class UInputAction* ToggleInventoryAction;
+
+	/** Throttle the destination trace while the input is held, reusing the last hit in between */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Input)
+	bool bThrottleDestinationTrace = true;
+
+	/** Max destination traces per second while the input is held (0 = every frame) */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Input, meta=(ClampMin = "0.0", EditCondition = "bThrottleDestinationTrace"))
+	float DestinationTraceRate = 20.f;
+
+	/** Reuse the last hit while the cursor moved less than this many pixels and the camera did not move */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Input, meta=(ClampMin = "0.0", EditCondition = "bThrottleDestinationTrace"))
+	float CursorMoveThreshold = 2.f;
+
+	/** Trace against complex collision; simple collision is enough for picking a floor location */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Input)
+	bool bTraceComplexDestination = false;
+
 protected:
 	/** True if the controlled character should navigate to the mouse cursor. */
 	uint32 bMoveToMouseCursor : 1;
@@ -55,11 +80,22 @@ protected:
 	void OnTouchTriggered();
 	void OnTouchReleased();
 
+	/** Input handler for ToggleInventory action. */
+	void OnToggleInventory();
+
+	/** Trace under the cursor / finger and update CachedDestination, unless the last hit can be reused */
+	void UpdateCachedDestination();
+
 private:
 	FVector CachedDestination;
 
 	bool bIsTouch; // Is it a touch device
 	float FollowTime; // For how long it has been pressed
+
+	bool bHasDestinationTrace = false; // Whether the Last* values below are valid
+	float LastDestinationTraceTime = 0.f;
+	FVector2D LastDestinationTraceScreenPos = FVector2D::ZeroVector;
+	FVector LastDestinationTraceCameraLocation = FVector::ZeroVector;
 };
 
 